@@ -0,0 +1,11 @@
+#pragma once
+#include <stdint.h>
+
+// what to do with the items an output did not get yet, when it lags too far behind the newest item, eg. because it is slow or stalled
+// As long as an output holds on to items, they can't be removed from the shared buffer, so the other outputs may run out of room
+
+enum class lagPolicy : uint8_t {
+    hold,               // keep them, no matter how far the output lags. When the buffer is full, the overflowPolicy applies to all outputs
+    dropOldest,         // the output skips its oldest items, until it lags no more than its limit
+    skipToNewest        // the output skips all items it lags, and continues with the newest one
+};
@@ -0,0 +1,277 @@
+#pragma once
+#include <stdint.h>
+#include <string.h>
+#include <atomic>
+
+// Lock-free circular buffer of variable length records, for multiple producers (tasks, ISRs, threads calling log()) and a single consumer (output()).
+// Records are packed back to back, each one starting with a header word holding its length, so a short message only takes the bytes it needs.
+// Producers reserve bytes by incrementing tail, write the record and then publish it by setting the published flag in the header word.
+// The consumer only sees a record once it is published, so it never reads a half-written one. Consumed records are cleared, so free space never looks like a published header.
+// A record never wraps around the end of the buffer : when it does not fit, the remaining bytes are filled with a padding record.
+// Only one task at a time can be the consumer : it needs to acquire the consumer role first. This role is also used by a producer to discard the oldest record when the buffer is full.
+// The records, head and tail live in a logArenaRegion. That is a member of the logArena, or a memory region supplied by the application, eg. a memory mapped file or a section of RAM which is not cleared at reset.
+// In the latter case, the records of a previous run are recovered when the region is attached.
+
+template <uint32_t size>
+struct logArenaRegion {
+    static constexpr uint32_t alignment     = (sizeof(void*) > 4U) ? sizeof(void*) : 4U;        // records are aligned so their payload can hold pointers
+    static constexpr uint32_t magicValue    = 0x474F4C75U;                                      // "uLOG"
+    static constexpr uint32_t layoutVersion = 4U;                                               // to be incremented at any change of the layout of the region, the records or the items
+
+    uint32_t magic;                                                    // these 5 words tell if the region holds records from a previous run, with the same layout
+    uint32_t version;                                                  //
+    uint32_t regionSize;                                               //
+    uint32_t recordAlignment;                                          //
+    uint32_t checksum;                                                 //
+    std::atomic<uint32_t> head;                                        // read position in bytes, only modified by the consumer
+    std::atomic<uint32_t> tail;                                        // write position in bytes, producers reserve room by incrementing it
+    alignas(alignment) std::atomic<uint32_t> storage[size / 4U];        // the records. Typed as atomic words, as each of them can become a header word
+};
+
+template <uint32_t size, bool inlineRegion>
+class logArenaStorage {        // a logArena with its own region
+  protected:
+    logArenaRegion<size>* initialRegion() {
+        return &ownRegion;
+    }
+    logArenaRegion<size> ownRegion;
+};
+
+template <uint32_t size>
+class logArenaStorage<size, false> {        // a logArena without region until one is attached, so it takes no RAM for it
+  protected:
+    logArenaRegion<size>* initialRegion() {
+        return nullptr;
+    }
+};
+
+template <uint32_t size, bool inlineRegion = true>
+class logArena : private logArenaStorage<size, inlineRegion> {
+  public:
+    static constexpr uint32_t alignment  = logArenaRegion<size>::alignment;        //
+    static constexpr uint32_t headerSize = alignment;                              // header word, padded to alignment
+    static_assert((size > 0) && ((size & (size - 1)) == 0), "size of logArena must be a power of 2");
+    static_assert((size % alignment) == 0, "size of logArena must be a multiple of its alignment");
+
+    logArena() : theRegion(this->initialRegion()) {
+        if (theRegion != nullptr) {
+            initialize();
+        }
+    }
+
+    bool attach(void* memory, uint32_t memoryLength) {        // moves to a region supplied by the application, which must be at least sizeof(logArenaRegion<size>). Returns true when it holds records of a previous run, which are then kept. Not thread safe : to be done before logging
+        if ((memory == nullptr) || (memoryLength < sizeof(logArenaRegion<size>)) || ((reinterpret_cast<uintptr_t>(memory) % alignof(logArenaRegion<size>)) != 0)) {
+            return false;
+        }
+        logArenaRegion<size>* previousRegion = theRegion;
+        theRegion                            = static_cast<logArenaRegion<size>*>(memory);
+        bool recovered                       = isValid() && recover();
+        if (!recovered) {
+            initialize();
+        }
+        if ((previousRegion != nullptr) && (previousRegion != theRegion)) {
+            moveRecords(*previousRegion);        // records written before attaching come after the recovered ones
+        }
+        return recovered;
+    }
+    bool isAttached() const {
+        return (theRegion != nullptr);
+    }
+
+    static constexpr uint32_t recordLength(uint32_t payloadLength) {        // total number of bytes a record takes for a given payload
+        return (headerSize + payloadLength + alignment - 1U) & ~(alignment - 1U);
+    }
+
+    // ------------------------------
+    // producer side
+    // ------------------------------
+    bool reserve(uint32_t payloadLength, uint32_t& position) {        // reserves room for a new record, returns false when the buffer is full
+        if (!inlineRegion && (theRegion == nullptr)) {
+            return false;
+        }
+        uint32_t length = recordLength(payloadLength);
+        uint32_t start  = tail().load(std::memory_order_relaxed);
+        uint32_t padding;
+        do {
+            uint32_t offset = start % size;
+            padding         = ((offset + length) > size) ? (size - offset) : 0U;        // record must not wrap, so skip the bytes up to the end
+            if (((start + padding + length) - head().load(std::memory_order_acquire)) > size) {
+                return false;
+            }
+        } while (!tail().compare_exchange_weak(start, start + padding + length, std::memory_order_relaxed));        // on failure, compare_exchange_weak has reloaded start
+
+        if (padding > 0) {
+            header(start).store(padding | paddingFlag | publishedFlag, std::memory_order_release);
+        }
+        position = start + padding;
+        header(position).store(length, std::memory_order_relaxed);        // length, but not yet published
+        return true;
+    }
+    void publish(uint32_t position) {        // makes the record at position visible to the consumer
+        header(position).fetch_or(publishedFlag);
+    }
+    uint8_t* payload(uint32_t position) {
+        return reinterpret_cast<uint8_t*>(theRegion->storage) + (position % size) + headerSize;
+    }
+    uint32_t payloadLength(uint32_t position) {        // room for payload of the record at position, which can be more than what was reserved, as records are aligned
+        return (header(position).load(std::memory_order_relaxed) & lengthMask) - headerSize;
+    }
+
+    // ------------------------------
+    // consumer side
+    // ------------------------------
+    bool acquireConsumer() {        // try to become the one and only consumer, does not block
+        return !consuming.exchange(true);
+    }
+    void releaseConsumer() {
+        consuming.store(false);
+    }
+    bool peek(uint32_t& position) {        // position of the oldest record, returns false if there is none or it is not yet published
+        if (!inlineRegion && (theRegion == nullptr)) {
+            return false;
+        }
+        while (true) {
+            position           = head().load(std::memory_order_relaxed);
+            uint32_t theHeader = header(position).load();
+            if ((theHeader & publishedFlag) == 0) {
+                return false;
+            }
+            if ((theHeader & paddingFlag) == 0) {
+                return true;
+            }
+            pop();        // padding is consumed right away
+        }
+    }
+    bool next(uint32_t& position) {        // moves position to the record after it, returns false if there is none or it is not yet published. Padding is skipped, but not consumed
+        position += header(position).load(std::memory_order_relaxed) & lengthMask;
+        return seek(position);
+    }
+    bool seek(uint32_t& position) {        // moves position, a record boundary between head and tail, over padding. Returns false if there is no record there or it is not yet published, position then being where the next one will be
+        while (position != tail().load(std::memory_order_acquire)) {        // when the buffer is full, the word at tail is the header of the oldest record, so we must stop there
+            uint32_t theHeader = header(position).load();
+            if ((theHeader & publishedFlag) == 0) {
+                return false;
+            }
+            if ((theHeader & paddingFlag) == 0) {
+                return true;
+            }
+            position += theHeader & lengthMask;
+        }
+        return false;
+    }
+    void pop() {        // frees the oldest record, so producers can reuse its bytes
+        uint32_t position = head().load(std::memory_order_relaxed);
+        uint32_t length   = header(position).load(std::memory_order_relaxed) & lengthMask;
+        memset(reinterpret_cast<uint8_t*>(theRegion->storage) + (position % size), 0, length);
+        head().store(position + length, std::memory_order_release);
+    }
+    void popUntil(uint32_t position) {        // frees all records before position, a boundary of a published record, or tail
+        while (head().load(std::memory_order_relaxed) != position) {
+            pop();
+        }
+    }
+    void skip(uint32_t position) {        // turns a record into padding, so the consumer skips it
+        header(position).fetch_or(paddingFlag | publishedFlag);
+    }
+
+    uint32_t level() const {        // number of bytes in use, including records not yet published
+        if (!inlineRegion && (theRegion == nullptr)) {
+            return 0;
+        }
+        return theRegion->tail.load(std::memory_order_relaxed) - theRegion->head.load(std::memory_order_relaxed);
+    }
+    uint32_t readPosition() const {        // position of the oldest record, or of the next one when empty
+        return (!inlineRegion && (theRegion == nullptr)) ? 0U : theRegion->head.load(std::memory_order_relaxed);
+    }
+    uint32_t writePosition() const {        // position where the next record will be reserved
+        return (!inlineRegion && (theRegion == nullptr)) ? 0U : theRegion->tail.load(std::memory_order_acquire);
+    }
+
+#ifndef unitTest
+  private:
+#endif
+    static constexpr uint32_t publishedFlag = 0x80000000U;
+    static constexpr uint32_t paddingFlag   = 0x40000000U;
+    static constexpr uint32_t lengthMask    = 0x3FFFFFFFU;
+
+    std::atomic<uint32_t>& header(uint32_t position) {
+        return *reinterpret_cast<std::atomic<uint32_t>*>(reinterpret_cast<uint8_t*>(theRegion->storage) + (position % size));
+    }
+    std::atomic<uint32_t>& head() {
+        return theRegion->head;
+    }
+    std::atomic<uint32_t>& tail() {
+        return theRegion->tail;
+    }
+
+    uint32_t checksum() const {        // of the words describing the layout
+        uint32_t result{2166136261U};        // FNV-1a, one word at a time
+        const uint32_t words[4] = {theRegion->magic, theRegion->version, theRegion->regionSize, theRegion->recordAlignment};
+        for (uint32_t index = 0; index < 4; index++) {
+            result = (result ^ words[index]) * 16777619U;
+        }
+        return result;
+    }
+    void initialize() {        // empty region
+        memset(static_cast<void*>(theRegion), 0, sizeof(logArenaRegion<size>));
+        theRegion->magic           = logArenaRegion<size>::magicValue;
+        theRegion->version         = logArenaRegion<size>::layoutVersion;
+        theRegion->regionSize      = size;
+        theRegion->recordAlignment = alignment;
+        theRegion->checksum        = checksum();
+    }
+    bool isValid() const {        // does the region hold records with the same layout
+        return (theRegion->magic == logArenaRegion<size>::magicValue) && (theRegion->version == logArenaRegion<size>::layoutVersion) && (theRegion->regionSize == size) && (theRegion->recordAlignment == alignment) && (theRegion->checksum == checksum());
+    }
+    bool recover() {        // after a reset : checks the records of the previous run, returns false when they can't be used
+        uint32_t start = head().load();
+        uint32_t end   = tail().load();
+        if (((end - start) > size) || ((start % alignment) != 0) || ((end % alignment) != 0)) {
+            return false;
+        }
+        uint32_t position = start;
+        while (position != end) {
+            uint32_t theHeader = header(position).load();
+            uint32_t length    = theHeader & lengthMask;
+            if ((length < headerSize) || ((length % alignment) != 0) || (((position % size) + length) > size) || ((position + length - start) > (end - start))) {
+                end = position;        // not a valid record, eg. reserved but its header not yet written at the reset : the rest is lost
+                break;
+            }
+            if ((theHeader & publishedFlag) == 0) {
+                skip(position);        // reserved but not completely written at the reset
+            }
+            position += length;
+        }
+        uint32_t freeStart  = end % size;        // free space must be zero, so it never looks like a published header
+        uint32_t freeLength = size - (end - start);
+        uint32_t firstPart  = ((freeStart + freeLength) > size) ? (size - freeStart) : freeLength;
+        memset(reinterpret_cast<uint8_t*>(theRegion->storage) + freeStart, 0, firstPart);
+        memset(reinterpret_cast<uint8_t*>(theRegion->storage), 0, freeLength - firstPart);
+        tail().store(end);
+        return true;
+    }
+
+    void moveRecords(logArenaRegion<size>& source) {        // appends the published records of another region, as far as they fit
+        uint32_t position = source.head.load();
+        while (position != source.tail.load()) {
+            uint8_t* record    = reinterpret_cast<uint8_t*>(source.storage) + (position % size);
+            uint32_t theHeader = reinterpret_cast<std::atomic<uint32_t>*>(record)->load();
+            uint32_t length    = theHeader & lengthMask;
+            if (length == 0) {
+                return;        // reserved, but its header not yet written
+            }
+            if ((theHeader & (publishedFlag | paddingFlag)) == publishedFlag) {
+                uint32_t newPosition;
+                if (!reserve(length - headerSize, newPosition)) {
+                    return;
+                }
+                memcpy(payload(newPosition), record + headerSize, length - headerSize);
+                publish(newPosition);
+            }
+            position += length;
+        }
+    }
+
+    logArenaRegion<size>* theRegion;          // the records, head and tail
+    std::atomic<bool> consuming{false};        // set while some task has the consumer role
+};
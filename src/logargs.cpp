@@ -0,0 +1,195 @@
+#include <string.h>        // required for memcpy(), strchr()
+#include <math.h>          // required for isfinite(), fabs()
+#include "logargs.h"
+#include "logconvert.h"
+
+uint32_t logArgs::packValue(char* buffer, uint32_t bufferLength, logArgType theType, const void* value, uint32_t valueLength) {
+    if ((valueLength + 1U) > bufferLength) {
+        return 0;
+    }
+    if (buffer != nullptr) {
+        buffer[0] = static_cast<char>(theType);
+        memcpy(buffer + 1, value, valueLength);        // memcpy as buffer has no alignment
+    }
+    return valueLength + 1U;
+}
+
+uint32_t logArgs::packSigned(char* buffer, uint32_t bufferLength, int64_t value) {
+    if ((value >= INT32_MIN) && (value <= INT32_MAX)) {        // most values fit in 32 bits, so we don't waste space on 64 bits
+        int32_t shortValue = static_cast<int32_t>(value);
+        return packValue(buffer, bufferLength, logArgType::int32, &shortValue, sizeof(shortValue));
+    }
+    return packValue(buffer, bufferLength, logArgType::int64, &value, sizeof(value));
+}
+
+uint32_t logArgs::packUnsigned(char* buffer, uint32_t bufferLength, uint64_t value) {
+    if (value <= UINT32_MAX) {
+        uint32_t shortValue = static_cast<uint32_t>(value);
+        return packValue(buffer, bufferLength, logArgType::uint32, &shortValue, sizeof(shortValue));
+    }
+    return packValue(buffer, bufferLength, logArgType::uint64, &value, sizeof(value));
+}
+
+uint32_t logArgs::packOne(char* buffer, uint32_t bufferLength, bool value) { return packSigned(buffer, bufferLength, value); }
+uint32_t logArgs::packOne(char* buffer, uint32_t bufferLength, char value) { return packSigned(buffer, bufferLength, value); }
+uint32_t logArgs::packOne(char* buffer, uint32_t bufferLength, signed char value) { return packSigned(buffer, bufferLength, value); }
+uint32_t logArgs::packOne(char* buffer, uint32_t bufferLength, unsigned char value) { return packUnsigned(buffer, bufferLength, value); }
+uint32_t logArgs::packOne(char* buffer, uint32_t bufferLength, short value) { return packSigned(buffer, bufferLength, value); }
+uint32_t logArgs::packOne(char* buffer, uint32_t bufferLength, unsigned short value) { return packUnsigned(buffer, bufferLength, value); }
+uint32_t logArgs::packOne(char* buffer, uint32_t bufferLength, int value) { return packSigned(buffer, bufferLength, value); }
+uint32_t logArgs::packOne(char* buffer, uint32_t bufferLength, unsigned int value) { return packUnsigned(buffer, bufferLength, value); }
+uint32_t logArgs::packOne(char* buffer, uint32_t bufferLength, long value) { return packSigned(buffer, bufferLength, value); }
+uint32_t logArgs::packOne(char* buffer, uint32_t bufferLength, unsigned long value) { return packUnsigned(buffer, bufferLength, value); }
+uint32_t logArgs::packOne(char* buffer, uint32_t bufferLength, long long value) { return packSigned(buffer, bufferLength, value); }
+uint32_t logArgs::packOne(char* buffer, uint32_t bufferLength, unsigned long long value) { return packUnsigned(buffer, bufferLength, value); }
+uint32_t logArgs::packOne(char* buffer, uint32_t bufferLength, float value) { return packOne(buffer, bufferLength, static_cast<double>(value)); }
+uint32_t logArgs::packOne(char* buffer, uint32_t bufferLength, double value) { return packValue(buffer, bufferLength, logArgType::float64, &value, sizeof(value)); }
+
+uint32_t logArgs::packOne(char* buffer, uint32_t bufferLength, const void* value) {
+    uint64_t address = reinterpret_cast<uintptr_t>(value);
+    return packValue(buffer, bufferLength, logArgType::pointer, &address, sizeof(address));
+}
+
+uint32_t logArgs::packOne(char* buffer, uint32_t bufferLength, const char* value) {
+    if (value == nullptr) {
+        value = "(null)";
+    }
+    if (bufferLength < 2U) {        // need room for the type and at least the terminating zero
+        return 0;
+    }
+    uint32_t valueLength = strnlen(value, bufferLength - 2U);        // if the string is too long, it is truncated to the space left
+    if (buffer != nullptr) {
+        buffer[0] = static_cast<char>(logArgType::string);
+        memcpy(buffer + 1, value, valueLength);
+        buffer[valueLength + 1U] = 0;
+    }
+    return valueLength + 2U;
+}
+
+uint32_t logArgs::render(char* destination, uint32_t destinationLength, const char* format, const char* args, uint32_t argsLength) {
+    if (destinationLength == 0) {
+        return 0;
+    }
+    uint32_t written{0};
+    uint32_t argsIndex{0};
+    while ((*format != 0) && ((written + 1U) < destinationLength)) {
+        if (*format != '%') {        // plain text is copied as is, up to the next conversion
+            const char* nextConversion = strchr(format, '%');
+            uint32_t textLength        = (nextConversion != nullptr) ? static_cast<uint32_t>(nextConversion - format) : static_cast<uint32_t>(strlen(format));
+            uint32_t room              = destinationLength - (written + 1U);
+            if (textLength > room) {
+                textLength = room;
+            }
+            memcpy(destination + written, format, textLength);
+            written += textLength;
+            format += textLength;
+            continue;
+        }
+        if (format[1] == '%') {
+            destination[written++] = '%';
+            format += 2;
+            continue;
+        }
+
+        logConversion theConversion;
+        format = logConvert::parse(format + 1, theConversion);
+        if (theConversion.conversion == 0) {
+            break;
+        }
+        if (argsIndex >= argsLength) {        // this argument did not fit in the item when logging, so we leave it out
+            continue;
+        }
+
+        // read back the stored argument
+        logArgValue value;
+        uint32_t used = unpack(args + argsIndex, argsLength - argsIndex, value);
+        if (used == 0) {
+            argsIndex = argsLength;        // corrupt arguments : stop rendering them
+            continue;
+        }
+        argsIndex += used;
+        written += logConvert::format(destination + written, destinationLength - written, theConversion, value);        // converting the value if its type does not match the conversion
+    }
+    destination[written] = 0;
+    return written;
+}
+
+uint32_t logArgs::fittingLength(const char* args, uint32_t argsLength, uint32_t maxLength) {
+    uint32_t length{0};
+    while (length < argsLength) {
+        logArgValue value;
+        uint32_t argLength = unpack(args + length, argsLength - length, value);
+        if ((argLength == 0) || ((length + argLength) > maxLength)) {
+            break;
+        }
+        length += argLength;
+    }
+    return length;
+}
+
+uint32_t logArgs::unpack(const char* args, uint32_t argsLength, logArgValue& value) {
+    if (argsLength == 0) {
+        return 0;
+    }
+    value.type          = static_cast<logArgType>(args[0]);
+    value.signedValue   = 0;
+    value.unsignedValue = 0;
+    value.floatValue    = 0.0;
+    value.stringValue   = "";
+    uint32_t length{1};
+    switch (value.type) {
+        case logArgType::int32:
+        case logArgType::uint32:
+            length += sizeof(uint32_t);
+            break;
+        case logArgType::int64:
+        case logArgType::uint64:
+        case logArgType::float64:
+        case logArgType::pointer:
+            length += sizeof(uint64_t);
+            break;
+        case logArgType::string:
+            length += strnlen(args + 1, argsLength - 1U) + 1U;
+            break;
+        default:
+            return 0;        // corrupt arguments
+    }
+    if (length > argsLength) {
+        return 0;
+    }
+    switch (value.type) {
+        case logArgType::int32: {
+            int32_t shortValue;
+            memcpy(&shortValue, args + 1, sizeof(shortValue));        // memcpy as args has no alignment
+            value.signedValue = shortValue;
+        } break;
+        case logArgType::uint32: {
+            uint32_t shortValue;
+            memcpy(&shortValue, args + 1, sizeof(shortValue));
+            value.signedValue = shortValue;
+        } break;
+        case logArgType::int64:
+            memcpy(&value.signedValue, args + 1, sizeof(value.signedValue));
+            break;
+        case logArgType::uint64:
+        case logArgType::pointer:
+            memcpy(&value.unsignedValue, args + 1, sizeof(value.unsignedValue));
+            value.signedValue = static_cast<int64_t>(value.unsignedValue);
+            break;
+        case logArgType::float64:
+            memcpy(&value.floatValue, args + 1, sizeof(value.floatValue));
+            value.signedValue = (isfinite(value.floatValue) && (fabs(value.floatValue) < maxIntegralFloat)) ? static_cast<int64_t>(value.floatValue) : 0;        // converting nan, inf or a value out of range is undefined
+            break;
+        case logArgType::string:
+        default:
+            value.stringValue = args + 1;
+            break;
+    }
+    if ((value.type != logArgType::uint64) && (value.type != logArgType::pointer)) {
+        value.unsignedValue = static_cast<uint64_t>(value.signedValue);
+    }
+    if ((value.type != logArgType::float64) && (value.type != logArgType::string)) {
+        value.floatValue = static_cast<double>(value.signedValue);
+    }
+    return length;
+}
@@ -0,0 +1,91 @@
+#pragma once
+#include <stdint.h>
+
+// Packs the arguments of a printf() style log call as raw bytes, each preceded by a type tag, so the formatting can be done later, at output time.
+// The format string itself is not copied : only its pointer is stored, as it is a literal living in flash / rodata.
+// String arguments are copied, as they may live in a buffer on the caller's stack.
+
+enum class logArgType : uint8_t {
+    int32,
+    uint32,
+    int64,
+    uint64,
+    float64,
+    pointer,
+    string
+};
+
+struct logArgValue {        // one packed argument, read back
+    logArgType type;
+    int64_t signedValue;           // the value converted to each type, so it can be formatted with any conversion
+    uint64_t unsignedValue;        //
+    double floatValue;             //
+    const char* stringValue;       // only for strings, otherwise ""
+};
+
+template <typename valueType>
+struct logField;        // a key / value field of a structured item, see logfields.h
+
+class logArgs {
+  public:
+    template <typename... argTypes>
+    static uint32_t pack(char* buffer, uint32_t bufferLength, argTypes... args) {        // packs all args into buffer, returns the number of bytes used. Args not fitting in the buffer are dropped
+        return packNext(buffer, bufferLength, args...);
+    }
+    template <typename... argTypes>
+    static uint32_t packedLength(argTypes... args) {        // number of bytes pack() needs to store all args
+        return packNext(nullptr, UINT32_MAX, args...);
+    }
+    static uint32_t render(char* destination, uint32_t destinationLength, const char* format, const char* args, uint32_t argsLength);        // printf() style formatting of format with packed args into destination, returns the length of the result
+    static uint32_t fittingLength(const char* args, uint32_t argsLength, uint32_t maxLength);                                               // number of bytes taken by the packed args which completely fit in maxLength bytes
+    static uint32_t unpack(const char* args, uint32_t argsLength, logArgValue& value);                                                      // reads back the first of the packed args, returns the number of bytes it takes, 0 when they are corrupt or end before it
+    static constexpr double maxIntegralFloat{9.2e18};                                                                                      // a float read back is converted to an integer only below this, so it fits an int64_t. nan, inf and larger values become 0
+
+#ifndef unitTest
+  private:
+#endif
+    static uint32_t packNext(char*, uint32_t) {        // end of recursion, no more arguments
+        return 0;
+    }
+    template <typename firstType, typename... argTypes>
+    static uint32_t packNext(char* buffer, uint32_t bufferLength, firstType first, argTypes... args) {
+        uint32_t used = packOne(buffer, bufferLength, first);
+        if (used == 0) {
+            return 0;        // this arg does not fit, so neither do the ones after it
+        }
+        return used + packNext((buffer != nullptr) ? (buffer + used) : nullptr, bufferLength - used, args...);        // a nullptr buffer only measures the length
+    }
+
+    // one overload per supported type : passing an unsupported type, such as a class or scoped enum, does not compile
+    static uint32_t packOne(char* buffer, uint32_t bufferLength, bool value);
+    static uint32_t packOne(char* buffer, uint32_t bufferLength, char value);
+    static uint32_t packOne(char* buffer, uint32_t bufferLength, signed char value);
+    static uint32_t packOne(char* buffer, uint32_t bufferLength, unsigned char value);
+    static uint32_t packOne(char* buffer, uint32_t bufferLength, short value);
+    static uint32_t packOne(char* buffer, uint32_t bufferLength, unsigned short value);
+    static uint32_t packOne(char* buffer, uint32_t bufferLength, int value);
+    static uint32_t packOne(char* buffer, uint32_t bufferLength, unsigned int value);
+    static uint32_t packOne(char* buffer, uint32_t bufferLength, long value);
+    static uint32_t packOne(char* buffer, uint32_t bufferLength, unsigned long value);
+    static uint32_t packOne(char* buffer, uint32_t bufferLength, long long value);
+    static uint32_t packOne(char* buffer, uint32_t bufferLength, unsigned long long value);
+    static uint32_t packOne(char* buffer, uint32_t bufferLength, float value);
+    static uint32_t packOne(char* buffer, uint32_t bufferLength, double value);
+    static uint32_t packOne(char* buffer, uint32_t bufferLength, const char* value);
+    static uint32_t packOne(char* buffer, uint32_t bufferLength, const void* value);
+    template <typename valueType>
+    static uint32_t packOne(char* buffer, uint32_t bufferLength, const logField<valueType>& field) {        // key and value, or nothing when they don't both fit, so a key is never left without its value
+        uint32_t keyLength   = packOne(nullptr, UINT32_MAX, field.key);
+        uint32_t valueLength = packOne(nullptr, UINT32_MAX, field.value);
+        if ((keyLength + valueLength) > bufferLength) {
+            return 0;
+        }
+        packOne(buffer, keyLength, field.key);
+        packOne((buffer != nullptr) ? (buffer + keyLength) : nullptr, valueLength, field.value);
+        return keyLength + valueLength;
+    }
+
+    static uint32_t packValue(char* buffer, uint32_t bufferLength, logArgType theType, const void* value, uint32_t valueLength);        // writes type tag + raw bytes, returns 0 when it does not fit
+    static uint32_t packSigned(char* buffer, uint32_t bufferLength, int64_t value);
+    static uint32_t packUnsigned(char* buffer, uint32_t bufferLength, uint64_t value);
+};
@@ -0,0 +1,68 @@
+#include "logbinary.h"
+
+uint32_t logBinary::formatId(const char* format) {
+    uint32_t result{2166136261U};        // FNV-1a
+    while (*format != 0) {
+        result = (result ^ static_cast<uint8_t>(*format++)) * 16777619U;
+    }
+    return result;
+}
+
+uint32_t logBinary::putVarint(uint8_t* destination, uint64_t value) {
+    uint32_t length{0};
+    while (value >= 0x80U) {
+        destination[length++] = static_cast<uint8_t>(value | 0x80U);
+        value >>= 7;
+    }
+    destination[length++] = static_cast<uint8_t>(value);
+    return length;
+}
+
+uint32_t logBinary::getVarint(const uint8_t* source, uint32_t sourceLength, uint64_t& value) {
+    value = 0;
+    for (uint32_t index = 0; (index < sourceLength) && (index < maxVarintLength); index++) {
+        value |= static_cast<uint64_t>(source[index] & 0x7FU) << (7U * index);
+        if ((source[index] & 0x80U) == 0) {
+            return index + 1U;
+        }
+    }
+    return 0;
+}
+
+uint32_t logBinary::encode(const uint8_t* source, uint32_t sourceLength, uint8_t* destination) {
+    uint32_t codeIndex{0};        // where the code of the current block goes : the distance to the next zero
+    uint32_t length{1};
+    uint8_t code{1};
+    for (uint32_t index = 0; index < sourceLength; index++) {
+        if (source[index] != 0) {
+            destination[length++] = source[index];
+            code++;
+        }
+        if ((source[index] == 0) || (code == 0xFFU)) {        // a zero, or a block of 254 non-zero bytes, ends the block
+            destination[codeIndex] = code;
+            codeIndex              = length++;
+            code                   = 1;
+        }
+    }
+    destination[codeIndex] = code;
+    destination[length++]  = 0;        // delimiter
+    return length;
+}
+
+uint32_t logBinary::decode(const uint8_t* source, uint32_t sourceLength, uint8_t* destination) {
+    uint32_t length{0};
+    uint32_t index{0};
+    while (index < sourceLength) {
+        uint8_t code = source[index++];
+        if ((code == 0) || ((index + code - 1U) > sourceLength)) {
+            return 0;
+        }
+        for (uint32_t blockIndex = 1; blockIndex < code; blockIndex++) {
+            destination[length++] = source[index++];
+        }
+        if ((code != 0xFFU) && (index < sourceLength)) {
+            destination[length++] = 0;        // a block shorter than 254 bytes was ended by a zero, except the last one
+        }
+    }
+    return length;
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include <stdint.h>
+
+// Binary wire format, for outputs set with setBinaryOutput(). Much shorter than text lines, and cheaper to produce, as nothing is formatted on the target : a deferred item only takes its format ID and its raw arguments.
+// Each item is one frame, COBS encoded so it holds no zero bytes, followed by a zero byte as delimiter. After losing bytes, a receiver resynchronizes at the next zero.
+// Frame contents, before encoding :
+// * flags : recordType in bits 0-1, timestampType in bits 2-3
+// * timestamp : the tick as varint, or the text as varint length followed by its chars, or nothing
+// * loggingLevel in bits 0-2 and subSystem in bits 3-7 of one byte. A subSystem from subSystemEscape on is stored as subSystemEscape, followed by the subSystem as varint
+// * text item : the text, without terminating zero
+// * deferred item : the format ID as varint, followed by the packed arguments, see logargs.h. They are little-endian, as on all supported targets
+// * structured item : the packed message, followed by the packed key / value fields, see logfields.h
+// The format ID is the FNV-1a hash of the format string, so the target needs no table : tools/ulog-decode finds the format strings by hashing the string literals of the sources.
+// Varints are LEB128 : 7 bits per byte, least significant first, bit 7 set when more bytes follow.
+
+class logBinary {
+  public:
+    enum class recordType : uint8_t {
+        text       = 0,
+        deferred   = 1,
+        structured = 2
+    };
+    enum class timestampType : uint8_t {
+        none = 0,
+        tick = 1,
+        text = 2
+    };
+    static constexpr uint32_t maxVarintLength{10U};        // bytes needed for a 64 bit value
+    static constexpr uint32_t subSystemEscape{31U};        // largest subSystem stored in the level byte
+    static constexpr uint32_t maxHeaderLength{1U + maxVarintLength + 1U + 5U + 5U};        // flags, tick, level byte, escaped subSystem and format ID
+
+    static constexpr uint32_t encodedLength(uint32_t length) {        // worst case length of a frame after encoding, including the delimiter
+        return length + (length / 254U) + 2U;
+    }
+
+    static uint32_t formatId(const char* format);                                                    // ID of a format string
+    static uint32_t putVarint(uint8_t* destination, uint64_t value);                                 // returns the number of bytes written, at most maxVarintLength
+    static uint32_t getVarint(const uint8_t* source, uint32_t sourceLength, uint64_t& value);        // returns the number of bytes read, 0 when source ends before the varint
+    static uint32_t encode(const uint8_t* source, uint32_t sourceLength, uint8_t* destination);      // COBS encodes a frame and appends the delimiter. destination needs room for encodedLength(sourceLength) bytes. Returns the length, including the delimiter
+    static uint32_t decode(const uint8_t* source, uint32_t sourceLength, uint8_t* destination);      // decodes a frame received without its delimiter. destination needs room for sourceLength bytes. Returns the length, 0 when the frame is invalid
+};
@@ -0,0 +1,24 @@
+#include "logclock.h"
+
+#if defined(ESP32)        // before ARDUINO, which Arduino-ESP32 defines as well
+#include <esp_timer.h>
+
+uint32_t logMicroseconds() {
+    return static_cast<uint32_t>(esp_timer_get_time());
+}
+
+#elif defined(ARDUINO)
+#include <Arduino.h>
+
+uint32_t logMicroseconds() {
+    return micros();
+}
+
+#else
+#include <chrono>
+
+uint32_t logMicroseconds() {
+    return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+#endif
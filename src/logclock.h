@@ -0,0 +1,4 @@
+#pragma once
+#include <stdint.h>
+
+uint32_t logMicroseconds();        // free running microsecond clock, wrapping around every 71 minutes. Used for rate limits and metrics, not for timestamps
@@ -0,0 +1,427 @@
+#include <string.h>        // required for memcpy(), memchr(), memmove()
+#include <math.h>          // required for isnan(), isinf(), signbit(), log10(), pow()
+#include "logconvert.h"
+#ifndef LOGGING_NO_PRINTF
+#include <stdio.h>        // required for snprintf()
+#endif
+
+namespace {
+
+const char digitPairs[] =        // "00" to "99", so two digits take one division
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+const char lowerHexDigits[] = "0123456789abcdef";
+const char upperHexDigits[] = "0123456789ABCDEF";
+
+const uint32_t powersOfTen[logConvert::maxFixedPrecision + 1] = {1U, 10U, 100U, 1000U, 10000U, 100000U, 1000000U, 10000000U, 100000000U, 1000000000U};
+
+uint32_t append(char* destination, uint32_t written, uint32_t limit, const char* text, uint32_t textLength) {        // returns the new written, never beyond limit
+    uint32_t room = limit - written;
+    if (textLength > room) {
+        textLength = room;
+    }
+    for (uint32_t index = 0; index < textLength; index++) {        // mostly a few chars, so a loop is faster than calling memcpy()
+        destination[written + index] = text[index];
+    }
+    return written + textLength;
+}
+
+uint32_t appendRepeated(char* destination, uint32_t written, uint32_t limit, char aChar, uint32_t count) {
+    uint32_t room = limit - written;
+    if (count > room) {
+        count = room;
+    }
+    for (uint32_t index = 0; index < count; index++) {
+        destination[written + index] = aChar;
+    }
+    return written + count;
+}
+
+}        // namespace
+
+const char* logConvert::parse(const char* format, logConversion& theConversion) {
+    theConversion = logConversion();
+    for (;; format++) {
+        char aChar = *format;
+        if (aChar == '-') {
+            theConversion.leftAlign = true;
+        } else if (aChar == '+') {
+            theConversion.showSign = true;
+        } else if (aChar == ' ') {
+            theConversion.spaceSign = true;
+        } else if (aChar == '#') {
+            theConversion.alternate = true;
+        } else if (aChar == '0') {
+            theConversion.zeroPad = true;
+        } else {
+            break;
+        }
+    }
+    while ((*format >= '0') && (*format <= '9')) {
+        if (theConversion.width < 1000U) {        // wider makes no sense in a line of maxItemLength
+            theConversion.width = (theConversion.width * 10U) + static_cast<uint32_t>(*format - '0');
+        }
+        format++;
+    }
+    if (*format == '.') {
+        format++;
+        theConversion.precision = 0;
+        while ((*format >= '0') && (*format <= '9')) {
+            if (theConversion.precision < 1000) {
+                theConversion.precision = (theConversion.precision * 10) + (*format - '0');
+            }
+            format++;
+        }
+    }
+    while ((*format == 'l') || (*format == 'h') || (*format == 'z') || (*format == 'j') || (*format == 't') || (*format == 'L')) {        // the value carries its own type
+        format++;
+    }
+    theConversion.conversion = *format;
+    if (*format != 0) {
+        format++;
+    }
+    return format;
+}
+
+uint32_t logConvert::decimal(char* destination, uint64_t value) {
+    char digits[maxDigits];
+    uint32_t length = decimalBackwards(digits + maxDigits, value);
+    memcpy(destination, digits + maxDigits - length, length);
+    return length;
+}
+
+uint32_t logConvert::hex(char* destination, uint64_t value, bool upperCase) {
+    char digits[maxDigits];
+    uint32_t length = hexBackwards(digits + maxDigits, value, upperCase);
+    memcpy(destination, digits + maxDigits - length, length);
+    return length;
+}
+
+uint32_t logConvert::octal(char* destination, uint64_t value) {
+    char digits[maxDigits];
+    uint32_t length = octalBackwards(digits + maxDigits, value);
+    memcpy(destination, digits + maxDigits - length, length);
+    return length;
+}
+
+uint32_t logConvert::decimalBackwards(char* end, uint64_t value) {
+    char* start = end;
+    while (value > UINT32_MAX) {        // 64 bit divisions only while needed, they are slow on 32 bit targets
+        uint32_t pair = static_cast<uint32_t>(value % 100U);
+        value /= 100U;
+        *--start = digitPairs[(2U * pair) + 1U];
+        *--start = digitPairs[2U * pair];
+    }
+    uint32_t shortValue = static_cast<uint32_t>(value);
+    while (shortValue >= 100U) {
+        uint32_t pair = shortValue % 100U;
+        shortValue /= 100U;
+        *--start = digitPairs[(2U * pair) + 1U];
+        *--start = digitPairs[2U * pair];
+    }
+    if (shortValue >= 10U) {
+        *--start = digitPairs[(2U * shortValue) + 1U];
+        *--start = digitPairs[2U * shortValue];
+    } else {
+        *--start = static_cast<char>('0' + shortValue);
+    }
+    return static_cast<uint32_t>(end - start);
+}
+
+uint32_t logConvert::hexBackwards(char* end, uint64_t value, bool upperCase) {
+    const char* hexDigits = upperCase ? upperHexDigits : lowerHexDigits;
+    char* start           = end;
+    do {
+        *--start = hexDigits[value & 0x0FU];
+        value >>= 4;
+    } while (value != 0);
+    return static_cast<uint32_t>(end - start);
+}
+
+uint32_t logConvert::octalBackwards(char* end, uint64_t value) {
+    char* start = end;
+    do {
+        *--start = static_cast<char>('0' + (value & 0x07U));
+        value >>= 3;
+    } while (value != 0);
+    return static_cast<uint32_t>(end - start);
+}
+
+uint32_t logConvert::fixed(char* destination, double value, int32_t precision, bool alternate) {
+    uint64_t integerPart = static_cast<uint64_t>(value);
+    uint32_t scale       = powersOfTen[precision];
+    uint32_t fraction    = static_cast<uint32_t>(((value - static_cast<double>(integerPart)) * scale) + 0.5);
+    if (fraction >= scale) {        // rounded up to the next integer, eg. 9.996 with precision 2
+        fraction -= scale;
+        integerPart++;
+    }
+    uint32_t length = decimal(destination, integerPart);
+    if ((precision > 0) || alternate) {
+        destination[length++] = '.';
+    }
+    for (int32_t index = precision - 1; index >= 0; index--) {        // fraction with its leading zeroes
+        destination[length + static_cast<uint32_t>(index)] = static_cast<char>('0' + (fraction % 10U));
+        fraction /= 10U;
+    }
+    return length + static_cast<uint32_t>(precision);
+}
+
+int32_t logConvert::decimalExponent(double value, int32_t precision) {
+    if (value == 0.0) {
+        return 0;
+    }
+    int32_t exponent = static_cast<int32_t>(floor(log10(value)));
+    double mantissa  = scaleDown(value, exponent);
+    if (mantissa < 1.0) {        // log10() is not exact
+        exponent--;
+    } else if (mantissa >= 10.0) {
+        exponent++;
+    }
+    if ((scaleDown(value, exponent) + (0.5 / powersOfTen[precision])) >= 10.0) {        // rounds up to 10, eg. 9.9996 with precision 3
+        exponent++;
+    }
+    return exponent;
+}
+
+double logConvert::scaleDown(double value, int32_t exponent) {
+    if (exponent < -300) {        // 10^exponent would be a denormal or 0
+        return (value * 1e300) / pow(10.0, exponent + 300);
+    }
+    return value / pow(10.0, exponent);
+}
+
+uint32_t logConvert::scientific(char* destination, double value, int32_t precision, bool alternate, bool upperCase) {
+    if (precision > maxFixedPrecision) {
+        precision = maxFixedPrecision;
+    }
+    int32_t exponent = decimalExponent(value, precision);
+    uint32_t length  = fixed(destination, scaleDown(value, exponent), precision, alternate);
+    destination[length++] = upperCase ? 'E' : 'e';
+    destination[length++] = (exponent < 0) ? '-' : '+';
+    uint32_t magnitude    = static_cast<uint32_t>((exponent < 0) ? -exponent : exponent);
+    if (magnitude < 10U) {
+        destination[length++] = '0';        // at least two digits, as printf()
+    }
+    return length + decimal(destination + length, magnitude);
+}
+
+uint32_t logConvert::general(char* destination, double value, int32_t precision, bool alternate, bool upperCase) {
+    int32_t significant = (precision < 0) ? 6 : ((precision == 0) ? 1 : precision);
+    if (significant > (maxFixedPrecision + 1)) {
+        significant = maxFixedPrecision + 1;
+    }
+    int32_t exponent = decimalExponent(value, significant - 1);
+    uint32_t length;
+    uint32_t mantissaLength;
+    if ((exponent < -4) || (exponent >= significant)) {
+        length         = scientific(destination, value, significant - 1, alternate, upperCase);
+        mantissaLength = length - ((((exponent < 0) ? -exponent : exponent) < 100) ? 4U : 5U);        // e, sign and 2 or 3 digits
+    } else {
+        int32_t decimals = significant - 1 - exponent;
+        length           = fixed(destination, value, (decimals < maxFixedPrecision) ? decimals : maxFixedPrecision, alternate);
+        mantissaLength   = length;
+    }
+    if (alternate || (memchr(destination, '.', mantissaLength) == nullptr)) {
+        return length;
+    }
+    uint32_t trimmed = mantissaLength;        // without # : no trailing zeroes, nor a trailing decimal point
+    while (destination[trimmed - 1U] == '0') {
+        trimmed--;
+    }
+    if (destination[trimmed - 1U] == '.') {
+        trimmed--;
+    }
+    memmove(destination + trimmed, destination + mantissaLength, length - mantissaLength);
+    return length - (mantissaLength - trimmed);
+}
+
+#ifndef LOGGING_NO_PRINTF
+uint32_t logConvert::fallback(char* destination, uint32_t destinationLength, const logConversion& theConversion, double value) {
+    char specification[32];        // rebuilt from the parsed conversion
+    uint32_t length{0};
+    specification[length++] = '%';
+    if (theConversion.leftAlign) {
+        specification[length++] = '-';
+    }
+    if (theConversion.showSign) {
+        specification[length++] = '+';
+    }
+    if (theConversion.spaceSign) {
+        specification[length++] = ' ';
+    }
+    if (theConversion.alternate) {
+        specification[length++] = '#';
+    }
+    if (theConversion.zeroPad) {
+        specification[length++] = '0';
+    }
+    if (theConversion.width > 0) {
+        length += decimal(specification + length, theConversion.width);
+    }
+    if (theConversion.precision >= 0) {
+        specification[length++] = '.';
+        length += decimal(specification + length, static_cast<uint32_t>(theConversion.precision));
+    }
+    specification[length++] = theConversion.conversion;
+    specification[length]   = 0;
+    int result              = snprintf(destination, destinationLength, specification, value);
+    if (result <= 0) {
+        destination[0] = 0;
+        return 0;
+    }
+    return (static_cast<uint32_t>(result) < destinationLength) ? static_cast<uint32_t>(result) : (destinationLength - 1U);
+}
+#endif
+
+uint32_t logConvert::format(char* destination, uint32_t destinationLength, const logConversion& theConversion, const logArgValue& value) {
+    if (destinationLength == 0) {
+        return 0;
+    }
+    char digits[maxDigits + maxFixedPrecision + 2U];        // the converted value, without sign, prefix and padding
+    char* digitsEnd = digits + sizeof(digits);              // integers are converted backwards, ending here
+    const char* body{digits};                               //
+    uint32_t bodyLength{0};                                 //
+    char sign{0};                                           // '-', '+', ' ' or none
+    const char* prefix{""};                                 // 0x for hex
+    uint32_t prefixLength{0};                               //
+    uint32_t zeroes{0};                                     // between prefix and body, for the precision of integers
+    bool numeric{true};                                     // zeroPad applies
+
+    switch (theConversion.conversion) {
+        case 'd':
+        case 'i':
+        case 'u':
+        case 'o':
+        case 'x':
+        case 'X': {
+            uint64_t magnitude = (value.type == logArgType::int32) ? static_cast<uint32_t>(value.signedValue) : value.unsignedValue;        // as printf(), a negative int is converted to an unsigned int, not to 64 bits
+            if ((theConversion.conversion == 'd') || (theConversion.conversion == 'i')) {
+                if (value.signedValue < 0) {
+                    sign      = '-';
+                    magnitude = 0U - static_cast<uint64_t>(value.signedValue);
+                } else {
+                    sign      = theConversion.showSign ? '+' : (theConversion.spaceSign ? ' ' : 0);
+                    magnitude = static_cast<uint64_t>(value.signedValue);
+                }
+            }
+            if ((magnitude == 0) && (theConversion.precision == 0)) {
+                bodyLength = 0;        // C : precision 0 of value 0 gives no digits
+            } else if (theConversion.conversion == 'o') {
+                bodyLength = octalBackwards(digitsEnd, magnitude);
+            } else if ((theConversion.conversion == 'x') || (theConversion.conversion == 'X')) {
+                bodyLength = hexBackwards(digitsEnd, magnitude, (theConversion.conversion == 'X'));
+                if (theConversion.alternate && (magnitude != 0)) {
+                    prefix       = (theConversion.conversion == 'X') ? "0X" : "0x";
+                    prefixLength = 2U;
+                }
+            } else {
+                bodyLength = decimalBackwards(digitsEnd, magnitude);
+            }
+            body = digitsEnd - bodyLength;
+            if ((theConversion.precision >= 0) && (static_cast<uint32_t>(theConversion.precision) > bodyLength)) {
+                zeroes = static_cast<uint32_t>(theConversion.precision) - bodyLength;
+            }
+            if ((theConversion.conversion == 'o') && theConversion.alternate && (zeroes == 0) && ((bodyLength == 0) || (body[0] != '0'))) {
+                zeroes = 1;        // # : octal starts with a 0
+            }
+            if (theConversion.precision >= 0) {
+                numeric = false;        // C : zeroPad is ignored when a precision is given
+            }
+        } break;
+        case 'c':
+            digits[0]  = static_cast<char>(value.signedValue);
+            bodyLength = 1;
+            numeric    = false;
+            break;
+        case 's':
+            body       = value.stringValue;
+            bodyLength = (theConversion.precision >= 0) ? static_cast<uint32_t>(strnlen(body, static_cast<uint32_t>(theConversion.precision))) : static_cast<uint32_t>(strlen(body));
+            numeric    = false;
+            break;
+        case 'p':
+            prefix       = "0x";
+            prefixLength = 2U;
+            bodyLength   = hexBackwards(digitsEnd, value.unsignedValue, false);
+            body         = digitsEnd - bodyLength;
+            numeric      = false;
+            break;
+        case 'f':
+        case 'F':
+        case 'e':
+        case 'E':
+        case 'g':
+        case 'G':
+        case 'a':
+        case 'A': {
+            double number     = value.floatValue;
+            int32_t precision = (theConversion.precision >= 0) ? theConversion.precision : 6;
+            bool upperCase    = (theConversion.conversion >= 'A') && (theConversion.conversion <= 'Z');
+            if (isnan(number)) {
+                memcpy(digits, upperCase ? "NAN" : "nan", 3);
+                bodyLength = 3;
+                numeric    = false;
+                break;
+            }
+            if (signbit(number)) {
+                sign   = '-';
+                number = -number;
+            } else {
+                sign = theConversion.showSign ? '+' : (theConversion.spaceSign ? ' ' : 0);
+            }
+            if (isinf(number)) {
+                memcpy(digits, upperCase ? "INF" : "inf", 3);
+                bodyLength = 3;
+                numeric    = false;
+            } else if (((theConversion.conversion == 'f') || (theConversion.conversion == 'F')) && (precision <= maxFixedPrecision) && (number < maxFixedValue)) {
+                bodyLength = fixed(digits, number, precision, theConversion.alternate);
+            } else {
+#ifdef LOGGING_NO_PRINTF
+                if ((theConversion.conversion == 'g') || (theConversion.conversion == 'G')) {
+                    bodyLength = general(digits, number, theConversion.precision, theConversion.alternate, upperCase);
+                } else if (((theConversion.conversion == 'f') || (theConversion.conversion == 'F')) && (number < maxFixedValue)) {
+                    bodyLength = fixed(digits, number, maxFixedPrecision, theConversion.alternate);        // precision is limited
+                } else {
+                    bodyLength = scientific(digits, number, precision, theConversion.alternate, upperCase);        // also for %a, and %f of very large values
+                }
+#else
+                return fallback(destination, destinationLength, theConversion, value.floatValue);
+#endif
+            }
+        } break;
+        default:        // unsupported conversion, eg %n
+            destination[0] = 0;
+            return 0;
+    }
+
+    uint32_t total   = ((sign != 0) ? 1U : 0U) + prefixLength + zeroes + bodyLength;
+    uint32_t padding = (theConversion.width > total) ? (theConversion.width - total) : 0U;
+    if (theConversion.zeroPad && numeric && !theConversion.leftAlign) {
+        zeroes += padding;        // 0 : pad with zeroes after the sign and prefix
+        padding = 0;
+    }
+    uint32_t limit = destinationLength - 1U;        // room for the terminating zero
+    uint32_t written{0};
+    if (!theConversion.leftAlign) {
+        written = appendRepeated(destination, written, limit, ' ', padding);
+    }
+    if (sign != 0) {
+        written = append(destination, written, limit, &sign, 1U);
+    }
+    written = append(destination, written, limit, prefix, prefixLength);
+    written = appendRepeated(destination, written, limit, '0', zeroes);
+    written = append(destination, written, limit, body, bodyLength);
+    if (theConversion.leftAlign) {
+        written = appendRepeated(destination, written, limit, ' ', padding);
+    }
+    destination[written] = 0;
+    return written;
+}
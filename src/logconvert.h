@@ -0,0 +1,49 @@
+#pragma once
+#include <stdint.h>
+#include "logargs.h"
+
+// Built-in printf() style conversions, used instead of the snprintf() of the platform, which on newlib / Arduino is slow, large and locale aware.
+// Integers are converted two decimal digits at a time from a table, and hex / octal a digit at a time, without divisions where possible.
+// %f is converted as fixed point, for precisions up to maxFixedPrecision and values up to maxFixedValue : rounding is half away from zero, where printf() rounds the exact binary value, so the last digit can differ for ties.
+// %e, %g, %a and %f outside those limits are rare in logging, they are still handed to snprintf().
+// To leave snprintf() and its float support out of the binary, build with -DLOGGING_NO_PRINTF : they are then converted here as well, with up to maxFixedPrecision decimals,
+// and with a last digit which can differ from printf(). %a is then converted as %e.
+// Supported : flags - + space # 0, width, precision, conversions d i u o x X c s p f F e E g G a A. Length modifiers are ignored, as the value carries its own type, see logArgValue
+
+struct logConversion {        // one parsed conversion specification, eg. %-08.3f
+    bool leftAlign{false};        // -
+    bool showSign{false};         // +
+    bool spaceSign{false};        // space
+    bool alternate{false};        // #
+    bool zeroPad{false};          // 0
+    uint32_t width{0};            //
+    int32_t precision{-1};        // -1 when none is given
+    char conversion{0};           // 0 when the format ends before it
+};
+
+class logConvert {
+  public:
+    static const char* parse(const char* format, logConversion& theConversion);                                                           // parses the conversion specification following a '%', returns the format after it
+    static uint32_t format(char* destination, uint32_t destinationLength, const logConversion& theConversion, const logArgValue& value);        // converts value into destination, always zero terminated and truncated to fit. Returns the number of chars written, 0 for an unsupported conversion
+    static uint32_t decimal(char* destination, uint64_t value);                                                                           // writes the decimal digits of value, no terminating zero. Needs room for maxDigits chars, returns their number
+    static uint32_t hex(char* destination, uint64_t value, bool upperCase);                                                               // same, hexadecimal
+    static uint32_t octal(char* destination, uint64_t value);                                                                             // same, octal
+    static constexpr uint32_t maxDigits{22U};                                                                                             // of a 64 bit value in octal
+    static constexpr int32_t maxFixedPrecision{9};                                                                                        //
+    static constexpr double maxFixedValue{1e18};                                                                                          // so the integer part fits 64 bits
+
+#ifndef unitTest
+  private:
+#endif
+    static uint32_t decimalBackwards(char* end, uint64_t value);                                                           // writes the digits backwards, ending just before end, so they need no copy. Returns their number
+    static uint32_t hexBackwards(char* end, uint64_t value, bool upperCase);                                               //
+    static uint32_t octalBackwards(char* end, uint64_t value);                                                             //
+    static uint32_t fixed(char* destination, double value, int32_t precision, bool alternate);                             // writes value >= 0 with precision decimals, needs room for maxDigits + maxFixedPrecision + 1 chars
+    static int32_t decimalExponent(double value, int32_t precision);                                                       // exponent of value >= 0 in scientific notation, once its mantissa is rounded to precision decimals
+    static double scaleDown(double value, int32_t exponent);                                                               // value / 10^exponent
+    static uint32_t scientific(char* destination, double value, int32_t precision, bool alternate, bool upperCase);        // %e of value >= 0
+    static uint32_t general(char* destination, double value, int32_t precision, bool alternate, bool upperCase);           // %g of value >= 0
+#ifndef LOGGING_NO_PRINTF
+    static uint32_t fallback(char* destination, uint32_t destinationLength, const logConversion& theConversion, double value);        // snprintf() for the float conversions not done here
+#endif
+};
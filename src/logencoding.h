@@ -0,0 +1,11 @@
+#pragma once
+#include <stdint.h>
+
+// how an output renders the items
+
+enum class logEncoding : uint8_t {
+    text,          // I message key=value, with optional color and timestamp
+    logfmt,        // ts=2022-01-29T19:46:51.123Z level=Info subsystem=3 msg=message key=value
+    json,          // {"ts":"2022-01-29T19:46:51.123Z","level":"Info","subsystem":3,"msg":"message","key":value}, one object per line
+    binary         // compact frames, see logbinary.h. Only for a batch output, as the frames contain zeroes
+};
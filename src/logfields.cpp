@@ -0,0 +1,231 @@
+#include <string.h>        // required for strlen()
+#include <math.h>          // required for isfinite()
+#include "logfields.h"
+#include "logconvert.h"
+
+logLineWriter::logLineWriter(char* destination, uint32_t length, uint32_t maxLength, logEncoding theEncoding) : destination(destination), theLength(length), maxLength(maxLength), theEncoding(theEncoding) {}
+
+void logLineWriter::begin() {
+    if (theEncoding == logEncoding::json) {
+        add('{');
+    }
+}
+
+uint32_t logLineWriter::end() {
+    if (theEncoding == logEncoding::json) {
+        destination[theLength++] = '}';
+    }
+    destination[theLength++] = '\n';
+    destination[theLength]   = 0;
+    return theLength;
+}
+
+void logLineWriter::addText(const char* text, uint32_t textLength) {
+    while ((textLength > 0) && add(*text)) {
+        text++;
+        textLength--;
+    }
+}
+
+bool logLineWriter::addString(const char* key, const char* text, uint32_t textLength) {
+    uint32_t previousLength = theLength;
+    bool previousFirstField = firstField;
+    if (!addKey(key) || !addEscaped(text, textLength, true)) {
+        theLength  = previousLength;
+        firstField = previousFirstField;
+        return false;
+    }
+    return true;
+}
+
+bool logLineWriter::addValue(const char* key, const logArgValue& value) {
+    uint32_t previousLength = theLength;
+    bool previousFirstField = firstField;
+    bool fits               = addKey(key);
+    if (fits) {
+        char number[32];
+        uint32_t numberLength{0};
+        switch (value.type) {
+            case logArgType::int32:
+            case logArgType::int64:
+                if (value.signedValue < 0) {
+                    number[numberLength++] = '-';
+                    numberLength += logConvert::decimal(number + numberLength, 0U - static_cast<uint64_t>(value.signedValue));
+                } else {
+                    numberLength = logConvert::decimal(number, static_cast<uint64_t>(value.signedValue));
+                }
+                break;
+            case logArgType::uint32:
+            case logArgType::uint64:
+                numberLength = logConvert::decimal(number, value.unsignedValue);
+                break;
+            case logArgType::float64:
+                if ((theEncoding == logEncoding::json) && !isfinite(value.floatValue)) {
+                    memcpy(number, "null", 4);        // json has no nan nor infinity
+                    numberLength = 4;
+                } else {
+                    logConversion theConversion;
+                    theConversion.conversion = 'g';
+                    numberLength             = logConvert::format(number, sizeof(number), theConversion, value);
+                }
+                break;
+            case logArgType::pointer:
+                if (theEncoding == logEncoding::json) {
+                    number[numberLength++] = '"';        // json numbers are decimal only
+                }
+                number[numberLength++] = '0';
+                number[numberLength++] = 'x';
+                numberLength += logConvert::hex(number + numberLength, value.unsignedValue, false);
+                if (theEncoding == logEncoding::json) {
+                    number[numberLength++] = '"';
+                }
+                break;
+            case logArgType::string:
+            default:
+                fits = addEscaped(value.stringValue, strlen(value.stringValue), false);
+                break;
+        }
+        for (uint32_t index = 0; fits && (index < numberLength); index++) {
+            fits = add(number[index]);
+        }
+    }
+    if (!fits) {
+        theLength  = previousLength;
+        firstField = previousFirstField;
+    }
+    return fits;
+}
+
+void logLineWriter::addFields(const char* fields, uint32_t fieldsLength) {
+    uint32_t index{0};
+    while (index < fieldsLength) {
+        logArgValue key;
+        logArgValue value;
+        uint32_t keyLength = logArgs::unpack(fields + index, fieldsLength - index, key);
+        if ((keyLength == 0) || (key.type != logArgType::string)) {
+            return;        // corrupt fields
+        }
+        uint32_t valueLength = logArgs::unpack(fields + index + keyLength, fieldsLength - (index + keyLength), value);
+        if ((valueLength == 0) || !addValue(key.stringValue, value)) {
+            return;        // the fields after one not fitting are left out as well, so they keep their order
+        }
+        index += keyLength + valueLength;
+    }
+}
+
+uint32_t logLineWriter::message(const char* contents, uint32_t contentsLength, const char*& text, uint32_t& textLength) {
+    logArgValue value;
+    uint32_t length = logArgs::unpack(contents, contentsLength, value);
+    if ((length == 0) || (value.type != logArgType::string)) {
+        text       = "";
+        textLength = 0;
+        return 0;
+    }
+    text       = value.stringValue;
+    textLength = length - 2U;        // type and terminating zero
+    return length;
+}
+
+bool logLineWriter::addKey(const char* key) {
+    bool fits{true};
+    switch (theEncoding) {
+        case logEncoding::json:
+            fits = (firstField || add(',')) && add('"');
+            break;
+        case logEncoding::logfmt:
+            fits = firstField || add(' ');
+            break;
+        case logEncoding::text:        // fields follow the message
+        default:
+            fits = add(' ');
+            break;
+    }
+    while (fits && (*key != 0)) {
+        fits = add(*key++);
+    }
+    fits       = fits && ((theEncoding != logEncoding::json) || add('"')) && add((theEncoding == logEncoding::json) ? ':' : '=');
+    firstField = false;
+    return fits;
+}
+
+bool logLineWriter::add(char aChar) {
+    if (theLength >= maxLength) {
+        return false;
+    }
+    destination[theLength++] = aChar;
+    return true;
+}
+
+bool logLineWriter::addEscaped(const char* text, uint32_t textLength, bool truncate) {
+    bool quoted = needsQuotes(text, textLength);
+    if (quoted && ((theLength + 2U) > maxLength)) {
+        return false;        // not even room for the quotes
+    }
+    uint32_t closingLength = quoted ? 1U : 0U;
+    if (quoted) {
+        destination[theLength++] = '"';
+    }
+    for (uint32_t index = 0; index < textLength; index++) {
+        char escaped[8];
+        uint32_t escapedLength{1};
+        escaped[0] = text[index];
+        if (quoted) {
+            switch (text[index]) {
+                case '"':
+                case '\\':
+                    escaped[0]    = '\\';
+                    escaped[1]    = text[index];
+                    escapedLength = 2;
+                    break;
+                case '\n':
+                    memcpy(escaped, "\\n", 2);
+                    escapedLength = 2;
+                    break;
+                case '\r':
+                    memcpy(escaped, "\\r", 2);
+                    escapedLength = 2;
+                    break;
+                case '\t':
+                    memcpy(escaped, "\\t", 2);
+                    escapedLength = 2;
+                    break;
+                default:
+                    if ((theEncoding == logEncoding::json) && (static_cast<uint8_t>(text[index]) < 0x20U)) {
+                        static const char hexDigits[] = "0123456789abcdef";
+                        memcpy(escaped, "\\u00", 4);
+                        escaped[4]    = hexDigits[static_cast<uint8_t>(text[index]) >> 4];
+                        escaped[5]    = hexDigits[static_cast<uint8_t>(text[index]) & 0x0FU];
+                        escapedLength = 6;
+                    }
+                    break;
+            }
+        }
+        if ((theLength + escapedLength + closingLength) > maxLength) {        // an escape sequence is never split
+            if (!truncate) {
+                return false;
+            }
+            break;
+        }
+        memcpy(destination + theLength, escaped, escapedLength);
+        theLength += escapedLength;
+    }
+    if (quoted) {
+        destination[theLength++] = '"';
+    }
+    return true;
+}
+
+bool logLineWriter::needsQuotes(const char* text, uint32_t textLength) const {
+    if (theEncoding == logEncoding::json) {
+        return true;
+    }
+    if (textLength == 0) {
+        return (theEncoding == logEncoding::logfmt);        // key= would be ambiguous
+    }
+    for (uint32_t index = 0; index < textLength; index++) {
+        if ((static_cast<uint8_t>(text[index]) <= ' ') || (text[index] == '"') || (text[index] == '=') || (text[index] == '\\')) {
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include <stdint.h>
+#include "logargs.h"
+#include "logencoding.h"
+
+// Structured items : a message with typed key / value fields, eg. theLog.log(subSystem::networkData, loggingLevel::Info, "joined", kv("rssi", -71), kv("slot", 3))
+// The message and fields are packed as they are, see logargs.h, so logging them costs no formatting. Each output renders them in its own encoding, see logencoding.h :
+// * text   : I joined rssi=-71 slot=3
+// * logfmt : level=Info subsystem=12 msg=joined rssi=-71 slot=3
+// * json   : {"level":"Info","subsystem":12,"msg":"joined","rssi":-71,"slot":3}
+// * binary : the packed message and fields, rendered on the host by tools/ulog-decode
+// Keys are copied into the item, so they need not be literals. They are not escaped, so they should be plain identifiers.
+
+template <typename valueType>
+struct logField {
+    const char* key;
+    valueType value;
+};
+
+template <typename valueType>
+logField<valueType> kv(const char* key, valueType value) {
+    return logField<valueType>{key, value};
+}
+
+class logLineWriter {        // appends the parts of an item to a line in one encoding, quoting and escaping as needed, and never beyond maxLength
+  public:
+    logLineWriter(char* destination, uint32_t length, uint32_t maxLength, logEncoding theEncoding);
+
+    void begin();                                                                  // opening brace of a json object
+    uint32_t end();                                                                // closing brace, newline and terminating zero, which always fit : up to 3 chars beyond maxLength. Returns the length of the line, excluding the terminating zero
+    void addText(const char* text, uint32_t textLength);                           // plain text, truncated when it does not fit
+    bool addString(const char* key, const char* text, uint32_t textLength);        // a field with a string value, truncated when it does not fit. Returns false when not even its key fits
+    bool addValue(const char* key, const logArgValue& value);                      // a field with any packed value. Returns false when it does not fit, the line is then as before
+    void addFields(const char* fields, uint32_t fieldsLength);                     // packed key / value pairs, as far as they fit
+    uint32_t length() const {
+        return theLength;
+    }
+
+    static uint32_t message(const char* contents, uint32_t contentsLength, const char*& text, uint32_t& textLength);        // finds the message of packed structured contents. Returns the number of bytes it takes, the fields follow it
+
+#ifndef unitTest
+  private:
+#endif
+    bool addKey(const char* key);
+    bool add(char aChar);
+    bool addEscaped(const char* text, uint32_t textLength, bool truncate);        // a string value, quoted when the encoding needs it. Unless truncate, returns false when it does not completely fit
+    bool needsQuotes(const char* text, uint32_t textLength) const;
+
+    char* destination;
+    uint32_t theLength;
+    uint32_t maxLength;
+    logEncoding theEncoding;
+    bool firstField{true};
+};
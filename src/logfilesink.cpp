@@ -0,0 +1,269 @@
+#include <string.h>        // required for strlen(), memcpy()
+#include "logfilesink.h"
+#include "logclock.h"
+#include "logconvert.h"
+
+#if !defined(ARDUINO) && !defined(ESP32) && (defined(__unix__) || defined(__APPLE__))
+#include <errno.h>           // required for EINTR
+#include <fcntl.h>           // required for open()
+#include <stdio.h>           // required for rename()
+#include <unistd.h>          // required for close(), fsync()
+#include <sys/stat.h>        // required for fstat()
+#include <sys/uio.h>         // required for writev()
+
+bool logFileSink::open(const char* path, uint32_t newMaxFileSize, uint32_t newMaxNmbrFiles) {
+    close();
+    uint32_t pathLength = strlen(path);
+    if ((pathLength + 1U + logConvert::maxDigits) >= maxPathLength) {
+        return false;        // no room for the suffix of the rotated files
+    }
+    memcpy(thePath, path, pathLength + 1U);
+    maxFileSize  = newMaxFileSize;
+    maxNmbrFiles = newMaxNmbrFiles;
+    return openFile(false);
+}
+
+void logFileSink::close() {
+    if (file >= 0) {
+        sync();
+        ::close(file);
+        file = -1;
+    }
+    bufferLevel = 0;
+}
+
+bool logFileSink::write(const char* text, uint32_t length, loggingLevel theLevel) {
+    if (file < 0) {
+        return false;
+    }
+    if (needsRotation(length) && !rotate()) {
+        return false;
+    }
+    if ((bufferLevel + length) <= bufferSize) {
+        if (bufferLevel == 0) {
+            bufferedSince = logMicroseconds();
+        }
+        memcpy(buffer + bufferLevel, text, length);
+        bufferLevel += length;
+    } else if (!writeOut(text, length)) {
+        return false;
+    }
+    fileSize += length;
+    nmbrItems++;
+    unsynced = true;
+    if (isSyncLevel(theLevel)) {
+        sync();        // the item is accepted anyway : retrying it would not make the sync succeed
+    }
+    return true;
+}
+
+bool logFileSink::flush() {
+    return (file >= 0) && writeOut(nullptr, 0);
+}
+
+bool logFileSink::sync() {
+    if (!flush()) {
+        return false;
+    }
+    lastSync = logMicroseconds();
+    unsynced = false;
+    nmbrSyncs++;
+#if defined(__APPLE__)
+    return (fsync(file) == 0);
+#else
+    return (fdatasync(file) == 0);        // the size of the file is synced as well, only its timestamps are not
+#endif
+}
+
+bool logFileSink::writeOut(const char* text, uint32_t length) {
+    if ((bufferLevel == 0) && (length == 0)) {
+        return true;
+    }
+    struct iovec vectors[2];
+    vectors[0].iov_base   = buffer;
+    vectors[0].iov_len    = bufferLevel;
+    vectors[1].iov_base   = const_cast<char*>(text);
+    vectors[1].iov_len    = length;
+    struct iovec* pending = vectors;
+    int nmbrPending{2};
+    uint32_t written{0};
+    while (nmbrPending > 0) {
+        ssize_t result = ::writev(file, pending, nmbrPending);
+        nmbrWrites++;
+        if ((result < 0) && (errno == EINTR)) {
+            continue;
+        }
+        if (result <= 0) {
+            break;        // eg. the disk is full
+        }
+        written += static_cast<uint32_t>(result);
+        size_t done = static_cast<size_t>(result);
+        while ((nmbrPending > 0) && (done >= pending->iov_len)) {
+            done -= pending->iov_len;
+            pending++;
+            nmbrPending--;
+        }
+        if (nmbrPending > 0) {
+            pending->iov_base = static_cast<char*>(pending->iov_base) + done;
+            pending->iov_len -= done;
+        }
+    }
+    if (written < bufferLevel) {
+        memmove(buffer, buffer + written, bufferLevel - written);        // kept for the next write, text is not accepted
+        bufferLevel -= written;
+        return false;
+    }
+    uint32_t textWritten = written - bufferLevel;
+    bufferLevel          = 0;
+    while (textWritten < length) {        // the rest of a partly written item is kept, as writing it again would duplicate its start
+        uint32_t restLength = length - textWritten;
+        if (restLength <= bufferSize) {
+            memcpy(buffer, text + textWritten, restLength);
+            bufferLevel   = restLength;
+            bufferedSince = logMicroseconds();
+            return true;
+        }
+        ssize_t result = ::write(file, text + textWritten, restLength - bufferSize);        // until the rest fits the buffer
+        nmbrWrites++;
+        if ((result < 0) && (errno == EINTR)) {
+            continue;
+        }
+        if (result <= 0) {
+            return false;        // part of the item is lost, so it is not reported as accepted
+        }
+        textWritten += static_cast<uint32_t>(result);
+    }
+    return true;
+}
+
+bool logFileSink::rotate() {
+    if (!flush()) {
+        return false;
+    }
+    ::close(file);
+    file = -1;
+    char fromPath[maxPathLength];
+    char toPath[maxPathLength];
+    for (uint32_t index = maxNmbrFiles; index > 1; index--) {        // the oldest file is overwritten
+        rotatedPath(fromPath, index - 1U);
+        rotatedPath(toPath, index);
+        rename(fromPath, toPath);        // fails when there is no such file yet, which is fine
+    }
+    if (maxNmbrFiles > 0) {
+        rotatedPath(toPath, 1U);
+        rename(thePath, toPath);
+    }
+    nmbrRotations++;
+    return openFile(true);
+}
+
+bool logFileSink::openFile(bool truncate) {
+    file = ::open(thePath, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC | (truncate ? O_TRUNC : 0), 0644);
+    if (file < 0) {
+        return false;
+    }
+    struct stat status;
+    fileSize      = (fstat(file, &status) == 0) ? static_cast<uint64_t>(status.st_size) : 0U;
+    nmbrItems     = 0;
+    lastSync      = logMicroseconds();
+    bufferedSince = lastSync;
+    return true;
+}
+
+#else
+
+// no files on this platform : use setOutput() with eg. an SD card library instead
+
+bool logFileSink::open(const char*, uint32_t, uint32_t) {
+    return false;
+}
+
+void logFileSink::close() {}
+
+bool logFileSink::write(const char*, uint32_t, loggingLevel) {
+    return false;
+}
+
+bool logFileSink::flush() {
+    return false;
+}
+
+bool logFileSink::sync() {
+    return false;
+}
+
+bool logFileSink::writeOut(const char*, uint32_t) {
+    return false;
+}
+
+bool logFileSink::rotate() {
+    return false;
+}
+
+bool logFileSink::openFile(bool) {
+    return false;
+}
+
+#endif
+
+logFileSink::~logFileSink() {
+    close();
+}
+
+bool logFileSink::isOpen() const {
+    return (file >= 0);
+}
+
+void logFileSink::setRotation(uint32_t newMaxFileSize, uint32_t newMaxNmbrItems, uint32_t newMaxNmbrFiles) {
+    maxFileSize  = newMaxFileSize;
+    maxNmbrItems = newMaxNmbrItems;
+    maxNmbrFiles = newMaxNmbrFiles;
+}
+
+void logFileSink::setSync(loggingLevel newSyncLevel, uint32_t newSyncIntervalInMs) {
+    syncLevel    = newSyncLevel;
+    syncInterval = newSyncIntervalInMs * 1000U;
+}
+
+void logFileSink::setFlushInterval(uint32_t newFlushIntervalInMs) {
+    flushInterval = newFlushIntervalInMs * 1000U;
+}
+
+bool logFileSink::write(const char* text) {
+    bool accepted = write(text, strlen(text), loggingLevel::None);        // a line has no level, so it is synced by the interval only
+    poll();
+    return accepted;
+}
+
+void logFileSink::poll() {
+    if (file < 0) {
+        return;
+    }
+    uint32_t now = logMicroseconds();
+    if ((bufferLevel > 0) && ((now - bufferedSince) >= flushInterval)) {
+        flush();
+    }
+    if (unsynced && (syncInterval > 0) && ((now - lastSync) >= syncInterval)) {
+        sync();
+    }
+}
+
+uint64_t logFileSink::getFileSize() const {
+    return fileSize;
+}
+
+bool logFileSink::needsRotation(uint32_t length) const {
+    return ((maxFileSize > 0) && (fileSize > 0) && ((fileSize + length) > maxFileSize)) || ((maxNmbrItems > 0) && (nmbrItems >= maxNmbrItems));
+}
+
+void logFileSink::rotatedPath(char* destination, uint32_t index) const {
+    uint32_t pathLength = strlen(thePath);
+    memcpy(destination, thePath, pathLength);
+    destination[pathLength++] = '.';
+    pathLength += logConvert::decimal(destination + pathLength, index);
+    destination[pathLength] = 0;
+}
+
+bool logFileSink::isSyncLevel(loggingLevel theLevel) const {
+    return (theLevel <= syncLevel) && (theLevel != loggingLevel::None) && (syncLevel != loggingLevel::None);
+}
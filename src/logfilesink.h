@@ -0,0 +1,77 @@
+#pragma once
+#include <stdint.h>
+#include "logginglevels.h"
+
+// An output to a file, for native Linux / macOS, so an application does not need its own fopen() / fputs() / fflush(), which costs a system call per item.
+// Items are collected in a write-behind buffer, which is written with one system call when it is full. An item which does not fit goes out in the same writev() as the buffer, so it is not copied.
+// The file is rotated when it would grow beyond maxFileSize bytes, or hold more than maxNmbrItems items : app.log is renamed to app.log.1, app.log.1 to app.log.2, and so on, keeping maxNmbrFiles old files.
+// fsync() is batched : it is done at most every syncInterval, and right away after an item at the sync level or above, so eg. a Critical item is on disk before the application goes on.
+// Buffered items are written at the latest flushInterval after the first of them, when the sink is called again : when nothing is logged for a while, call poll() from time to time, and close() before exiting.
+// A sink is the output of a single uLog output, which calls it from one task at a time, so it has no locking.
+// Only available on native Linux / macOS. On other platforms, open() fails.
+//
+// Example :
+//   logFileSink theFile;
+//   uint32_t toFile(const logSpan* spans, uint32_t nmbrSpans) { return theFile.write(spans, nmbrSpans); }        // or bool toFile(const char* line) { return theFile.write(line); } with setOutput(), which can't sync on the level of the items
+//
+//   theFile.open("/var/log/app.log", 16U * 1024U * 1024U, 4U);
+//   theLog.setBatchOutput(0, toFile);
+
+class logFileSink {
+  public:
+    ~logFileSink();
+    bool open(const char* path, uint32_t newMaxFileSize = 0, uint32_t newMaxNmbrFiles = 0);               // opens path for appending, creating it when needed. A maxFileSize of 0 means no limit. Returns false when it can't be opened
+    void close();                                                                                         // writes what is buffered, syncs and closes the file
+    bool isOpen() const;                                                                                  //
+    void setRotation(uint32_t newMaxFileSize, uint32_t newMaxNmbrItems, uint32_t newMaxNmbrFiles);        // 0 for maxFileSize or maxNmbrItems means no limit. With maxNmbrFiles 0, a full file is emptied instead of renamed
+    void setSync(loggingLevel newSyncLevel, uint32_t newSyncIntervalInMs);                                // items at newSyncLevel or above are synced right away, others at most every newSyncInterval. loggingLevel::None and 0 disable them
+    void setFlushInterval(uint32_t newFlushIntervalInMs);                                                 // maximum time items wait in the buffer. 0 writes them at the end of each call
+
+    bool write(const char* text);                                                                         // appends a line, for setOutput(). Returns false when it could not be written, so uLog retries it
+    bool write(const char* text, uint32_t length, loggingLevel theLevel);                                 // appends an item, without looking at the flush interval
+    template <typename spanType>
+    uint32_t write(const spanType* spans, uint32_t nmbrSpans) {                                           // appends a batch of items, for setBatchOutput(). Returns how many of them were accepted
+        uint32_t accepted{0};
+        while ((accepted < nmbrSpans) && write(spans[accepted].text, spans[accepted].length, spans[accepted].theLoggingLevel)) {
+            accepted++;
+        }
+        poll();
+        return accepted;
+    }
+    bool flush();                                                                                         // writes the buffered items to the file
+    bool sync();                                                                                          // same, and waits until the file is on disk
+    void poll();                                                                                          // flushes and syncs when their interval has elapsed
+    uint64_t getFileSize() const;                                                                         // size of the current file, including the items still buffered
+
+    static constexpr uint32_t bufferSize{64U * 1024U};        //
+    static constexpr uint32_t maxPathLength{256U};            // including the suffix of a rotated file
+
+#ifndef unitTest
+  private:
+#endif
+    bool writeOut(const char* text, uint32_t length);                 // writes the buffer followed by text, with one writev(). Returns false when the buffer could not be written
+    bool needsRotation(uint32_t length) const;                        // would an item of length bring the file over its limits
+    bool rotate();                                                    //
+    bool openFile(bool truncate);                                     //
+    void rotatedPath(char* destination, uint32_t index) const;        // path of the rotated file with this index, eg. app.log.2
+    bool isSyncLevel(loggingLevel theLevel) const;                    //
+
+    int file{-1};                                          // file descriptor, -1 when not open
+    char thePath[maxPathLength]{};                         //
+    char buffer[bufferSize];                               // write-behind buffer
+    uint32_t bufferLevel{0};                               // number of bytes in buffer
+    uint64_t fileSize{0};                                  //
+    uint32_t nmbrItems{0};                                 // number of items in the current file, since it was opened
+    uint32_t maxFileSize{0};                               //
+    uint32_t maxNmbrItems{0};                              //
+    uint32_t maxNmbrFiles{0};                              //
+    loggingLevel syncLevel{loggingLevel::Critical};        //
+    uint32_t syncInterval{1000000U};                       // in us
+    uint32_t flushInterval{100000U};                       // in us
+    uint32_t bufferedSince{0};                             // time the oldest buffered item was appended, in us
+    uint32_t lastSync{0};                                  // in us
+    bool unsynced{false};                                  // set when items were appended since the last sync
+    uint32_t nmbrWrites{0};                                // number of system calls writing to the file
+    uint32_t nmbrSyncs{0};                                 //
+    uint32_t nmbrRotations{0};                             //
+};
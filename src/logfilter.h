@@ -0,0 +1,78 @@
+#pragma once
+#include "logginglevels.h"
+#include "subsystems.h"
+#include "logformat.h"
+
+// Compile-time filtering : log calls through the ULOG_xxx macros below are removed entirely when their loggingLevel is below the compile-time minimum of their subSystem.
+// The compiler then drops the call, its format string and the evaluation of its arguments, so they cost neither flash nor cycles.
+// Calls which pass this filter are still subject to the normal runtime filtering of each output.
+//
+// Configuration :
+// * the minimum level for all subSystems, eg. build_flags = -DLOGGING_MIN_LEVEL=loggingLevel::Info
+// * the minimum level for one subSystem, by specializing compiledLoggingLevel, eg. LOGGING_SUBSYSTEM_MIN_LEVEL(subSystem::nfc, loggingLevel::Warning)
+//   Put these in a header and pass it as build_flags = -DLOGGING_CONFIG_HEADER=\"myloggingconfig.h\", so all files see the same configuration
+//
+// Example : ULOG_SNPRINTF(theLog, subSystem::nfc, loggingLevel::Debug, "frame %s", toHex(frame));        // toHex() is not even called when Debug is compiled out for nfc
+// A block of code which only prepares what is logged is guarded by ULOG_IS_ENABLED : compiled out, or else skipped at runtime when no output wants such items
+// Example : if (ULOG_IS_ENABLED(theLog, subSystem::certificate, loggingLevel::Debug)) { fingerprint(certificate, text); theLog.log(subSystem::certificate, loggingLevel::Debug, text); }
+
+#ifndef LOGGING_MIN_LEVEL
+#define LOGGING_MIN_LEVEL loggingLevel::Debug
+#endif
+
+template <typename subSystemType, subSystemType theSubSystem>        // the type of the subSystem is a parameter as well, so a basicLog with its own enum of subSystems is filtered the same way
+struct compiledLoggingLevelOf {
+    static constexpr loggingLevel value = LOGGING_MIN_LEVEL;
+};
+
+template <subSystem theSubSystem>
+using compiledLoggingLevel = compiledLoggingLevelOf<subSystem, theSubSystem>;
+
+#define LOGGING_SUBSYSTEM_MIN_LEVEL(theSubSystem, theLevel)                   \
+    template <>                                                               \
+    struct compiledLoggingLevelOf<decltype(theSubSystem), theSubSystem> {     \
+        static constexpr loggingLevel value = theLevel;                       \
+    }
+
+#define ULOG_IS_COMPILED_IN(theSubSystem, theLevel) ((theLevel) <= compiledLoggingLevelOf<decltype(theSubSystem), theSubSystem>::value)
+
+#define ULOG_IS_ENABLED(theLog, theSubSystem, theLevel) (ULOG_IS_COMPILED_IN(theSubSystem, theLevel) && (theLog).isEnabled((theSubSystem), (theLevel)))
+
+#define ULOG_LOG(theLog, theSubSystem, theLevel, aText)            \
+    do {                                                           \
+        if (ULOG_IS_COMPILED_IN(theSubSystem, theLevel)) {         \
+            (theLog).log((theSubSystem), (theLevel), (aText));     \
+        }                                                          \
+    } while (0)
+
+#define ULOG_OUTPUT(theLog, theSubSystem, theLevel, aText)          \
+    do {                                                            \
+        if (ULOG_IS_COMPILED_IN(theSubSystem, theLevel)) {          \
+            (theLog).output((theSubSystem), (theLevel), (aText));   \
+        }                                                           \
+    } while (0)
+
+#define ULOG_SNPRINTF(theLog, theSubSystem, theLevel, ...)                \
+    do {                                                                  \
+        if (ULOG_IS_COMPILED_IN(theSubSystem, theLevel)) {                \
+            (theLog).snprintf((theSubSystem), (theLevel), __VA_ARGS__);   \
+        }                                                                 \
+    } while (0)
+
+#define ULOG_DEFERRED(theLog, theSubSystem, theLevel, ...)                   \
+    do {                                                                     \
+        if (ULOG_IS_COMPILED_IN(theSubSystem, theLevel)) {                   \
+            (theLog).logDeferred((theSubSystem), (theLevel), __VA_ARGS__);   \
+        }                                                                    \
+    } while (0)
+
+#define ULOG_INTERNED(theLog, theSubSystem, theLevel, aLiteral, ...)                                  \
+    do {                                                                                              \
+        if (ULOG_IS_COMPILED_IN(theSubSystem, theLevel)) {                                            \
+            (theLog).logDeferred((theSubSystem), (theLevel), ULOG_FORMAT(aLiteral), ##__VA_ARGS__);   \
+        }                                                                                             \
+    } while (0)
+
+#ifdef LOGGING_CONFIG_HEADER
+#include LOGGING_CONFIG_HEADER
+#endif
@@ -0,0 +1,25 @@
+#pragma once
+#include <stdint.h>
+
+// Interned format strings : each log site gets a stable ID for its format string, computed at compile time, so neither the target nor the host needs a table built at runtime.
+// The ID is the FNV-1a hash of the format string, the same as logBinary::formatId(), so it is what a binary output transmits instead of the text.
+// The host finds the format strings by hashing the string literals of the sources : tools/ulog-decode --write-table generates the mapping table from them.
+//
+// Example : theLog.logDeferred(subSystem::general, loggingLevel::Error, ULOG_FORMAT("Error in %s on line %d"), __FILE__, __LINE__);
+//           ULOG_INTERNED(theLog, subSystem::general, loggingLevel::Error, "Error in %s on line %d", __FILE__, __LINE__);        // same, with compile-time filtering, see logfilter.h
+
+struct logFormat {        // a format string and its ID, as a static constant of the log site
+    const char* text;
+    uint32_t id;
+};
+
+constexpr uint32_t logFormatId(const char* text, uint32_t hash = 2166136261U) {        // C++11 constexpr, so one recursion per char : format strings are limited by the constexpr depth of the compiler, 512 by default
+    return (*text == 0) ? hash : logFormatId(text + 1, (hash ^ static_cast<uint8_t>(*text)) * 16777619U);
+}
+
+// A reference to a static logFormat for aLiteral. Its ID is a constant expression, so it is computed by the compiler, whatever the optimization level
+#define ULOG_FORMAT(aLiteral)                                                    \
+    (*[]() -> const logFormat* {                                                 \
+        static constexpr logFormat theFormat{aLiteral, logFormatId(aLiteral)};   \
+        return &theFormat;                                                       \
+    }())
@@ -8,8 +8,7 @@
 // #############################################################################
 
 #include <stdint.h>         // required for uint8_t and similar type definitions
-#include <string.h>         // required for strncpy()
-#include <stdio.h>          // required for vsnprintf()
+#include <string.h>         // required for strncpy(), memcpy()
 #include "logging.h"        //
 
 #ifndef strlcpy
@@ -43,190 +42,3 @@ strlcat(char *dst, const char *src, size_t maxlen) {
     return dstlen + srclen;
 }
 #endif
-
-uLog::uLog() {
-}
-
-bool uLog::checkLoggingLevel(subSystem theSubSystem, loggingLevel itemLoggingLevel) const {
-    bool result{false};
-    for (uint32_t i = 0; i < maxNmbrOutputs; i++) {        // for all outputs
-        if (outputs[i].isActive()) {
-            if (itemLoggingLevel <= outputs[i].getLoggingLevel(theSubSystem)) {
-                result = true;
-            }
-        }
-    }
-    return result;
-}
-
-bool uLog::checkLoggingLevel(uint32_t outputIndex, subSystem theSubSystem, loggingLevel itemLoggingLevel) const {
-    bool result{false};
-    if (outputIndex < maxNmbrOutputs) {
-        if (outputs[outputIndex].isActive()) {
-            if (itemLoggingLevel <= outputs[outputIndex].getLoggingLevel(theSubSystem)) {
-                result = true;
-            }
-        }
-    }
-    return result;
-}
-
-bool uLog::checkLoggingLevel(uint32_t outputIndex, logItem anItem) const {
-    return checkLoggingLevel(outputIndex, anItem.theSubSystem, anItem.theLoggingLevel);
-}
-
-void uLog::log(subSystem theSubSystem, loggingLevel itemLoggingLevel, const char *aText) {
-    if (checkLoggingLevel(theSubSystem, itemLoggingLevel)) {        // if any output is interested in this item, we store it in the buffer
-        uint32_t newItemIndex = pushItem();
-        strlcpy(items[newItemIndex].contents, aText, logItem::maxItemLength);
-        items[newItemIndex].theLoggingLevel = itemLoggingLevel;
-        items[newItemIndex].theSubSystem    = theSubSystem;
-
-        if (getTime != nullptr) {
-            if (getTime(items[newItemIndex].timestamp, logItem::timestampLength)) {
-            } else {
-                strcpy(items[newItemIndex].timestamp, "");
-            }
-        } else {
-            strcpy(items[newItemIndex].timestamp, "");
-        }
-    }
-}
-
-void uLog::snprintf(subSystem theSubSystem, loggingLevel itemLoggingLevel, const char *format, ...) {
-    if (checkLoggingLevel(theSubSystem, itemLoggingLevel)) {
-        va_list argList;
-        char buffer[logItem::maxItemLength];        // not initialized for performance
-        va_start(argList, format);
-        vsnprintf(buffer, logItem::maxItemLength, format, argList);
-        va_end(argList);
-        output(theSubSystem, itemLoggingLevel, buffer);
-    }
-}
-
-void uLog::output(subSystem theSubSystem, loggingLevel itemLoggingLevel, const char *aText) {
-    log(theSubSystem, itemLoggingLevel, aText);
-    output();
-}
-
-void uLog::flush() {
-    output();
-}
-
-void uLog::output() {
-    while (level > 0) {                                                                                    // if any items in buffer :
-        for (uint32_t outputIndex = 0; outputIndex < maxNmbrOutputs; outputIndex++) {                      // for all outputs
-            if (outputs[outputIndex].isActive() && (checkLoggingLevel(outputIndex, items[head]))) {        // if this output is active and it wants this level of logitem..
-                format(outputIndex);                                                                       // format the item according to the output's settings
-                (void)outputs[outputIndex].write(contents);
-            }
-        }
-        popItem();        // remove the item from the buffer
-    }
-}
-
-void uLog::popItem() {
-    if (level > 0) {
-        level = level - 1;
-        head  = (head + 1) % length;
-    }
-}
-
-uint32_t uLog::pushItem() {
-    uint32_t newIndex = ((head + level) % length);
-    if (level < length) {
-        level = level + 1;
-    }
-    return newIndex;
-}
-
-void uLog::format(uint32_t outputIndex) {
-    contents[0] = 0;        // clear temp buffer
-    if (outputs[outputIndex].isColoredOutput()) {
-        strcpy(contents, colorPrefix(items[head].theLoggingLevel));
-    }
-    if (outputs[outputIndex].hasTimestampIncluded()) {
-        strcat(contents, items[head].timestamp);        // add timestamp string
-        strcat(contents, " ");                          // add a space
-    }
-    strcat(contents, toStringShort(items[head].theLoggingLevel));
-    uint32_t tmpLength = strnlen(contents, logItem::maxItemLength);
-
-    // TODO show trunctation with trailing...
-
-    if (outputs[outputIndex].isColoredOutput()) {
-        strncat(contents, items[head].contents, (logItem::maxItemLength - (tmpLength + 5U)));        // add raw contents
-        strcat(contents, colorPostfix());
-    } else {
-        strncat(contents, items[head].contents, (logItem::maxItemLength - (tmpLength + 1U)));        // add raw contents
-    }
-    strcat(contents, "\n");        // final newLine ??
-}
-
-void uLog::setTimeSource(bool (*aFunction)(char *, uint32_t)) {
-    getTime = aFunction;
-}
-
-void uLog::setOutput(uint32_t outputIndex, bool (*aFunction)(const char *)) {
-    if (outputIndex < maxNmbrOutputs) {
-        outputs[outputIndex].setOutputDestination(aFunction);
-    }
-}
-
-bool uLog::outputIsActive(uint32_t outputIndex) {
-    if (outputIndex < maxNmbrOutputs) {
-        return outputs[outputIndex].isActive();
-    } else {
-        return false;
-    }
-}
-
-void uLog::setLoggingLevel(uint32_t outputIndex, subSystem theSubSystem, loggingLevel theLoggingLevel) {
-    if (outputIndex < maxNmbrOutputs) {
-        outputs[outputIndex].setLoggingLevel(theSubSystem, theLoggingLevel);
-    }
-}
-
-void uLog::setLoggingLevel(uint32_t outputIndex, loggingLevel theLoggingLevel) {
-    if (outputIndex < maxNmbrOutputs) {
-        for (uint8_t subSystemIndex = 0; subSystemIndex < static_cast<uint8_t>(subSystem::nmbrOfSubsystems); subSystemIndex++) {
-            outputs[outputIndex].setLoggingLevel(static_cast<subSystem>(subSystemIndex), theLoggingLevel);
-        }
-    }
-}
-
-void uLog::setColoredOutput(uint32_t outputIndex, bool newSetting) {
-    if (outputIndex < maxNmbrOutputs) {
-        outputs[outputIndex].setColoredOutput(newSetting);
-    }
-}
-
-void uLog::setIncludeTimestamp(uint32_t outputIndex, bool newSetting) {
-    if (outputIndex < maxNmbrOutputs) {
-        outputs[outputIndex].setIncludeTimestamp(newSetting);
-    }
-}
-
-loggingLevel uLog::getLoggingLevel(uint32_t outputIndex, subSystem theSubSystem) {
-    if (outputIndex < maxNmbrOutputs) {
-        return outputs[outputIndex].getLoggingLevel(theSubSystem);
-    } else {
-        return loggingLevel::None;
-    }
-}
-
-bool uLog::isColoredOutput(uint32_t outputIndex) {
-    if (outputIndex < maxNmbrOutputs) {
-        return outputs[outputIndex].isColoredOutput();
-    } else {
-        return false;
-    }
-}
-
-bool uLog::hasTimestampIncluded(uint32_t outputIndex) {
-    if (outputIndex < maxNmbrOutputs) {
-        return outputs[outputIndex].hasTimestampIncluded();
-    } else {
-        return false;
-    }
-}
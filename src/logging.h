@@ -27,40 +27,214 @@
 
 #pragma once
 
-#include <stdarg.h>               // requires for variadic functions
+#include <string.h>               // required for strnlen(), memcpy()
+#include <utility>                // required for std::declval()
 #include "subsystems.h"           //
 #include "logginglevels.h"        //
 #include "logitem.h"
+#include "logtimestamp.h"
 #include "logoutput.h"
+#include "logarena.h"
+#include "logstaging.h"
+#include "loglimiter.h"
+#include "logmetrics.h"
+#include "logargs.h"
+#include "logfields.h"
+#include "logbinary.h"
+#include "logfilter.h"
+#include "logwriter.h"
+#include "overflowpolicy.h"
+#include "lagpolicy.h"
+#include "logmappedfile.h"
+#include "logfilesink.h"
+#include "logregistry.h"
+#include "loglevelrules.h"
+#include "logrecorder.h"
+#include "logconvert.h"
 
-class uLog {
+struct logConfig {        // default configuration of uLog. For another one, derive from it and override what needs to change, eg. struct gatewayLogConfig : logConfig { static constexpr uint32_t maxNmbrOutputs = 8; static constexpr uint32_t bufferSize = 4096; };
+    static constexpr uint32_t maxNmbrOutputs     = 2;                             //
+    static constexpr uint32_t bufferSize         = 512;                           // size in bytes of the items circular buffer, must be a power of 2. Items are packed, so the number of items it holds depends on their length
+    static constexpr uint32_t maxItemLength      = logItem::maxItemLength;        // maximum length of an item, as logged and as output
+    static constexpr uint32_t batchSize          = 4;                             // maximum number of items handed to an output in one write
+    static constexpr uint32_t nmbrStagingBuffers = 0;                             // number of per thread / per core staging buffers, see logstaging.h. 0 disables them
+    static constexpr uint32_t stagingBufferSize  = 256;                           // size in bytes of each staging buffer, must be a power of 2
+    static constexpr bool externalBuffer         = false;                         // when true, uLog does not hold the items buffer itself : it must be supplied with attachBuffer(), until then items are dropped
+    static constexpr bool collectMetrics         = false;                         // counters and latency histograms, see logmetrics.h. When false, they take no memory and cost nothing, so a filtered item stays one load and compare
+    static constexpr uint32_t recorderSize       = 0;                             // size in bytes of the flight recorder, see logrecorder.h, must be a power of 2. 0 disables it
+    static constexpr bool rateLimiting           = false;                         // rate limits and duplicate suppression, see loglimiter.h. When false, they take no memory, and setRateLimit() / setSuppressDuplicates() do nothing
+    typedef ::subSystem subSystemType;                                            // enum of subSystems, its last value must be nmbrOfSubsystems
+};
+
+template <uint8_t capacity>
+struct registryLogConfig : logConfig {        // subSystems registered at runtime, with handles of a logRegistry<capacity>, see logregistry.h. Derive from it as from logConfig to change more
+    typedef typename logRegistry<capacity>::handle subSystemType;
+};
+
+template <typename config>
+class basicLog {
   public:
-    explicit uLog();        // constructor
+    explicit basicLog();        // constructor
 
-    static constexpr uint32_t maxNmbrOutputs = 2;        //
-    static constexpr uint32_t length         = 4;        // length of the items circular buffer for items
+    static constexpr uint32_t maxNmbrOutputs     = config::maxNmbrOutputs;                    //
+    static constexpr uint32_t bufferSize         = config::bufferSize;                        //
+    static constexpr uint32_t maxItemLength      = config::maxItemLength;                     //
+    static constexpr uint32_t batchSize          = config::batchSize;                         //
+    static constexpr uint32_t nmbrStagingBuffers = config::nmbrStagingBuffers;                //
+    static constexpr uint32_t stagingBufferSize  = config::stagingBufferSize;                 //
+    static constexpr bool externalBuffer         = config::externalBuffer;                    //
+    static constexpr bool collectMetrics         = config::collectMetrics;                    //
+    static constexpr uint32_t recorderSize       = config::recorderSize;                      //
+    static constexpr bool rateLimiting           = config::rateLimiting;                      //
+    static constexpr uint32_t attachedBufferSize = sizeof(logArenaRegion<bufferSize>);        // number of bytes needed for attachBuffer()
+    typedef typename config::subSystemType subSystemType;
+    typedef basicLogItem<subSystemType> logItem;
+    typedef basicLogOutput<subSystemType> logOutput;
+    typedef basicLogSpan<subSystemType> logSpan;
+    typedef logMetricsSnapshot<subSystemType, maxNmbrOutputs> metricsSnapshot;
+
+    static_assert((maxNmbrOutputs > 0) && (maxNmbrOutputs <= 8U), "outputMasks has one bit per output");
+    static_assert((maxItemLength >= 48U) && (maxItemLength < 256U), "an item needs room for color codes, timestamp and level, and its size must fit in a uint8_t");
+    static_assert((batchSize > 0) && (batchSize <= 32U), "an output needs at least one item per write, and usedLines has one bit per line of a batch");
+    static_assert((nmbrStagingBuffers == 0) || (logArena<stagingBufferSize>::recordLength(logItem::storageLength(logItem::timestampLength + 1U, maxItemLength)) <= stagingBufferSize), "a staging buffer must hold at least the longest item");
 
     // ------------------------------
     // configuring the logging object
     // ------------------------------
-    void setOutput(uint32_t outputIndex, bool (*aFunction)(const char*));                                     // sets a pointer to a function handling the output of the logging to eg serial, network or file on SD card, etc.
-    bool outputIsActive(uint32_t outputIndex);                                                                // is this output active
-    void setTimeSource(bool (*aFunction)(char*, uint32_t));                                                   // sets a pointer to a function providing the timestamp prefix string.
-    void setLoggingLevel(uint32_t outputIndex, subSystem theSubSystem, loggingLevel itemLoggingLevel);        // set level of logging for one subsystem
-    void setLoggingLevel(uint32_t outputIndex, loggingLevel itemLoggingLevel);                                // set level of logging for all subsystems
-    loggingLevel getLoggingLevel(uint32_t outputIndex, subSystem theSubSystem);                               //
-    void setColoredOutput(uint32_t outputIndex, bool newSetting);                                             // set the colorize output option
-    bool isColoredOutput(uint32_t outputIndex);                                                               // set the colorize output option
-    void setIncludeTimestamp(uint32_t outputIndex, bool newSetting);                                          // set the includeTimestamp option
-    bool hasTimestampIncluded(uint32_t outputIndex);                                                          // set the includeTimestamp option
+    void setOutput(uint32_t outputIndex, bool (*aFunction)(const char*));                                         // sets a pointer to a function handling the output of the logging to eg serial, network or file on SD card, etc.
+    void setBatchOutput(uint32_t outputIndex, uint32_t (*aFunction)(const logSpan*, uint32_t));                   // same, but the function gets up to batchSize items in one call, and returns how many of them it accepted. The others are retried later
+    bool outputIsActive(uint32_t outputIndex);                                                                    // is this output active
+    void setTimeSource(bool (*aFunction)(char*, uint32_t));                                                       // sets a pointer to a function providing the timestamp prefix string.
+    void setTickSource(uint64_t (*aFunction)(), uint32_t ticksPerSecond = 1000U);                                 // sets a pointer to a function providing a tick counted from 1970-01-01T00:00:00Z. Items then only store the tick, formatted as ISO-8601 for outputs with timestamps. Takes precedence over setTimeSource()
+    void setSubSystemNames(const char* (*aFunction)(subSystemType));                                              // sets a pointer to a function naming a subSystem, eg. of a logRegistry. logfmt and json outputs then show the name instead of the number
+    void setLoggingLevel(uint32_t outputIndex, subSystemType theSubSystem, loggingLevel itemLoggingLevel);        // set level of logging for one subsystem
+    void setLoggingLevel(uint32_t outputIndex, loggingLevel itemLoggingLevel);                                    // set level of logging for all subsystems
+    loggingLevel getLoggingLevel(uint32_t outputIndex, subSystemType theSubSystem);                               //
+    bool setLoggingLevels(const char* rules);                                                                     // applies level rules to many subSystems and outputs at once, eg. "*=Warning 1:net*=Debug", see loglevelrules.h. Returns false, and changes nothing, when a rule is invalid
+    uint32_t getLevelsGeneration() const;                                                                         // incremented each time changed levels or outputs are published
+    void setColoredOutput(uint32_t outputIndex, bool newSetting);                                                 // set the colorize output option
+    bool isColoredOutput(uint32_t outputIndex);                                                                   // set the colorize output option
+    void setIncludeTimestamp(uint32_t outputIndex, bool newSetting);                                              // set the includeTimestamp option
+    bool hasTimestampIncluded(uint32_t outputIndex);                                                              // set the includeTimestamp option
+    void setEncoding(uint32_t outputIndex, logEncoding newEncoding);                                              // how this output renders the items : text lines, logfmt, json lines or binary frames, see logencoding.h
+    logEncoding getEncoding(uint32_t outputIndex);                                                                //
+    void setBinaryOutput(uint32_t outputIndex, bool newSetting);                                                  // the output gets compact binary frames instead of text lines, see logbinary.h. Requires a batch output, decoded on the host by tools/ulog-decode
+    bool isBinaryOutput(uint32_t outputIndex);                                                                    //
+    void setOverflowPolicy(overflowPolicy newPolicy, uint32_t newSampleRate = 10U);                               // what to do when the buffer is full. sampleRate is only used by overflowPolicy::sample
+    overflowPolicy getOverflowPolicy() const;                                                                     //
+    uint32_t getDroppedItems() const;                                                                             // number of items lost because the buffer was full
+    bool attachBuffer(void* memory, uint32_t memoryLength);                                                       // moves the items buffer into memory supplied by the application, see below. Returns true when it holds items of a previous run, which are then output by the next flush()
+    uint32_t getRecoveredItems() const;                                                                           // number of items of a previous run found by attachBuffer()
+    void setRateLimit(subSystemType theSubSystem, uint32_t itemsPerSecond, uint32_t burst = 10U);                 // items of this subSystem beyond this rate are dropped, and summarized, see loglimiter.h. itemsPerSecond 0 removes the limit. Requires rateLimiting in the configuration
+    void setSuppressDuplicates(bool newSetting);                                                                  // an item identical to the previous one of its subSystem is only counted, and summarized, see loglimiter.h. Requires rateLimiting in the configuration
+    uint32_t getRateLimitedItems() const;                                                                         // number of items dropped by the rate limits
+    void setLagLimit(uint32_t outputIndex, uint32_t maxLag, lagPolicy newPolicy = lagPolicy::dropOldest);         // how far, in bytes of the items buffer, this output may lag behind the newest item, see below
+    uint32_t getLaggedItems(uint32_t outputIndex) const;                                                          // number of items this output skipped because it lagged too far
+
+    void setFlightRecorder(loggingLevel recordLevel, loggingLevel triggerLevel = loggingLevel::Error, uint32_t maxDumpedItems = UINT32_MAX);        // items no output wants, up to recordLevel, are kept in the flight recorder. An item at triggerLevel or above first sends the last maxDumpedItems of them to the outputs wanting it, see below. recordLevel None stops recording
+
+    void getMetrics(metricsSnapshot& aSnapshot) const;                                                            // copies all counters, without locking, see logmetrics.h
+    void setMetricsInterval(uint32_t intervalInMs, subSystemType theSubSystem, loggingLevel theLevel = loggingLevel::Info);        // from now on, output() logs a summary of the metrics every interval, as an item of this subSystem and level. 0 stops it
+
+    // Each output reads the shared items buffer at its own pace, through its own cursor. An item is only removed when all active outputs are done with it.
+    // So a slow or stalled output does not delay the others, until the items it holds on to fill up the buffer. A lag limit prevents that, at the cost of the items of that output only.
+
+    // A buffer surviving a crash or reset : attach memory which is not cleared at startup, before logging, and after setting up the outputs, eg.
+    // * native : an mmap'd file, see logMappedFile, so the items of a crashed process are output by the next one
+    // * MCU : a section of RAM not initialized by the startup code, eg. static uint8_t logMemory[uLog::attachedBufferSize] __attribute__((section(".noinit"), aligned(8))); on ESP32, RTC_NOINIT_ATTR
+    // Items are written directly into this memory, so it costs nothing extra when logging. A header with magic, version and checksum tells if the memory holds items from a previous run.
+    // Deferred items of a previous run lose their format, as it may point to code which is no longer the same, and are output as a fixed text.
+
+    // Flight recorder, eg. setFlightRecorder(loggingLevel::Debug, loggingLevel::Error, 32) with the outputs at Info : Debug items of logDeferred() cost about what Info items cost, as they are stored but not formatted,
+    // and an Error is preceded by the last 32 Debug items, on the outputs the Error goes to. Requires recorderSize > 0 in the configuration.
+    // Items of snprintf() are formatted before they are recorded, as snprintf() accepts any format, eg. one in a buffer on the stack.
+
+    // ------------------------------
+    // background output
+    // ------------------------------
+    bool startWriter(uint32_t pollIntervalInMs = 10U);        // from now on, a dedicated thread / task does the output, so output() and snprintf() never wait for a slow output. Returns false if the platform has no threads
+    void stopWriter();                                        // back to output on the calling task
 
     // ------------------------------
     // logging services
     // ------------------------------
-    void log(subSystem theSubSystem, loggingLevel theLevel, const char* aText);                   // appends msg to loggingBuffer whithout trying to output immediately
-    void output(subSystem theSubSystem, loggingLevel theLevel, const char* aText);                // appends msg and tries to output immediately - this output may be blocking
-    void snprintf(subSystem theSubSystem, loggingLevel theLevel, const char* format, ...);        // does a printf() style of output to the logBuffer. It will truncate the output according to the space available in the logBuffer
-    void flush();                                                                                 // outputs everything already in the buffer
+    void log(subSystemType theSubSystem, loggingLevel theLevel, const char* aText);                   // appends msg to loggingBuffer whithout trying to output immediately
+    void output(subSystemType theSubSystem, loggingLevel theLevel, const char* aText);                // appends msg and tries to output immediately - this output may be blocking, unless the writer is running
+    template <typename... argTypes>
+    void snprintf(subSystemType theSubSystem, loggingLevel theLevel, const char* format, argTypes... args) {        // does a printf() style of output to the logBuffer, with the built-in conversions of logconvert.h rather than vsnprintf(). Args of an unsupported type do not compile. It will truncate the output according to the space available in the logBuffer
+        bool recorded = !checkLoggingLevel(theSubSystem, theLevel);
+        if (recorded && !recorder.isRecorded(theLevel)) {
+            metrics.count(theSubSystem, logCounter::filtered);
+        } else {
+            char packed[maxItemLength + 2U];        // args as logDeferred() stores them, so both share one formatter. Room for the type and terminating zero, so a single string can fill the line
+            uint32_t packedLength = logArgs::pack(packed, sizeof(packed), args...);
+            char buffer[maxItemLength];        // not initialized for performance
+            uint32_t length = logArgs::render(buffer, maxItemLength, format, packed, packedLength);
+            if ((length + 1U) >= maxItemLength) {        // filled the buffer, so most likely truncated
+                metrics.count(theSubSystem, logCounter::truncated);
+            }
+            if (recorded) {
+                storeText(theSubSystem, theLevel, buffer, length, true);        // formatted now, as format may not outlive this call
+            } else {
+                output(theSubSystem, theLevel, buffer);
+            }
+        }
+    }
+    void flush();                                                                                     // outputs everything already in the buffer
+    bool isEnabled(subSystemType theSubSystem, loggingLevel theLevel) const;                          // is any output, or the flight recorder, interested in items of this subSystem and level. One load and compare, to guard code which only prepares what is logged, see also ULOG_IS_ENABLED in logfilter.h
+
+    template <typename callableType, typename = decltype(std::declval<callableType&>()(static_cast<char*>(nullptr), 0U))>
+    void log(subSystemType theSubSystem, loggingLevel theLevel, callableType makeText) {        // appends the text makeText(char* buffer, uint32_t bufferLength) writes into buffer, zero terminated. It is only called when isEnabled(), eg. log(subSystem::nfc, loggingLevel::Debug, [&](char* buffer, uint32_t length) { toHex(frame, buffer, length); })
+        if (!isEnabled(theSubSystem, theLevel)) {
+            metrics.count(theSubSystem, logCounter::filtered);
+        } else {
+            char buffer[maxItemLength];        // not initialized for performance
+            buffer[0] = 0;
+            makeText(buffer, static_cast<uint32_t>(maxItemLength));
+            buffer[maxItemLength - 1U] = 0;        // in case makeText did not terminate it
+            log(theSubSystem, theLevel, static_cast<const char*>(buffer));
+        }
+    }
+
+    template <typename... valueTypes>
+    void log(subSystemType theSubSystem, loggingLevel theLevel, const char* message, logField<valueTypes>... fields) {        // appends a structured item : a message with typed key / value fields, eg. log(subSystem::networkData, loggingLevel::Info, "joined", kv("rssi", -71)). Nothing is formatted, each output renders them in its encoding, see logfields.h
+        bool recorded = !checkLoggingLevel(theSubSystem, theLevel);
+        if (recorded && !recorder.isRecorded(theLevel)) {
+            metrics.count(theSubSystem, logCounter::filtered);
+        } else if (recorded || !limiter.isActive() || isAdmittedDeferred(theSubSystem, theLevel, nullptr, message, fields...)) {
+            uint32_t position;
+            uint32_t bufferIndex;
+            logItem* anItem = newPackedItem(position, bufferIndex, theSubSystem, theLevel, recorded, message, fields...);
+            if (anItem != nullptr) {
+                anItem->structured = true;
+                publishItem(position, bufferIndex);
+            }
+        }
+    }
+    template <typename... argTypes>
+    void logDeferred(subSystemType theSubSystem, loggingLevel theLevel, const char* format, argTypes... args) {        // appends a printf() style msg to the buffer without formatting it : only the format pointer and the raw args are stored. Formatting is done by output() / flush()
+        if (!checkLoggingLevel(theSubSystem, theLevel)) {
+            if (recorder.isRecorded(theLevel)) {
+                recordDeferred(theSubSystem, theLevel, format, false, args...);
+            } else {
+                metrics.count(theSubSystem, logCounter::filtered);
+            }
+        } else if (!limiter.isActive() || isAdmittedDeferred(theSubSystem, theLevel, format, args...)) {
+            storeDeferred(theSubSystem, theLevel, format, false, args...);
+        }
+    }
+    template <typename... argTypes>
+    void logDeferred(subSystemType theSubSystem, loggingLevel theLevel, const logFormat& format, argTypes... args) {        // same, for an interned format, see logformat.h : a binary output then gets its ID without hashing the format
+        if (!checkLoggingLevel(theSubSystem, theLevel)) {
+            if (recorder.isRecorded(theLevel)) {
+                recordDeferred(theSubSystem, theLevel, &format, true, args...);
+            } else {
+                metrics.count(theSubSystem, logCounter::filtered);
+            }
+        } else if (!limiter.isActive() || isAdmittedDeferred(theSubSystem, theLevel, format.text, args...)) {
+            storeDeferred(theSubSystem, theLevel, &format, true, args...);
+        }
+    }
 
     // ----------------------------------
     // internal data and helper functions
@@ -69,23 +243,1184 @@ class uLog {
 #ifndef unitTest
   private:
 #endif
-    bool checkLoggingLevel(subSystem theSubSystem, loggingLevel itemLoggingLevel) const;                              // check if this msg needs to be logged, comparing msg level vs logger level
-    bool checkLoggingLevel(uint32_t outputIndex, subSystem theSubSystem, loggingLevel itemLoggingLevel) const;        // check if this msg needs to be sent to this output, comparing msg level vs logger level
-    bool checkLoggingLevel(uint32_t outputIndex, logItem anItem) const;                                               // check if this output wants this msg, based upon it's loggingLevel
-    bool (*getTime)(char*, uint32_t){nullptr};                                                                        // pointer to function returning timestamp as a string
+    bool checkLoggingLevel(subSystemType theSubSystem, loggingLevel itemLoggingLevel) const;                              // check if this msg needs to be logged, comparing msg level vs logger level
+    bool checkLoggingLevel(uint32_t outputIndex, subSystemType theSubSystem, loggingLevel itemLoggingLevel) const;        // check if this msg needs to be sent to this output, comparing msg level vs logger level
+    bool checkLoggingLevel(uint32_t outputIndex, const logItem& anItem) const;                                            // check if this output wants this msg, based upon it's loggingLevel
+    bool (*getTime)(char*, uint32_t){nullptr};                                                                            // pointer to function returning timestamp as a string
+    uint64_t (*getTick)(){nullptr};                                                                                       // pointer to function returning timestamp as a raw tick
+    const char* (*getSubSystemName)(subSystemType){nullptr};                                                              // pointer to function returning the name of a subSystem
+    logTimestamp timestamps;                                                                                              // formats the ticks, only used by the consumer
+
+    static constexpr uint32_t cacheLineSize = 64U;                                                                                                              //
+    struct alignas(cacheLineSize) outputMaskTable {                                                                                                             // one generation of outputMasks, starting on a cache line of its own, so the table in use does not share one with the table being recalculated
+        std::atomic<uint8_t> masks[static_cast<uint8_t>(subSystemType::nmbrOfSubsystems)][static_cast<uint8_t>(loggingLevel::nmbrLoggingLevels)];        // for each subSystem and loggingLevel, one bit per output that wants such items
+    };
+    outputMaskTable outputMasks[2]{};                                                                                                                           // two tables : one in use, one being recalculated
+    std::atomic<uint32_t> levelsGeneration{0};                                                                                                                  // its lowest bit selects the outputMasks table in use
+    std::atomic_flag publishingLevels = ATOMIC_FLAG_INIT;                                                                                                       // serializes changing the outputs and publishing them as outputMasks, see lockLevels()
+    void lockLevels();                                                                                                                                          // taken by all configurers, around changing the outputs and updateOutputMasks()
+    void unlockLevels();                                                                                                                                        //
+    void updateOutputMasks();                                                                                                                                   // recalculates outputMasks, after any change to the outputs, and publishes them. Only with the levels locked
+    uint8_t outputMask(subSystemType theSubSystem, loggingLevel itemLoggingLevel) const;                                                                        // the outputs wanting items of this subSystem and loggingLevel
 
-    logOutput outputs[maxNmbrOutputs];        // create a number of outputs, eg 2, one for serial, and one for network
-    logItem items[length];                    // create an array of items to be logged
-    uint32_t head{0};                         // readIndex of the items circular buffer
-    uint32_t level{0};                        // filling level of the items circular buffer
+    logOutput outputs[maxNmbrOutputs];                  // create a number of outputs, eg 2, one for serial, and one for network
+    logArena<bufferSize, !externalBuffer> items;        // lock-free circular buffer of items to be logged, can be written from multiple tasks / ISRs
+    std::atomic<uint32_t> droppedItems{0};              // number of items lost because the buffer was full
+    uint32_t recoveredItems{0};                         // number of items of a previous run found by attachBuffer()
+    bool isValidItem(uint32_t position);                // checks an item of a previous run
+    std::atomic<bool> outputRequested{false};           // set by output() when it may have to be done by the task already outputting
+    overflowPolicy theOverflowPolicy{overflowPolicy::dropOldest};
+    uint32_t sampleRate{10U};
+    std::atomic<uint32_t> overflowCount{0};        // number of items which did not fit, used for sampling
 
-    char contents[logItem::maxItemLength];        // in this cstring we will format the final contents for each output
-    void format(uint32_t outputIndex);
+    static constexpr uint32_t lineSize = maxItemLength + 1U;                             // room for one formatted item, including its terminating zero
+    char batch[batchSize * lineSize];                                                    // the items of one write, formatted. Item n of the batch is at batch + (n * lineSize)
+    logSpan spans[batchSize];                                                            // describes the items of one write
+    uint32_t linePositions[batchSize];                                                   // for each line in batch, the position of its item
+    uint32_t lineLengths[batchSize];                                                     // for each line in batch, its length, 0 when it holds no formatted item
+    uint32_t cursors[maxNmbrOutputs]{0};                                                 // for each output, the position of the oldest item it did not get yet. Only the consumer uses them
+    std::atomic<uint32_t> laggedItems[maxNmbrOutputs]{};                                 // for each output, the number of items it skipped because it lagged too far
+    uint32_t format(uint32_t outputIndex, const logItem& anItem, char* contents);        // formats the item for this output into contents, which needs room for lineSize chars. Returns the length of the result
+    static uint32_t append(char* contents, uint32_t length, const char* text);           // copies text to contents + length, returns the new length
+    uint32_t formatBinary(const logItem& anItem, char* contents);                        // encodes the item as a binary frame into contents, which needs room for lineSize chars. Returns the length of the frame, including its delimiter
+    uint32_t formatFields(uint32_t outputIndex, const logItem& anItem, char* contents);        // formats the item as logfmt or json for this output into contents, which needs room for lineSize chars. Returns the length of the result
+    bool isSameFormat(uint32_t outputIndex, uint32_t otherOutputIndex) const;            // do both outputs get the same lines, so they can share them
 
-    uint32_t pushItem();        // returns index of position where to write new item data..
+    logItem* item(uint32_t position);                                                                                                                                    // the item stored at position in the buffer
+    logItem* newItem(uint32_t& position, uint32_t& bufferIndex, subSystemType theSubSystem, loggingLevel theLevel, uint32_t contentsSize, bool recorded = false);        // reserves a new item in the staging buffer of this task, or in the shared buffer when staging is disabled, or in the flight recorder when recorded, and sets its subSystem, loggingLevel and timestamp. Returns nullptr if the item must be dropped
+    void storeText(subSystemType theSubSystem, loggingLevel theLevel, const char* aText, uint32_t textLength, bool recorded);                                            // stores a text item, see log()
+    void publishItem(uint32_t position, uint32_t bufferIndex);                                                                                                           // makes the item visible for output()
+    bool pushItem(uint32_t& position, uint32_t itemSize);                                                                                                                // reserves position where to write new item data. When full, applies the overflowPolicy. Returns false if the item must be dropped
+    bool discardOldest(uint32_t itemSize, uint32_t& position);                                                                                                           // discards the oldest items until the new one fits
     void popItem();
-    void output();                                           // send to one or more outputs
+    template <typename... argTypes>
+    logItem* newPackedItem(uint32_t& position, uint32_t& bufferIndex, subSystemType theSubSystem, loggingLevel theLevel, bool recorded, argTypes... args) {        // reserves a new item and packs args as its contents, see newItem()
+        uint32_t argsLength = logArgs::packedLength(args...);
+        bool truncated      = (argsLength > maxItemLength);
+        if (truncated) {
+            argsLength = maxItemLength;        // args not fitting are dropped
+        }
+        logItem* anItem = newItem(position, bufferIndex, theSubSystem, theLevel, argsLength, recorded);
+        if (anItem != nullptr) {
+            if (truncated) {
+                metrics.count(theSubSystem, logCounter::truncated);
+            }
+            anItem->contentsSize = logArgs::pack(anItem->contents(), argsLength, args...);
+        }
+        return anItem;
+    }
+    template <typename... argTypes>
+    void storeDeferred(subSystemType theSubSystem, loggingLevel theLevel, const void* format, bool internedFormat, argTypes... args) {        // stores a deferred item, see logDeferred()
+        uint32_t position;
+        uint32_t bufferIndex;
+        logItem* anItem = newPackedItem(position, bufferIndex, theSubSystem, theLevel, false, args...);
+        if (anItem != nullptr) {
+            anItem->format         = format;
+            anItem->internedFormat = internedFormat;
+            publishItem(position, bufferIndex);
+        }
+    }
+    template <typename... argTypes>
+    void recordDeferred(subSystemType theSubSystem, loggingLevel theLevel, const void* format, bool internedFormat, argTypes... args) {        // keeps a deferred item no output wants in the flight recorder
+        uint32_t position;
+        uint32_t bufferIndex;
+        logItem* anItem = newPackedItem(position, bufferIndex, theSubSystem, theLevel, true, args...);
+        if (anItem != nullptr) {
+            anItem->format         = format;
+            anItem->internedFormat = internedFormat;
+            publishItem(position, bufferIndex);
+        }
+    }
+
+    logLimiter<static_cast<uint8_t>(subSystemType::nmbrOfSubsystems), rateLimiting> limiter;          // rate limits and duplicate suppression
+    std::atomic<uint32_t> rateLimitedItems{0};                                                        // number of items dropped by the rate limits
+    std::atomic<uint32_t> lastSummaries{0};                                                           // logMicroseconds() of the last logSummaries()
+    static constexpr uint32_t summaryInterval{1000000U};                                              // in us, so a flood of duplicates through output() is not summarized item per item
+    bool isAdmitted(subSystemType theSubSystem, loggingLevel theLevel, uint32_t contentsHash);        // applies the limiter, logging the summary of what it held back before. Returns false when the item must be dropped
+    void logSummaries(bool always);                                                                   // logs the summaries of the items held back by the limiter, at most once per summaryInterval, unless always
+
+    logMetrics<subSystemType, maxNmbrOutputs, collectMetrics> metrics;        // counters, see logmetrics.h
+    std::atomic<uint32_t> metricsInterval{0};                                 // in us, 0 when the metrics are not logged
+    static constexpr uint32_t maxMetricsInterval{2000000U};                   // in ms, so the interval fits the 32 bit microsecond clock
+    std::atomic<uint32_t> lastMetrics{0};                                     // logMicroseconds() of the last logMetricsSummary()
+    subSystemType metricsSubSystem{};                                         // of the metrics summary item
+    loggingLevel metricsLevel{loggingLevel::Info};                            //
+    void logMetricsSummary();                                                 // logs a summary of the metrics, when the metricsInterval passed
+    template <typename... argTypes>
+    bool isAdmittedDeferred(subSystemType theSubSystem, loggingLevel theLevel, const char* format, argTypes... args) {
+        uint32_t contentsHash{0};
+        if (limiter.isSuppressingDuplicates()) {        // deferred items are the same when their format and args are the same
+            char packed[maxItemLength];
+            uint32_t packedLength = logArgs::pack(packed, maxItemLength, args...);
+            contentsHash          = limiter.hash(limiter.hash(2166136261U, &format, sizeof(format)), packed, packedLength);
+        }
+        return isAdmitted(theSubSystem, theLevel, contentsHash);
+    }
+
+    static constexpr uint32_t sharedBuffer   = UINT32_MAX;                                  // bufferIndex of an item in items rather than in a staging buffer
+    static constexpr uint32_t recorderBuffer = UINT32_MAX - 1U;                             // bufferIndex of an item in the flight recorder
+    logRecorder<recorderSize> recorder;                                                     // items no output wants, see setFlightRecorder()
+    void dumpRecorder(subSystemType theSubSystem, loggingLevel theLevel);                   // copies the last recorded items to items, for the outputs wanting an item of this subSystem and level
+    logStaging<nmbrStagingBuffers, stagingBufferSize> staging;                              // per thread / core buffers, merged into items by the consumer
+    bool reserveStaged(uint32_t bufferIndex, uint32_t itemSize, uint32_t& position);        // reserves room in a staging buffer. When it is full, its items are merged first. If that is not possible, the item is dropped, or with overflowPolicy::block, waits
+    bool mergeStagingBuffers();                                                             // moves items from the staging buffers to items, oldest tick first, as long as there is room. Returns true when it moved any item. Requires the consumer role
+    void output();                                                                                                           // send to one or more outputs
+    bool outputBatch();                                                                                                      // sends each output the next items it wants, and removes the ones all outputs are done with. Returns false when no cursor moved
+    bool outputItems(uint32_t outputIndex);                                                                                  // sends this output up to batchSize items it wants, from its cursor on. Returns true when its cursor moved
+    uint32_t line(uint32_t position, uint32_t outputIndex, const logItem& anItem, uint32_t& usedLines);                     // index of the line in batch holding the item at position, formatting it unless an output with the same format already did
+    void applyLagLimit(uint32_t outputIndex);                                                                                // moves the cursor of an output lagging too far, according to its lagPolicy
+    bool releaseItems();                                                                                                     // removes the items all active outputs are done with. Returns true when any was removed
     void addColorOutputPrefix(loggingLevel theLevel);        // add color output escape codes
     void addColorOutputPostfix();                            // add color output escape codes
     void addLevel(loggingLevel theLoggingLevel);
+
+    static void writerFunction(void* aLog);        // work done by the writer
+    logWriter writer;                              // last member, so at destruction the writer stops before anything it uses is gone
 };
+
+typedef basicLog<logConfig> uLog;        // uLog with the default configuration
+
+template <typename config>
+constexpr uint32_t basicLog<config>::maxNmbrOutputs;
+template <typename config>
+constexpr uint32_t basicLog<config>::bufferSize;
+template <typename config>
+constexpr uint32_t basicLog<config>::maxItemLength;
+template <typename config>
+constexpr uint32_t basicLog<config>::batchSize;
+template <typename config>
+constexpr uint32_t basicLog<config>::lineSize;
+template <typename config>
+constexpr uint32_t basicLog<config>::attachedBufferSize;
+
+template <typename config>
+basicLog<config>::basicLog() {
+    lockLevels();
+    updateOutputMasks();
+    unlockLevels();
+}
+
+template <typename config>
+void basicLog<config>::lockLevels() {
+    while (publishingLevels.test_and_set(std::memory_order_acquire)) {        // configuring is rare, so a spin lock will do
+    }
+}
+
+template <typename config>
+void basicLog<config>::unlockLevels() {
+    publishingLevels.clear(std::memory_order_release);
+}
+
+template <typename config>
+void basicLog<config>::updateOutputMasks() {
+    uint32_t nextGeneration = levelsGeneration.load(std::memory_order_relaxed) + 1U;
+    for (uint8_t subSystemIndex = 0; subSystemIndex < static_cast<uint8_t>(subSystemType::nmbrOfSubsystems); subSystemIndex++) {
+        for (uint8_t levelIndex = 0; levelIndex < static_cast<uint8_t>(loggingLevel::nmbrLoggingLevels); levelIndex++) {
+            uint8_t mask{0};
+            for (uint32_t outputIndex = 0; outputIndex < maxNmbrOutputs; outputIndex++) {        // for all outputs
+                if (outputs[outputIndex].isActive() && (static_cast<loggingLevel>(levelIndex) <= outputs[outputIndex].getLoggingLevel(static_cast<subSystemType>(subSystemIndex)))) {
+                    mask |= (1U << outputIndex);
+                }
+            }
+            outputMasks[nextGeneration & 1U].masks[subSystemIndex][levelIndex].store(mask, std::memory_order_relaxed);        // the table not in use, so producers don't see it half done
+        }
+    }
+    levelsGeneration.store(nextGeneration, std::memory_order_release);        // switches all producers to the new table at once
+}
+
+template <typename config>
+uint8_t basicLog<config>::outputMask(subSystemType theSubSystem, loggingLevel itemLoggingLevel) const {
+    // The acquire pairs with the release in updateOutputMasks(), so a producer reads the table of the generation it loaded as it was published, never half updated.
+    // Only a producer preempted between both loads for as long as two publications take can find that table being recalculated again. Even then, the mask is a single atomic, so it is the one of that generation or of the next :
+    // the item is filtered as if it was logged just before or just after the change, never by a mix of both. Producers take no lock, and on a single core MCU the acquire costs a barrier, no more
+    return outputMasks[levelsGeneration.load(std::memory_order_acquire) & 1U].masks[static_cast<uint8_t>(theSubSystem)][static_cast<uint8_t>(itemLoggingLevel)].load(std::memory_order_relaxed);
+}
+
+template <typename config>
+bool basicLog<config>::isEnabled(subSystemType theSubSystem, loggingLevel itemLoggingLevel) const {
+    return checkLoggingLevel(theSubSystem, itemLoggingLevel) || recorder.isRecorded(itemLoggingLevel);
+}
+
+template <typename config>
+bool basicLog<config>::checkLoggingLevel(subSystemType theSubSystem, loggingLevel itemLoggingLevel) const {
+    return (outputMask(theSubSystem, itemLoggingLevel) != 0);        // is any output interested
+}
+
+template <typename config>
+bool basicLog<config>::checkLoggingLevel(uint32_t outputIndex, subSystemType theSubSystem, loggingLevel itemLoggingLevel) const {
+    if (outputIndex < maxNmbrOutputs) {
+        return ((outputMask(theSubSystem, itemLoggingLevel) & (1U << outputIndex)) != 0);
+    }
+    return false;
+}
+
+template <typename config>
+bool basicLog<config>::checkLoggingLevel(uint32_t outputIndex, const logItem &anItem) const {
+    return ((anItem.dumpedTo & (1U << outputIndex)) != 0) || checkLoggingLevel(outputIndex, anItem.theSubSystem, anItem.theLoggingLevel);        // items of the flight recorder go to the outputs of the item which dumped them
+}
+
+template <typename config>
+void basicLog<config>::log(subSystemType theSubSystem, loggingLevel itemLoggingLevel, const char *aText) {
+    if (!checkLoggingLevel(theSubSystem, itemLoggingLevel)) {        // if any output is interested in this item, we store it in the buffer
+        if (recorder.isRecorded(itemLoggingLevel)) {
+            storeText(theSubSystem, itemLoggingLevel, aText, strnlen(aText, maxItemLength - 1U), true);
+        } else {
+            metrics.count(theSubSystem, logCounter::filtered);
+        }
+    } else {
+        uint32_t textLength = strnlen(aText, maxItemLength - 1U);
+        if (limiter.isActive() && !isAdmitted(theSubSystem, itemLoggingLevel, limiter.isSuppressingDuplicates() ? limiter.hash(2166136261U, aText, textLength) : 0U)) {
+            return;
+        }
+        storeText(theSubSystem, itemLoggingLevel, aText, textLength, false);
+    }
+}
+
+template <typename config>
+void basicLog<config>::storeText(subSystemType theSubSystem, loggingLevel itemLoggingLevel, const char *aText, uint32_t textLength, bool recorded) {
+    uint32_t position;
+    uint32_t bufferIndex;
+    logItem *anItem = newItem(position, bufferIndex, theSubSystem, itemLoggingLevel, textLength + 1U, recorded);
+    if (anItem != nullptr) {
+        memcpy(anItem->contents(), aText, textLength);
+        anItem->contents()[textLength] = 0;
+        if (aText[textLength] != 0) {
+            metrics.count(theSubSystem, logCounter::truncated);
+        }
+        publishItem(position, bufferIndex);        // only now the item becomes visible for output()
+    }
+}
+
+template <typename config>
+typename basicLog<config>::logItem *basicLog<config>::item(uint32_t position) {
+    return reinterpret_cast<logItem *>(items.payload(position));
+}
+
+template <typename config>
+typename basicLog<config>::logItem *basicLog<config>::newItem(uint32_t &position, uint32_t &bufferIndex, subSystemType theSubSystem, loggingLevel itemLoggingLevel, uint32_t contentsSize, bool recorded) {
+    if (!recorded && recorder.isTrigger(itemLoggingLevel)) {
+        dumpRecorder(theSubSystem, itemLoggingLevel);        // before this item, so the context comes first
+    }
+    char timestamp[logItem::timestampLength + 1U];
+    uint32_t timestampSize;
+    bool tickTimestamp = (getTick != nullptr);
+    if (tickTimestamp) {
+        uint64_t tick = getTick();
+        memcpy(timestamp, &tick, sizeof(tick));        // only the raw tick is stored, it is formatted at output time
+        timestampSize = sizeof(tick);
+    } else {
+        if ((getTime == nullptr) || !getTime(timestamp, logItem::timestampLength)) {
+            timestamp[0] = 0;
+        }
+        timestamp[logItem::timestampLength] = 0;
+        timestampSize                       = strlen(timestamp) + 1U;
+    }
+
+    uint32_t itemSize = logItem::storageLength(timestampSize, contentsSize);
+    logItem *anItem;
+    if (recorded) {
+        if (!recorder.reserve(itemSize, position)) {
+            return nullptr;        // it was only context, so it is not counted as dropped
+        }
+        bufferIndex = recorderBuffer;
+        anItem      = reinterpret_cast<logItem *>(recorder.payload(position));
+    } else if (nmbrStagingBuffers > 0) {
+        bufferIndex = logStaging<nmbrStagingBuffers, stagingBufferSize>::currentIndex();
+        if (!reserveStaged(bufferIndex, itemSize, position)) {
+            droppedItems++;
+            metrics.count(theSubSystem, logCounter::dropped);
+            return nullptr;
+        }
+        anItem = reinterpret_cast<logItem *>(staging.buffer(bufferIndex)->payload(position));
+    } else {
+        if (!pushItem(position, itemSize)) {
+            metrics.count(theSubSystem, logCounter::dropped);
+            return nullptr;
+        }
+        metrics.updateHighWaterMark(items.level());
+        bufferIndex = sharedBuffer;
+        anItem      = item(position);
+    }
+    metrics.count(theSubSystem, recorded ? logCounter::recorded : logCounter::logged);
+    anItem->loggedAt        = metrics.now();
+    anItem->format          = nullptr;
+    anItem->internedFormat  = false;
+    anItem->structured      = false;
+    anItem->dumpedTo        = 0;
+    anItem->timestampSize   = timestampSize;
+    anItem->tickTimestamp   = tickTimestamp;
+    anItem->contentsSize    = contentsSize;
+    anItem->theLoggingLevel = itemLoggingLevel;
+    anItem->theSubSystem    = theSubSystem;
+    memcpy(anItem->timestamp(), timestamp, timestampSize);
+    return anItem;
+}
+
+template <typename config>
+void basicLog<config>::publishItem(uint32_t position, uint32_t bufferIndex) {
+    if (bufferIndex == sharedBuffer) {
+        items.publish(position);
+    } else if (bufferIndex == recorderBuffer) {
+        recorder.publish(position);
+    } else {
+        staging.buffer(bufferIndex)->publish(position);
+    }
+}
+
+template <typename config>
+void basicLog<config>::dumpRecorder(subSystemType theSubSystem, loggingLevel itemLoggingLevel) {
+    uint8_t dumpedTo = outputMask(theSubSystem, itemLoggingLevel);
+    recorder.dump([this, dumpedTo](const uint8_t *record, uint32_t recordLength) {
+        uint32_t position;
+        if (pushItem(position, recordLength)) {        // straight to the shared buffer, as staging would merge them after the items of other tasks
+            memcpy(items.payload(position), record, recordLength);        // items only hold relative references, so they can be moved
+            logItem *anItem  = item(position);
+            anItem->dumpedTo = dumpedTo;
+            anItem->loggedAt = metrics.now();        // latency of the output, not of the time spent in the recorder
+            items.publish(position);
+            metrics.updateHighWaterMark(items.level());
+        } else {
+            metrics.count(reinterpret_cast<const logItem *>(record)->theSubSystem, logCounter::dropped);
+        }
+    });
+}
+
+template <typename config>
+bool basicLog<config>::reserveStaged(uint32_t bufferIndex, uint32_t itemSize, uint32_t &position) {
+    while (!staging.buffer(bufferIndex)->reserve(itemSize, position)) {
+        if (items.acquireConsumer()) {        // staging buffer is full : move its items to the shared buffer, unless another task is busy doing so
+            mergeStagingBuffers();
+            items.releaseConsumer();
+            if (staging.buffer(bufferIndex)->reserve(itemSize, position)) {
+                return true;
+            }
+        }
+        if (theOverflowPolicy != overflowPolicy::block) {
+            return false;        // storing it in the shared buffer instead would mix up the order of the items of this task
+        }
+        if (writer.isRunning()) {
+            writer.wake();
+        } else {
+            output();
+        }
+        logWriter::yield();
+    }
+    return true;
+}
+
+template <typename config>
+bool basicLog<config>::mergeStagingBuffers() {
+    bool merged{false};
+    while (true) {
+        uint32_t oldestBuffer{sharedBuffer};        // find the staging buffer holding the oldest item
+        uint32_t oldestPosition{0};
+        uint64_t oldestTick{0};
+        for (uint32_t bufferIndex = 0; bufferIndex < nmbrStagingBuffers; bufferIndex++) {
+            uint32_t position;
+            if (staging.buffer(bufferIndex)->peek(position)) {
+                const logItem *anItem = reinterpret_cast<const logItem *>(staging.buffer(bufferIndex)->payload(position));
+                uint64_t tick{0};        // without tick, items are merged one staging buffer after the other
+                if (anItem->tickTimestamp) {
+                    memcpy(&tick, anItem->timestamp(), sizeof(tick));
+                }
+                if ((oldestBuffer == sharedBuffer) || (tick < oldestTick)) {
+                    oldestBuffer   = bufferIndex;
+                    oldestPosition = position;
+                    oldestTick     = tick;
+                }
+            }
+        }
+        if (oldestBuffer == sharedBuffer) {
+            return merged;        // all staging buffers are empty
+        }
+        uint32_t payloadLength = staging.buffer(oldestBuffer)->payloadLength(oldestPosition);
+        uint32_t position;
+        if (!items.reserve(payloadLength, position)) {
+            return merged;        // shared buffer is full, the rest is merged after the next output
+        }
+        memcpy(items.payload(position), staging.buffer(oldestBuffer)->payload(oldestPosition), payloadLength);        // items only hold relative references, so they can be moved
+        items.publish(position);
+        staging.buffer(oldestBuffer)->pop();
+        metrics.updateHighWaterMark(items.level());
+        merged = true;
+    }
+}
+
+template <typename config>
+void basicLog<config>::output(subSystemType theSubSystem, loggingLevel itemLoggingLevel, const char *aText) {
+    log(theSubSystem, itemLoggingLevel, aText);
+    if (writer.isRunning()) {
+        writer.wake();        // writer does the output in the background
+    } else {
+        output();
+    }
+}
+
+template <typename config>
+void basicLog<config>::flush() {
+    logSummaries(true);
+    output();
+}
+
+template <typename config>
+bool basicLog<config>::isAdmitted(subSystemType theSubSystem, loggingLevel itemLoggingLevel, uint32_t contentsHash) {
+    uint8_t subSystemIndex = static_cast<uint8_t>(theSubSystem);
+    if (limiter.isSuppressingDuplicates()) {
+        uint32_t repeated{0};
+        uint8_t repeatedLevel{0};
+        if (limiter.isDuplicate(subSystemIndex, contentsHash ^ static_cast<uint8_t>(itemLoggingLevel), static_cast<uint8_t>(itemLoggingLevel), repeated, repeatedLevel)) {
+            metrics.count(theSubSystem, logCounter::suppressed);
+            return false;        // duplicates don't take tokens of the rate limit
+        }
+        if (repeated > 0) {
+            storeDeferred(theSubSystem, static_cast<loggingLevel>(repeatedLevel), &ULOG_FORMAT("last message repeated %u times"), true, repeated);
+        }
+    }
+    if (!limiter.isAllowed(subSystemIndex)) {
+        rateLimitedItems++;
+        metrics.count(theSubSystem, logCounter::rateLimited);
+        return false;
+    }
+    uint32_t rejected = limiter.takeRejected(subSystemIndex);
+    if (rejected > 0) {
+        storeDeferred(theSubSystem, loggingLevel::Warning, &ULOG_FORMAT("%u items dropped by the rate limit"), true, rejected);
+    }
+    return true;
+}
+
+template <typename config>
+void basicLog<config>::logSummaries(bool always) {
+    if (!limiter.isActive()) {
+        return;
+    }
+    uint32_t now = logMicroseconds();
+    if (!always && ((now - lastSummaries.load(std::memory_order_relaxed)) < summaryInterval)) {
+        return;
+    }
+    lastSummaries.store(now, std::memory_order_relaxed);
+    for (uint8_t subSystemIndex = 0; subSystemIndex < static_cast<uint8_t>(subSystemType::nmbrOfSubsystems); subSystemIndex++) {
+        uint8_t repeatedLevel{0};
+        uint32_t repeated = limiter.takeRepeated(subSystemIndex, repeatedLevel);
+        if (repeated > 0) {
+            storeDeferred(static_cast<subSystemType>(subSystemIndex), static_cast<loggingLevel>(repeatedLevel), &ULOG_FORMAT("last message repeated %u times"), true, repeated);
+        }
+        uint32_t rejected = limiter.takeRejected(subSystemIndex);
+        if (rejected > 0) {
+            storeDeferred(static_cast<subSystemType>(subSystemIndex), loggingLevel::Warning, &ULOG_FORMAT("%u items dropped by the rate limit"), true, rejected);
+        }
+    }
+}
+
+template <typename config>
+void basicLog<config>::logMetricsSummary() {
+    uint32_t interval = metricsInterval.load(std::memory_order_relaxed);
+    uint32_t now      = logMicroseconds();
+    uint32_t last     = lastMetrics.load(std::memory_order_relaxed);
+    if ((interval == 0) || ((now - last) < interval) || !lastMetrics.compare_exchange_strong(last, now)) {
+        return;        // not yet, or another task is logging it
+    }
+    metricsSnapshot aSnapshot;
+    getMetrics(aSnapshot);
+    uint32_t maxLatency{0};
+    for (uint32_t outputIndex = 0; outputIndex < maxNmbrOutputs; outputIndex++) {
+        uint32_t latency = aSnapshot.latencyPercentile(outputIndex, 99U);
+        if (latency > maxLatency) {
+            maxLatency = latency;
+        }
+    }
+    storeDeferred(metricsSubSystem, metricsLevel, &ULOG_FORMAT("metrics log %u flt %u trunc %u drop %u ovw %u lim %u rej %u hwm %u/%u p99 %uus"), true, aSnapshot.total(logCounter::logged), aSnapshot.total(logCounter::filtered), aSnapshot.total(logCounter::truncated), aSnapshot.total(logCounter::dropped), aSnapshot.total(logCounter::overwritten), aSnapshot.total(logCounter::rateLimited), aSnapshot.total(logOutputCounter::rejected), aSnapshot.highWaterMark, aSnapshot.bufferSize, maxLatency);
+}
+
+template <typename config>
+void basicLog<config>::output() {
+    logSummaries(false);        // before taking the consumer role, as logging them may need to wait for room with overflowPolicy::block
+    logMetricsSummary();
+    outputRequested = true;                                     // if another task is already outputting, this makes it do another round, so it also outputs our items
+    while (outputRequested && items.acquireConsumer()) {        // only one task at a time can output
+        outputRequested = false;
+        bool busy{true};
+        while (busy) {        // as long as items get merged or removed, there may be more to output
+            bool merged = (nmbrStagingBuffers > 0) && mergeStagingBuffers();
+            busy        = outputBatch() || merged;
+        }
+        items.releaseConsumer();
+    }
+}
+
+template <typename config>
+bool basicLog<config>::outputBatch() {
+    bool moved{false};
+    uint32_t outputsDone{0};        // one bit per output
+    for (uint32_t outputIndex = 0; outputIndex < maxNmbrOutputs; outputIndex++) {
+        if ((outputsDone & (1U << outputIndex)) != 0) {
+            continue;
+        }
+        for (uint32_t lineIndex = 0; lineIndex < batchSize; lineIndex++) {        // new format, so the lines in batch can't be reused
+            lineLengths[lineIndex] = 0;
+        }
+        for (uint32_t sameFormatIndex = outputIndex; sameFormatIndex < maxNmbrOutputs; sameFormatIndex++) {        // outputs with the same format settings share the formatted lines of the items they both get
+            if (((outputsDone & (1U << sameFormatIndex)) == 0) && isSameFormat(outputIndex, sameFormatIndex)) {
+                outputsDone |= (1U << sameFormatIndex);
+                if (outputs[sameFormatIndex].isActive() && outputItems(sameFormatIndex)) {
+                    moved = true;
+                }
+            }
+        }
+    }
+    bool released = releaseItems();
+    return moved || released;        // when no output accepted anything, we stop and retry at the next output()
+}
+
+template <typename config>
+bool basicLog<config>::outputItems(uint32_t outputIndex) {
+    if ((cursors[outputIndex] - items.readPosition()) > items.level()) {
+        cursors[outputIndex] = items.readPosition();        // the items it did not get yet were discarded, or it was not active before
+    }
+    applyLagLimit(outputIndex);
+    uint32_t start    = cursors[outputIndex];
+    uint32_t position = start;
+    uint32_t spanPositions[batchSize];        // for each span, the position of its item
+    uint32_t nmbrSpans{0};
+    uint32_t usedLines{0};        // one bit per line in batch referred to by spans
+    bool found = items.seek(position);
+    while (found && (nmbrSpans < batchSize)) {
+        const logItem &anItem = *item(position);
+        if (checkLoggingLevel(outputIndex, anItem)) {
+            uint32_t lineIndex               = line(position, outputIndex, anItem, usedLines);
+            spans[nmbrSpans].text            = batch + (lineIndex * lineSize);
+            spans[nmbrSpans].length          = lineLengths[lineIndex];
+            spans[nmbrSpans].theLoggingLevel = anItem.theLoggingLevel;
+            spans[nmbrSpans].theSubSystem    = anItem.theSubSystem;
+            spanPositions[nmbrSpans++]       = position;
+        }
+        found = items.next(position);
+    }
+    uint32_t accepted    = (nmbrSpans > 0) ? outputs[outputIndex].write(spans, nmbrSpans) : 0U;
+    cursors[outputIndex] = (accepted < nmbrSpans) ? spanPositions[accepted] : position;        // items not accepted are retried in the next round
+    if (collectMetrics && (nmbrSpans > 0)) {
+        metrics.count(outputIndex, logOutputCounter::writes);
+        metrics.count(outputIndex, logOutputCounter::delivered, accepted);
+        metrics.count(outputIndex, logOutputCounter::rejected, nmbrSpans - accepted);
+        uint32_t now = metrics.now();
+        for (uint32_t spanIndex = 0; spanIndex < accepted; spanIndex++) {
+            metrics.countLatency(outputIndex, now - item(spanPositions[spanIndex])->loggedAt);
+        }
+    }
+    return (cursors[outputIndex] != start);
+}
+
+template <typename config>
+uint32_t basicLog<config>::line(uint32_t position, uint32_t outputIndex, const logItem &anItem, uint32_t &usedLines) {
+    uint32_t freeLine{batchSize};
+    for (uint32_t lineIndex = 0; lineIndex < batchSize; lineIndex++) {
+        if ((lineLengths[lineIndex] != 0) && (linePositions[lineIndex] == position)) {
+            usedLines |= (1U << lineIndex);
+            return lineIndex;        // already formatted for another output
+        }
+        if (((usedLines & (1U << lineIndex)) == 0) && ((freeLine == batchSize) || ((lineLengths[lineIndex] == 0) && (lineLengths[freeLine] != 0)))) {
+            freeLine = lineIndex;        // an empty line, else the first one not used by this batch. There always is one, as a batch has no more spans than lines
+        }
+    }
+    linePositions[freeLine] = position;
+    lineLengths[freeLine]   = format(outputIndex, anItem, batch + (freeLine * lineSize));
+    usedLines |= (1U << freeLine);
+    return freeLine;
+}
+
+template <typename config>
+void basicLog<config>::applyLagLimit(uint32_t outputIndex) {
+    lagPolicy theLagPolicy = outputs[outputIndex].getLagPolicy();
+    uint32_t maxLag        = outputs[outputIndex].getLagLimit();
+    uint32_t newest        = items.writePosition();
+    uint32_t position      = cursors[outputIndex];
+    if ((theLagPolicy == lagPolicy::hold) || ((newest - position) <= maxLag)) {
+        return;
+    }
+    while (((theLagPolicy == lagPolicy::skipToNewest) || ((newest - position) > maxLag)) && items.seek(position)) {
+        if (checkLoggingLevel(outputIndex, *item(position))) {
+            laggedItems[outputIndex]++;
+        }
+        items.next(position);
+    }
+    cursors[outputIndex] = position;
+}
+
+template <typename config>
+bool basicLog<config>::releaseItems() {
+    uint32_t oldest = items.readPosition();
+    uint32_t level  = items.level();
+    uint32_t done{level};        // number of bytes, from the oldest item on, all active outputs are done with
+    bool anyActive{false};
+    for (uint32_t outputIndex = 0; outputIndex < maxNmbrOutputs; outputIndex++) {
+        if (outputs[outputIndex].isActive()) {
+            uint32_t outputDone = cursors[outputIndex] - oldest;
+            if (outputDone > level) {
+                outputDone = 0;
+            }
+            if (outputDone < done) {
+                done = outputDone;
+            }
+            anyActive = true;
+        }
+    }
+    if (!anyActive || (done == 0)) {
+        return false;        // without outputs, items are kept until one becomes active
+    }
+    items.popUntil(oldest + done);
+    return true;
+}
+
+template <typename config>
+void basicLog<config>::popItem() {
+    uint32_t position;
+    if (items.peek(position)) {
+        items.pop();
+    }
+}
+
+template <typename config>
+bool basicLog<config>::pushItem(uint32_t &position, uint32_t itemSize) {
+    if (items.reserve(itemSize, position)) {
+        return true;
+    }
+    switch (theOverflowPolicy) {        // buffer is full
+        case overflowPolicy::block:
+            while (true) {
+                if (writer.isRunning()) {
+                    writer.wake();
+                } else {
+                    output();        // make room ourselves. If another task is busy outputting, it does so for us
+                }
+                if (items.reserve(itemSize, position)) {
+                    return true;
+                }
+                logWriter::yield();
+            }
+            break;
+
+        case overflowPolicy::sample:
+            if ((overflowCount++ % sampleRate) != 0) {
+                break;        // not sampled, so dropped
+            }
+            // fall through - this one is sampled, so it is kept as with dropOldest
+        case overflowPolicy::dropOldest:
+            if (discardOldest(itemSize, position)) {
+                return true;
+            }
+            break;
+
+        case overflowPolicy::dropNewest:
+        default:
+            break;
+    }
+    droppedItems++;        // no room, so the new item is dropped
+    return false;
+}
+
+template <typename config>
+bool basicLog<config>::discardOldest(uint32_t itemSize, uint32_t &position) {
+    bool reserved{false};
+    if (items.acquireConsumer()) {        // only possible if no other task is busy outputting the oldest items
+        uint32_t oldest;
+        while (!reserved && items.peek(oldest)) {
+            metrics.count(item(oldest)->theSubSystem, logCounter::overwritten);
+            popItem();
+            droppedItems++;
+            reserved = items.reserve(itemSize, position);
+        }
+        items.releaseConsumer();
+    }
+    return reserved;
+}
+
+template <typename config>
+uint32_t basicLog<config>::append(char *contents, uint32_t length, const char *text) {
+    uint32_t textLength = strlen(text);
+    memcpy(contents + length, text, textLength);
+    return length + textLength;
+}
+
+template <typename config>
+bool basicLog<config>::isSameFormat(uint32_t outputIndex, uint32_t otherOutputIndex) const {
+    logEncoding theEncoding = outputs[outputIndex].getEncoding();
+    if (theEncoding != outputs[otherOutputIndex].getEncoding()) {
+        return false;
+    }
+    switch (theEncoding) {
+        case logEncoding::binary:
+            return true;        // binary frames do not depend on the other settings
+        case logEncoding::logfmt:
+        case logEncoding::json:
+            return (outputs[outputIndex].hasTimestampIncluded() == outputs[otherOutputIndex].hasTimestampIncluded());        // never colored
+        case logEncoding::text:
+        default:
+            return (outputs[outputIndex].isColoredOutput() == outputs[otherOutputIndex].isColoredOutput()) && (outputs[outputIndex].hasTimestampIncluded() == outputs[otherOutputIndex].hasTimestampIncluded());
+    }
+}
+
+template <typename config>
+uint32_t basicLog<config>::format(uint32_t outputIndex, const logItem &anItem, char *contents) {        // builds the line in one pass, keeping track of its length, so nothing is scanned twice
+    switch (outputs[outputIndex].getEncoding()) {
+        case logEncoding::binary:
+            return formatBinary(anItem, contents);
+        case logEncoding::logfmt:
+        case logEncoding::json:
+            return formatFields(outputIndex, anItem, contents);
+        case logEncoding::text:
+        default:
+            break;
+    }
+    uint32_t length{0};
+    bool colored = outputs[outputIndex].isColoredOutput();
+    if (colored) {
+        length = append(contents, length, colorPrefix(anItem.theLoggingLevel));
+    }
+    if (outputs[outputIndex].hasTimestampIncluded()) {
+        if (anItem.tickTimestamp) {
+            uint64_t tick;
+            memcpy(&tick, anItem.timestamp(), sizeof(tick));        // memcpy as the timestamp has no alignment
+            length += timestamps.format(tick, contents + length);
+        } else {
+            memcpy(contents + length, anItem.timestamp(), anItem.timestampSize - 1U);        // timestampSize includes the terminating zero
+            length += anItem.timestampSize - 1U;
+        }
+        contents[length++] = ' ';
+    }
+    length = append(contents, length, toStringShort(anItem.theLoggingLevel));
+
+    // TODO show trunctation with trailing...
+
+    uint32_t room = maxItemLength - (length + (colored ? 5U : 1U));        // keep room for color postfix and newline
+    if (anItem.format != nullptr) {
+        length += logArgs::render(contents + length, room + 1U, anItem.formatText(), anItem.contents(), anItem.contentsSize);        // deferred item : format it now
+    } else if (anItem.structured) {
+        const char* message;
+        uint32_t messageLength;
+        uint32_t fieldsStart = logLineWriter::message(anItem.contents(), anItem.contentsSize, message, messageLength);
+        logLineWriter aLine(contents, length, length + room, logEncoding::text);
+        aLine.addText(message, messageLength);
+        aLine.addFields(anItem.contents() + fieldsStart, anItem.contentsSize - fieldsStart);
+        length = aLine.length();
+    } else {
+        uint32_t textLength = anItem.contentsSize - 1U;        // contentsSize includes the terminating zero
+        if (textLength > room) {
+            textLength = room;
+        }
+        memcpy(contents + length, anItem.contents(), textLength);        // add raw contents
+        length += textLength;
+    }
+    if (colored) {
+        length = append(contents, length, colorPostfix());
+    }
+    contents[length++] = '\n';        // final newLine
+    contents[length]   = 0;
+    return length;
+}
+
+template <typename config>
+uint32_t basicLog<config>::formatBinary(const logItem &anItem, char *contents) {
+    static constexpr uint32_t maxFrameLength = lineSize - 3U;        // so the encoded frame, with its delimiter, fits in lineSize
+    static_assert(logBinary::encodedLength(maxFrameLength) <= lineSize, "a binary frame must fit in a line");
+    static_assert((logBinary::maxHeaderLength + logItem::timestampLength + 1U) < maxFrameLength, "a binary frame needs room for its header");
+    uint8_t frame[maxFrameLength];
+    uint32_t length{1};        // flags are written last
+    logBinary::timestampType theTimestampType{logBinary::timestampType::none};
+    if (anItem.tickTimestamp) {
+        uint64_t tick;
+        memcpy(&tick, anItem.timestamp(), sizeof(tick));        // memcpy as the timestamp has no alignment
+        length += logBinary::putVarint(frame + length, tick);
+        theTimestampType = logBinary::timestampType::tick;
+    } else if (anItem.timestampSize > 1U) {
+        uint32_t timestampLength = anItem.timestampSize - 1U;        // timestampSize includes the terminating zero
+        length += logBinary::putVarint(frame + length, timestampLength);
+        memcpy(frame + length, anItem.timestamp(), timestampLength);
+        length += timestampLength;
+        theTimestampType = logBinary::timestampType::text;
+    }
+    uint32_t subSystemIndex = static_cast<uint8_t>(anItem.theSubSystem);
+    frame[length++]         = static_cast<uint8_t>(static_cast<uint8_t>(anItem.theLoggingLevel) | (((subSystemIndex < logBinary::subSystemEscape) ? subSystemIndex : logBinary::subSystemEscape) << 3));
+    if (subSystemIndex >= logBinary::subSystemEscape) {
+        length += logBinary::putVarint(frame + length, subSystemIndex);
+    }
+    logBinary::recordType theRecordType;
+    if (anItem.format != nullptr) {
+        length += logBinary::putVarint(frame + length, anItem.internedFormat ? static_cast<const logFormat *>(anItem.format)->id : logBinary::formatId(anItem.formatText()));        // raw args, formatted on the host
+        uint32_t argsLength = logArgs::fittingLength(anItem.contents(), anItem.contentsSize, maxFrameLength - length);
+        memcpy(frame + length, anItem.contents(), argsLength);
+        length += argsLength;
+        theRecordType = logBinary::recordType::deferred;
+    } else if (anItem.structured) {
+        uint32_t fieldsLength = logArgs::fittingLength(anItem.contents(), anItem.contentsSize, maxFrameLength - length);        // message and fields, as packed
+        memcpy(frame + length, anItem.contents(), fieldsLength);
+        length += fieldsLength;
+        theRecordType = logBinary::recordType::structured;
+    } else {
+        uint32_t textLength = anItem.contentsSize - 1U;        // contentsSize includes the terminating zero
+        if (textLength > (maxFrameLength - length)) {
+            textLength = maxFrameLength - length;
+        }
+        memcpy(frame + length, anItem.contents(), textLength);
+        length += textLength;
+        theRecordType = logBinary::recordType::text;
+    }
+    frame[0] = static_cast<uint8_t>(static_cast<uint8_t>(theRecordType) | (static_cast<uint8_t>(theTimestampType) << 2));
+    return logBinary::encode(frame, length, reinterpret_cast<uint8_t *>(contents));
+}
+
+template <typename config>
+uint32_t basicLog<config>::formatFields(uint32_t outputIndex, const logItem &anItem, char *contents) {
+    logEncoding theEncoding = outputs[outputIndex].getEncoding();
+    logLineWriter aLine(contents, 0, maxItemLength - ((theEncoding == logEncoding::json) ? 2U : 1U), theEncoding);        // keep room for closing brace and newline
+    aLine.begin();
+    if (outputs[outputIndex].hasTimestampIncluded()) {
+        char timestamp[lineSize];
+        uint32_t timestampLength;
+        if (anItem.tickTimestamp) {
+            uint64_t tick;
+            memcpy(&tick, anItem.timestamp(), sizeof(tick));        // memcpy as the timestamp has no alignment
+            timestampLength = timestamps.format(tick, timestamp);
+        } else {
+            timestampLength = anItem.timestampSize - 1U;        // timestampSize includes the terminating zero
+            memcpy(timestamp, anItem.timestamp(), timestampLength);
+        }
+        aLine.addString("ts", timestamp, timestampLength);
+    }
+    const char* levelName = toString(anItem.theLoggingLevel);
+    aLine.addString("level", levelName, strlen(levelName));
+    const char* subSystemName = (getSubSystemName != nullptr) ? getSubSystemName(anItem.theSubSystem) : nullptr;
+    if (subSystemName != nullptr) {
+        aLine.addString("subsystem", subSystemName, strlen(subSystemName));
+    } else {        // without a name, its number
+        uint8_t subSystemIndex = static_cast<uint8_t>(anItem.theSubSystem);
+        aLine.addValue("subsystem", logArgValue{logArgType::uint32, subSystemIndex, subSystemIndex, static_cast<double>(subSystemIndex), ""});
+    }
+    if (anItem.format != nullptr) {
+        char message[lineSize];
+        uint32_t messageLength = logArgs::render(message, lineSize, anItem.formatText(), anItem.contents(), anItem.contentsSize);        // deferred item : format it now
+        aLine.addString("msg", message, messageLength);
+    } else if (anItem.structured) {
+        const char* message;
+        uint32_t messageLength;
+        uint32_t fieldsStart = logLineWriter::message(anItem.contents(), anItem.contentsSize, message, messageLength);
+        aLine.addString("msg", message, messageLength);
+        aLine.addFields(anItem.contents() + fieldsStart, anItem.contentsSize - fieldsStart);
+    } else {
+        aLine.addString("msg", anItem.contents(), anItem.contentsSize - 1U);        // contentsSize includes the terminating zero
+    }
+    return aLine.end();
+}
+
+template <typename config>
+void basicLog<config>::setTimeSource(bool (*aFunction)(char *, uint32_t)) {
+    getTime = aFunction;
+}
+
+template <typename config>
+void basicLog<config>::setTickSource(uint64_t (*aFunction)(), uint32_t ticksPerSecond) {
+    timestamps.setTicksPerSecond(ticksPerSecond);
+    getTick = aFunction;
+}
+
+template <typename config>
+void basicLog<config>::setSubSystemNames(const char *(*aFunction)(subSystemType)) {
+    getSubSystemName = aFunction;
+}
+
+template <typename config>
+void basicLog<config>::setOutput(uint32_t outputIndex, bool (*aFunction)(const char *)) {
+    if (outputIndex < maxNmbrOutputs) {
+        lockLevels();
+        outputs[outputIndex].setOutputDestination(aFunction);
+        updateOutputMasks();
+        unlockLevels();
+    }
+}
+
+template <typename config>
+void basicLog<config>::setBatchOutput(uint32_t outputIndex, uint32_t (*aFunction)(const logSpan *, uint32_t)) {
+    if (outputIndex < maxNmbrOutputs) {
+        lockLevels();
+        outputs[outputIndex].setBatchOutputDestination(aFunction);
+        updateOutputMasks();
+        unlockLevels();
+    }
+}
+
+template <typename config>
+bool basicLog<config>::outputIsActive(uint32_t outputIndex) {
+    if (outputIndex < maxNmbrOutputs) {
+        return outputs[outputIndex].isActive();
+    } else {
+        return false;
+    }
+}
+
+template <typename config>
+void basicLog<config>::setLoggingLevel(uint32_t outputIndex, subSystemType theSubSystem, loggingLevel theLoggingLevel) {
+    if (outputIndex < maxNmbrOutputs) {
+        lockLevels();
+        outputs[outputIndex].setLoggingLevel(theSubSystem, theLoggingLevel);
+        updateOutputMasks();
+        unlockLevels();
+    }
+}
+
+template <typename config>
+void basicLog<config>::setLoggingLevel(uint32_t outputIndex, loggingLevel theLoggingLevel) {
+    if (outputIndex < maxNmbrOutputs) {
+        lockLevels();
+        for (uint8_t subSystemIndex = 0; subSystemIndex < static_cast<uint8_t>(subSystemType::nmbrOfSubsystems); subSystemIndex++) {
+            outputs[outputIndex].setLoggingLevel(static_cast<subSystemType>(subSystemIndex), theLoggingLevel);
+        }
+        updateOutputMasks();
+        unlockLevels();
+    }
+}
+
+template <typename config>
+bool basicLog<config>::setLoggingLevels(const char *rulesText) {
+    logLevelRules rules;
+    if (!rules.parse(rulesText, maxNmbrOutputs)) {
+        return false;
+    }
+    lockLevels();        // held while compiling as well, so the rules of concurrent configurers don't interleave
+    for (uint8_t subSystemIndex = 0; subSystemIndex < static_cast<uint8_t>(subSystemType::nmbrOfSubsystems); subSystemIndex++) {        // one pass over the subSystems, each name is only looked up once
+        char number[4];
+        const char *name = (getSubSystemName != nullptr) ? getSubSystemName(static_cast<subSystemType>(subSystemIndex)) : nullptr;
+        if (name == nullptr) {
+            uint32_t numberLength = logConvert::decimal(number, subSystemIndex);        // without a name, rules match the number of the subSystem
+            number[numberLength]  = 0;
+            name                  = number;
+        }
+        for (uint32_t ruleIndex = 0; ruleIndex < rules.size(); ruleIndex++) {        // in order, so later rules override earlier ones
+            if (rules.matches(ruleIndex, name)) {
+                for (uint32_t outputIndex = 0; outputIndex < maxNmbrOutputs; outputIndex++) {
+                    if ((rules[ruleIndex].outputMask & (1U << outputIndex)) != 0) {
+                        outputs[outputIndex].setLoggingLevel(static_cast<subSystemType>(subSystemIndex), rules[ruleIndex].theLevel);
+                    }
+                }
+            }
+        }
+    }
+    updateOutputMasks();        // producers only see the result of all rules
+    unlockLevels();
+    return true;
+}
+
+template <typename config>
+uint32_t basicLog<config>::getLevelsGeneration() const {
+    return levelsGeneration.load(std::memory_order_acquire);
+}
+
+template <typename config>
+void basicLog<config>::setColoredOutput(uint32_t outputIndex, bool newSetting) {
+    if (outputIndex < maxNmbrOutputs) {
+        outputs[outputIndex].setColoredOutput(newSetting);
+    }
+}
+
+template <typename config>
+void basicLog<config>::setIncludeTimestamp(uint32_t outputIndex, bool newSetting) {
+    if (outputIndex < maxNmbrOutputs) {
+        outputs[outputIndex].setIncludeTimestamp(newSetting);
+    }
+}
+
+template <typename config>
+loggingLevel basicLog<config>::getLoggingLevel(uint32_t outputIndex, subSystemType theSubSystem) {
+    if (outputIndex < maxNmbrOutputs) {
+        return outputs[outputIndex].getLoggingLevel(theSubSystem);
+    } else {
+        return loggingLevel::None;
+    }
+}
+
+template <typename config>
+bool basicLog<config>::isColoredOutput(uint32_t outputIndex) {
+    if (outputIndex < maxNmbrOutputs) {
+        return outputs[outputIndex].isColoredOutput();
+    } else {
+        return false;
+    }
+}
+
+template <typename config>
+bool basicLog<config>::hasTimestampIncluded(uint32_t outputIndex) {
+    if (outputIndex < maxNmbrOutputs) {
+        return outputs[outputIndex].hasTimestampIncluded();
+    } else {
+        return false;
+    }
+}
+
+template <typename config>
+void basicLog<config>::setEncoding(uint32_t outputIndex, logEncoding newEncoding) {
+    if (outputIndex < maxNmbrOutputs) {
+        outputs[outputIndex].setEncoding(newEncoding);
+    }
+}
+
+template <typename config>
+logEncoding basicLog<config>::getEncoding(uint32_t outputIndex) {
+    if (outputIndex < maxNmbrOutputs) {
+        return outputs[outputIndex].getEncoding();
+    } else {
+        return logEncoding::text;
+    }
+}
+
+template <typename config>
+void basicLog<config>::setBinaryOutput(uint32_t outputIndex, bool newSetting) {
+    if (outputIndex < maxNmbrOutputs) {
+        outputs[outputIndex].setBinaryOutput(newSetting);
+    }
+}
+
+template <typename config>
+bool basicLog<config>::isBinaryOutput(uint32_t outputIndex) {
+    if (outputIndex < maxNmbrOutputs) {
+        return outputs[outputIndex].isBinaryOutput();
+    } else {
+        return false;
+    }
+}
+
+template <typename config>
+void basicLog<config>::setOverflowPolicy(overflowPolicy newPolicy, uint32_t newSampleRate) {
+    theOverflowPolicy = newPolicy;
+    sampleRate        = (newSampleRate > 0) ? newSampleRate : 1U;
+}
+
+template <typename config>
+overflowPolicy basicLog<config>::getOverflowPolicy() const {
+    return theOverflowPolicy;
+}
+
+template <typename config>
+uint32_t basicLog<config>::getDroppedItems() const {
+    return droppedItems.load();
+}
+
+template <typename config>
+void basicLog<config>::setRateLimit(subSystemType theSubSystem, uint32_t itemsPerSecond, uint32_t burst) {
+    limiter.setRateLimit(static_cast<uint8_t>(theSubSystem), itemsPerSecond, burst);
+}
+
+template <typename config>
+void basicLog<config>::setSuppressDuplicates(bool newSetting) {
+    limiter.setSuppressDuplicates(newSetting);
+}
+
+template <typename config>
+uint32_t basicLog<config>::getRateLimitedItems() const {
+    return rateLimitedItems.load();
+}
+
+template <typename config>
+void basicLog<config>::setLagLimit(uint32_t outputIndex, uint32_t maxLag, lagPolicy newPolicy) {
+    if (outputIndex < maxNmbrOutputs) {
+        outputs[outputIndex].setLagLimit(maxLag, newPolicy);
+    }
+}
+
+template <typename config>
+uint32_t basicLog<config>::getLaggedItems(uint32_t outputIndex) const {
+    if (outputIndex < maxNmbrOutputs) {
+        return laggedItems[outputIndex];
+    } else {
+        return 0;
+    }
+}
+
+template <typename config>
+void basicLog<config>::setFlightRecorder(loggingLevel recordLevel, loggingLevel triggerLevel, uint32_t maxDumpedItems) {
+    recorder.setLevels(recordLevel, triggerLevel, maxDumpedItems);
+}
+
+template <typename config>
+void basicLog<config>::getMetrics(metricsSnapshot &aSnapshot) const {
+    metrics.get(aSnapshot);
+    for (uint32_t outputIndex = 0; outputIndex < maxNmbrOutputs; outputIndex++) {
+        aSnapshot.outputCounters[outputIndex][static_cast<uint8_t>(logOutputCounter::lagged)] = laggedItems[outputIndex].load(std::memory_order_relaxed);        // counted even without metrics
+    }
+    aSnapshot.bufferSize = bufferSize;
+}
+
+template <typename config>
+void basicLog<config>::setMetricsInterval(uint32_t intervalInMs, subSystemType theSubSystem, loggingLevel theLevel) {
+    metricsSubSystem = theSubSystem;
+    metricsLevel     = theLevel;
+    lastMetrics.store(logMicroseconds());
+    metricsInterval.store(((intervalInMs < maxMetricsInterval) ? intervalInMs : maxMetricsInterval) * 1000U);
+}
+
+template <typename config>
+bool basicLog<config>::attachBuffer(void *memory, uint32_t memoryLength) {
+    while (!items.acquireConsumer()) {        // not while another task is outputting
+        logWriter::yield();
+    }
+    recoveredItems = 0;
+    bool recovered = items.attach(memory, memoryLength);
+    for (uint32_t outputIndex = 0; outputIndex < maxNmbrOutputs; outputIndex++) {
+        cursors[outputIndex] = items.readPosition();        // positions in the new region are not the same
+    }
+    if (recovered) {
+        uint32_t position;
+        if (items.peek(position)) {
+            do {
+                if (isValidItem(position)) {
+                    recoveredItems++;
+                } else {
+                    items.skip(position);
+                }
+            } while (items.next(position));
+        }
+    }
+    items.releaseConsumer();
+    return recovered;
+}
+
+template <typename config>
+uint32_t basicLog<config>::getRecoveredItems() const {
+    return recoveredItems;
+}
+
+template <typename config>
+bool basicLog<config>::isValidItem(uint32_t position) {
+    uint32_t room = items.payloadLength(position);
+    if (room < sizeof(logItem)) {
+        return false;
+    }
+    logItem *anItem = item(position);
+    if ((logItem::storageLength(anItem->timestampSize, anItem->contentsSize) > room) || (static_cast<uint8_t>(anItem->theLoggingLevel) >= static_cast<uint8_t>(loggingLevel::nmbrLoggingLevels)) || (static_cast<uint8_t>(anItem->theSubSystem) >= static_cast<uint8_t>(subSystemType::nmbrOfSubsystems))) {
+        return false;
+    }
+    if (anItem->tickTimestamp ? (anItem->timestampSize != sizeof(uint64_t)) : ((anItem->timestampSize == 0) || (anItem->timestampSize > (logItem::timestampLength + 1U)) || (anItem->timestamp()[anItem->timestampSize - 1U] != 0))) {
+        return false;
+    }
+    anItem->loggedAt = metrics.now();        // the clock of the previous run is not the same
+    if (anItem->structured) {
+        return (anItem->format == nullptr);        // packed, as deferred items, but without format
+    }
+    if (anItem->format != nullptr) {
+        anItem->format         = "(deferred item of a previous run)";        // the format may point to code which is no longer there
+        anItem->internedFormat = false;
+        return true;
+    }
+    return (anItem->contentsSize > 0) && (anItem->contents()[anItem->contentsSize - 1U] == 0);
+}
+
+template <typename config>
+bool basicLog<config>::startWriter(uint32_t pollIntervalInMs) {
+    return writer.start(writerFunction, this, pollIntervalInMs);
+}
+
+template <typename config>
+void basicLog<config>::stopWriter() {
+    writer.stop();
+}
+
+template <typename config>
+void basicLog<config>::writerFunction(void *aLog) {
+    static_cast<basicLog *>(aLog)->output();
+}
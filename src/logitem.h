@@ -2,15 +2,46 @@
 #include <stdint.h>
 #include "logginglevels.h"
 #include "subsystems.h"
+#include "logformat.h"
 
-class logItem {
+// header of an item as stored in the items buffer. It is directly followed by the timestamp and the contents, each taking only the bytes they need
+
+template <typename subSystemType>
+class basicLogItem {
   public:
-    static constexpr uint32_t timestampLength{21U};          // Maximum number of digits to use for timestamps
-    char timestamp[timestampLength + 1U];                    // cstring holding the timestamps
-    static constexpr uint32_t maxItemLength{96U};            // Maximum length of new item to be logged. Will be an upper limit to all C-style string like strnlen()
-    char contents[maxItemLength + 1U];                       // cstring holding the to-be-logged contents
-    loggingLevel theLoggingLevel{loggingLevel::None};        // level of this item
-    subSystem theSubSystem{subSystem::general};              // subSystem of this item
+    static constexpr uint32_t timestampLength{21U};        // Maximum number of digits to use for timestamps from a time source
+    static_assert(timestampLength >= sizeof(uint64_t), "timestamp can also hold a raw tick");
+    static constexpr uint32_t maxItemLength{96U};          // Default maximum length of new item to be logged, see logConfig. Will be an upper limit to all C-style string like strnlen()
+
+    static constexpr uint32_t storageLength(uint32_t timestampSize, uint32_t contentsSize) {        // number of bytes needed to store an item
+        return sizeof(basicLogItem) + timestampSize + contentsSize;
+    }
+    char* timestamp() {        // cstring holding the timestamp, or the raw tick when tickTimestamp is set
+        return reinterpret_cast<char*>(this + 1);
+    }
+    const char* timestamp() const {
+        return reinterpret_cast<const char*>(this + 1);
+    }
+    char* contents() {        // cstring holding the to-be-logged contents, or the packed arguments of a deferred item
+        return reinterpret_cast<char*>(this + 1) + timestampSize;
+    }
+    const char* contents() const {
+        return reinterpret_cast<const char*>(this + 1) + timestampSize;
+    }
+    const char* formatText() const {        // for deferred items : the format string
+        return internedFormat ? static_cast<const logFormat*>(format)->text : static_cast<const char*>(format);
+    }
 
-  private:
+    const void* format{nullptr};                             // for deferred items : printf() style format, formatted with the packed arguments at output time. A const char*, or a const logFormat* when internedFormat is set
+    uint32_t loggedAt{0};                                    // logMicroseconds() when it was logged, for the latency metrics
+    uint8_t timestampSize{0};                                // number of bytes of timestamp : text including the terminating zero, or raw tick
+    bool tickTimestamp{false};                               // timestamp holds a raw tick, formatted at output time
+    bool internedFormat{false};                              // format points to a logFormat, which also holds the ID of the format
+    bool structured{false};                                  // contents holds a packed message followed by packed key / value fields, see logfields.h
+    uint8_t dumpedTo{0};                                     // for an item of the flight recorder : one bit per output it goes to, whatever their loggingLevel
+    uint8_t contentsSize{0};                                 // number of bytes of contents : text including the terminating zero, or packed arguments
+    loggingLevel theLoggingLevel{loggingLevel::None};        // level of this item
+    subSystemType theSubSystem{};                            // subSystem of this item
 };
+
+typedef basicLogItem<subSystem> logItem;
@@ -0,0 +1,116 @@
+#include <string.h>        // required for strlen()
+#include "loglevelrules.h"
+
+bool logLevelRules::parse(const char* text, uint32_t nmbrOutputs) {
+    nmbrRules = 0;
+    for (;;) {
+        while (isSeparator(*text)) {
+            text++;
+        }
+        if (*text == 0) {
+            return true;
+        }
+        const char* rule = text;
+        while ((*text != 0) && !isSeparator(*text)) {
+            text++;
+        }
+        if ((nmbrRules >= maxNmbrRules) || !parseRule(rule, static_cast<uint32_t>(text - rule), nmbrOutputs, rules[nmbrRules])) {
+            nmbrRules = 0;        // all rules or none
+            return false;
+        }
+        nmbrRules++;
+    }
+}
+
+uint32_t logLevelRules::size() const {
+    return nmbrRules;
+}
+
+const logLevelRule& logLevelRules::operator[](uint32_t index) const {
+    return rules[index];
+}
+
+bool logLevelRules::matches(uint32_t index, const char* name) const {
+    return (index < nmbrRules) && matchesPattern(rules[index].pattern, rules[index].patternLength, name);
+}
+
+bool logLevelRules::parseLevel(const char* text, uint32_t textLength, loggingLevel& theLevel) {
+    if ((textLength == 1U) && (text[0] >= '0') && (text[0] < static_cast<char>('0' + static_cast<uint8_t>(loggingLevel::nmbrLoggingLevels)))) {
+        theLevel = static_cast<loggingLevel>(text[0] - '0');
+        return true;
+    }
+    for (uint8_t levelIndex = 0; levelIndex < static_cast<uint8_t>(loggingLevel::nmbrLoggingLevels); levelIndex++) {
+        const char* name = toString(static_cast<loggingLevel>(levelIndex));
+        if (strlen(name) == textLength) {
+            uint32_t index{0};
+            while ((index < textLength) && ((text[index] | 0x20) == (name[index] | 0x20))) {        // the names only have letters, so this compares them in any case
+                index++;
+            }
+            if (index == textLength) {
+                theLevel = static_cast<loggingLevel>(levelIndex);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool logLevelRules::matchesPattern(const char* pattern, uint32_t patternLength, const char* name) {
+    uint32_t patternIndex{0};
+    uint32_t starIndex{UINT32_MAX};        // position of the last * seen, to retry from when the rest does not match
+    const char* starName{nullptr};         // the char of name that * matched up to, exclusive
+    while (*name != 0) {
+        if ((patternIndex < patternLength) && ((pattern[patternIndex] == '?') || (pattern[patternIndex] == *name))) {
+            patternIndex++;
+            name++;
+        } else if ((patternIndex < patternLength) && (pattern[patternIndex] == '*')) {
+            starIndex = patternIndex++;
+            starName  = name;
+        } else if (starIndex != UINT32_MAX) {        // let the last * match one more char
+            patternIndex = starIndex + 1U;
+            name         = ++starName;
+        } else {
+            return false;
+        }
+    }
+    while ((patternIndex < patternLength) && (pattern[patternIndex] == '*')) {
+        patternIndex++;
+    }
+    return (patternIndex == patternLength);
+}
+
+bool logLevelRules::parseRule(const char* text, uint32_t textLength, uint32_t nmbrOutputs, logLevelRule& theRule) {
+    theRule.outputMask = static_cast<uint8_t>((nmbrOutputs >= 8U) ? 0xFFU : ((1U << nmbrOutputs) - 1U));
+    uint32_t start{0};
+    uint32_t digits{0};
+    while ((digits < textLength) && (text[digits] >= '0') && (text[digits] <= '9')) {
+        digits++;
+    }
+    if ((textLength > 1U) && (text[0] == '*') && (text[1] == ':')) {        // all outputs
+        start = 2U;
+    } else if ((digits > 0) && (digits < textLength) && (text[digits] == ':')) {        // one output, otherwise the digits are part of the pattern
+        uint32_t outputIndex{0};
+        for (uint32_t index = 0; (index < digits) && (outputIndex < nmbrOutputs); index++) {
+            outputIndex = (outputIndex * 10U) + static_cast<uint32_t>(text[index] - '0');
+        }
+        if (outputIndex >= nmbrOutputs) {
+            return false;
+        }
+        theRule.outputMask = static_cast<uint8_t>(1U << outputIndex);
+        start              = digits + 1U;
+    }
+    uint32_t equals = start;
+    while ((equals < textLength) && (text[equals] != '=')) {
+        equals++;
+    }
+    if ((equals == start) || (equals == textLength)) {
+        return false;        // no pattern, or no level
+    }
+    theRule.pattern       = text + start;
+    theRule.patternLength = equals - start;
+    return parseLevel(text + equals + 1U, textLength - (equals + 1U), theRule.theLevel);
+}
+
+bool logLevelRules::isSeparator(char aChar) {
+    return (aChar == ' ') || (aChar == ',') || (aChar == ';') || (aChar == '\t') || (aChar == '\r') || (aChar == '\n');
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include <stdint.h>
+#include "logginglevels.h"
+
+// Level rules, to change the loggingLevels of many subSystems and outputs at once, eg. from a serial command during a field investigation.
+// Rules are separated by spaces, ',' or ';', and applied in order, so a later rule overrides an earlier one : "*=Warning net*=Debug 1:netData=None"
+// Each rule is [output:]pattern=level
+// * output : the index of an output, or * for all of them. When left out, the rule is for all outputs
+// * pattern : matched against the names of the subSystems, see basicLog::setSubSystemNames(), or their number when they have no names. * matches any chars, ? any single char
+// * level : the name of a loggingLevel, in any case, or its number, eg. debug or 5
+// basicLog::setLoggingLevels() compiles all rules into the levels of its outputs, and only then publishes them, so a producer sees either all rules or none of them
+
+struct logLevelRule {
+    const char* pattern;        // not zero terminated, points into the text of the rules
+    uint32_t patternLength;     //
+    uint8_t outputMask;         // one bit per output this rule is for
+    loggingLevel theLevel;      //
+};
+
+class logLevelRules {
+  public:
+    bool parse(const char* text, uint32_t nmbrOutputs);        // parses all rules of text, which must stay valid while the rules are used. Returns false, and holds no rules, when any rule is invalid
+    uint32_t size() const;                                     // number of rules parsed
+    const logLevelRule& operator[](uint32_t index) const;      //
+    bool matches(uint32_t index, const char* name) const;      // does rule index apply to the subSystem with this name
+    static bool parseLevel(const char* text, uint32_t textLength, loggingLevel& theLevel);        // a loggingLevel by name, in any case, or by number
+    static bool matchesPattern(const char* pattern, uint32_t patternLength, const char* name);      // glob match of the whole name, with * and ?
+    static constexpr uint32_t maxNmbrRules{16U};                                                     //
+
+#ifndef unitTest
+  private:
+#endif
+    static bool parseRule(const char* text, uint32_t textLength, uint32_t nmbrOutputs, logLevelRule& theRule);        // parses one rule, without its separators
+    static bool isSeparator(char aChar);                                                                               //
+    logLevelRule rules[maxNmbrRules];                                                                                  //
+    uint32_t nmbrRules{0};                                                                                             //
+};
@@ -0,0 +1,151 @@
+#pragma once
+#include <stdint.h>
+#include <atomic>
+#include "logclock.h"
+
+// Protects the items buffer against a subSystem flooding it, so one chatty subSystem can't evict the items of all others, nor saturate the outputs.
+// Both checks are done before anything is copied into the buffer, and both are lock-free, so they can stay enabled in production :
+// * rate limit : per subSystem, a token bucket of burst items, refilled at itemsPerSecond. Implemented as GCRA, so its whole state is one 32 bit theoretical arrival time, updated with a compare-exchange
+// * duplicate suppression : per subSystem, an item identical to the previous one is only counted. A summary item "last message repeated n times" is logged before the next different item, or at the next output()
+// Items dropped by the rate limit are summarized the same way.
+
+template <uint32_t nmbrSubSystems, bool enabled = true>
+class logLimiter {
+  public:
+    void setRateLimit(uint32_t subSystemIndex, uint32_t itemsPerSecond, uint32_t burst) {        // itemsPerSecond 0 removes the limit
+        subSystemState& state = states[subSystemIndex];
+        uint32_t interval     = (itemsPerSecond > 0) ? ((itemsPerSecond < 1000000U) ? (1000000U / itemsPerSecond) : 1U) : 0U;
+        uint32_t maxBurst     = (interval > 0) ? (maxTolerance / interval) : 0U;
+        state.tolerance.store(((burst > 1U) ? (((burst - 1U) < maxBurst) ? (burst - 1U) : maxBurst) : 0U) * interval);
+        state.theoreticalArrival.store(logMicroseconds());        // bucket starts full, whatever the value of the clock
+        state.interval.store(interval);
+        updateActive();
+    }
+    void setSuppressDuplicates(bool newSetting) {
+        suppressDuplicates.store(newSetting);
+        updateActive();
+    }
+    bool isSuppressingDuplicates() const {
+        return suppressDuplicates.load(std::memory_order_relaxed);
+    }
+    bool isActive() const {        // is any check enabled
+        return active.load(std::memory_order_relaxed);
+    }
+
+    bool isDuplicate(uint32_t subSystemIndex, uint32_t hash, uint8_t level, uint32_t& repeated, uint8_t& repeatedLevel) {        // true when the item is the same as the previous one of this subSystem, it is then counted. Otherwise, repeated tells how often the previous one was repeated
+        subSystemState& state = states[subSystemIndex];
+        hash |= 1U;        // 0 is the initial value, meaning no previous item
+        if (state.lastHash.load(std::memory_order_relaxed) == hash) {
+            state.repeated++;
+            return true;
+        }
+        repeated      = state.repeated.exchange(0);
+        repeatedLevel = state.lastLevel.load(std::memory_order_relaxed);
+        state.lastLevel.store(level, std::memory_order_relaxed);
+        state.lastHash.store(hash, std::memory_order_relaxed);
+        return false;
+    }
+    uint32_t takeRepeated(uint32_t subSystemIndex, uint8_t& repeatedLevel) {        // number of items suppressed as duplicate and not yet summarized
+        subSystemState& state = states[subSystemIndex];
+        if (state.repeated.load(std::memory_order_relaxed) == 0) {
+            return 0;
+        }
+        repeatedLevel = state.lastLevel.load(std::memory_order_relaxed);
+        return state.repeated.exchange(0);
+    }
+
+    bool isAllowed(uint32_t subSystemIndex) {        // takes a token from the bucket of this subSystem, returns false when it is empty, the item is then counted
+        subSystemState& state = states[subSystemIndex];
+        uint32_t interval     = state.interval.load(std::memory_order_relaxed);
+        if (interval == 0) {
+            return true;
+        }
+        uint32_t tolerance          = state.tolerance.load(std::memory_order_relaxed);
+        uint32_t now                = logMicroseconds();
+        uint32_t theoreticalArrival = state.theoreticalArrival.load(std::memory_order_relaxed);
+        while (true) {
+            uint32_t ahead = theoreticalArrival - now;
+            uint32_t start = theoreticalArrival;
+            if ((static_cast<int32_t>(ahead) < 0) || (ahead > (tolerance + interval))) {
+                start = now;        // bucket is full : idle for a while, or so long that the clock wrapped around
+            } else if (ahead > tolerance) {
+                state.rejected++;
+                return false;
+            }
+            if (state.theoreticalArrival.compare_exchange_weak(theoreticalArrival, start + interval, std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+    }
+    uint32_t takeRejected(uint32_t subSystemIndex) {        // number of items dropped by the rate limit and not yet summarized
+        subSystemState& state = states[subSystemIndex];
+        if (state.rejected.load(std::memory_order_relaxed) == 0) {
+            return 0;
+        }
+        return state.rejected.exchange(0);
+    }
+
+    static uint32_t hash(uint32_t hash, const void* data, uint32_t length) {        // FNV-1a, to compare items
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        for (uint32_t index = 0; index < length; index++) {
+            hash = (hash ^ bytes[index]) * 16777619U;
+        }
+        return hash;
+    }
+
+#ifndef unitTest
+  private:
+#endif
+    static constexpr uint32_t maxTolerance{0x40000000U};        // in us, so a burst never gets near the wrap around of the clock
+
+    struct subSystemState {
+        std::atomic<uint32_t> interval{0};                  // us per item, 0 when not limited
+        std::atomic<uint32_t> tolerance{0};                 // us, (burst - 1) * interval
+        std::atomic<uint32_t> theoreticalArrival{0};        // us, when the bucket is full again
+        std::atomic<uint32_t> rejected{0};                  // items dropped by the rate limit, not yet summarized
+        std::atomic<uint32_t> lastHash{0};                  // of the previous item, 0 when none
+        std::atomic<uint8_t> lastLevel{0};                  // of the previous item
+        std::atomic<uint32_t> repeated{0};                  // items suppressed as duplicate, not yet summarized
+    };
+
+    void updateActive() {
+        bool anyLimit{false};
+        for (uint32_t subSystemIndex = 0; subSystemIndex < nmbrSubSystems; subSystemIndex++) {
+            anyLimit = anyLimit || (states[subSystemIndex].interval.load() != 0);
+        }
+        active.store(anyLimit || suppressDuplicates.load());
+    }
+
+    subSystemState states[nmbrSubSystems];
+    std::atomic<bool> suppressDuplicates{false};
+    std::atomic<bool> active{false};
+};
+
+template <uint32_t nmbrSubSystems>
+class logLimiter<nmbrSubSystems, false> {        // limiter disabled : takes no memory, and an item never gets past isActive()
+  public:
+    void setRateLimit(uint32_t, uint32_t, uint32_t) {}
+    void setSuppressDuplicates(bool) {}
+    bool isSuppressingDuplicates() const {
+        return false;
+    }
+    bool isActive() const {
+        return false;
+    }
+    bool isDuplicate(uint32_t, uint32_t, uint8_t, uint32_t& repeated, uint8_t&) {
+        repeated = 0;
+        return false;
+    }
+    uint32_t takeRepeated(uint32_t, uint8_t&) {
+        return 0;
+    }
+    bool isAllowed(uint32_t) {
+        return true;
+    }
+    uint32_t takeRejected(uint32_t) {
+        return 0;
+    }
+    static uint32_t hash(uint32_t hash, const void*, uint32_t) {
+        return hash;
+    }
+};
@@ -0,0 +1,68 @@
+#include "logmappedfile.h"
+
+#if !defined(ARDUINO) && !defined(ESP32) && (defined(__unix__) || defined(__APPLE__))
+#include <fcntl.h>           // required for open()
+#include <unistd.h>          // required for close(), ftruncate()
+#include <sys/mman.h>        // required for mmap()
+#include <sys/stat.h>        // required for fstat()
+
+bool logMappedFile::open(const char* path, uint32_t length) {
+    close();
+    int file = ::open(path, O_RDWR | O_CREAT, 0644);
+    if (file < 0) {
+        return false;
+    }
+    struct stat status;
+    if ((fstat(file, &status) != 0) || ((status.st_size < static_cast<off_t>(length)) && (ftruncate(file, length) != 0))) {        // a new file is filled with zeroes, so it holds no items
+        ::close(file);
+        return false;
+    }
+    void* mapped = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+    ::close(file);        // the mapping keeps the file open
+    if (mapped == MAP_FAILED) {
+        return false;
+    }
+    theAddress = mapped;
+    theLength  = length;
+    return true;
+}
+
+void logMappedFile::close() {
+    if (theAddress != nullptr) {
+        munmap(theAddress, theLength);
+        theAddress = nullptr;
+        theLength  = 0;
+    }
+}
+
+bool logMappedFile::sync() {
+    return (theAddress != nullptr) && (msync(theAddress, theLength, MS_SYNC) == 0);
+}
+
+#else
+
+// no files to map on this platform : use a section of RAM which is not cleared at reset instead
+
+bool logMappedFile::open(const char*, uint32_t) {
+    return false;
+}
+
+void logMappedFile::close() {}
+
+bool logMappedFile::sync() {
+    return false;
+}
+
+#endif
+
+logMappedFile::~logMappedFile() {
+    close();
+}
+
+void* logMappedFile::address() const {
+    return theAddress;
+}
+
+uint32_t logMappedFile::length() const {
+    return theLength;
+}
@@ -0,0 +1,28 @@
+#pragma once
+#include <stdint.h>
+
+// Maps a file into memory, to hold the items buffer of uLog, see uLog::attachBuffer().
+// The items then survive a crash of the process : the OS still writes the mapped pages to the file. Only a power loss needs sync() to have been called.
+// Only available on native Linux / macOS. On other platforms, open() fails.
+//
+// Example :
+//   logMappedFile theFile;
+//   if (theFile.open("/var/tmp/app.ulog", uLog::attachedBufferSize)) {
+//       theLog.attachBuffer(theFile.address(), theFile.length());
+//   }
+
+class logMappedFile {
+  public:
+    ~logMappedFile();
+    bool open(const char* path, uint32_t length);        // maps the file, creating it or growing it to length bytes when needed. Returns false when it can't be mapped
+    void close();                                        //
+    bool sync();                                         // writes the mapped pages to the file and waits until that is done. Not needed to survive a crash of the process
+    void* address() const;                               // start of the mapped memory, nullptr when not open
+    uint32_t length() const;                             //
+
+#ifndef unitTest
+  private:
+#endif
+    void* theAddress{nullptr};
+    uint32_t theLength{0};
+};
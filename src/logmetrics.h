@@ -0,0 +1,155 @@
+#pragma once
+#include <stdint.h>
+#include <string.h>
+#include <atomic>
+#include "logclock.h"
+
+// Counters telling what happened to the items, so the buffers can be sized and loss detected in the field.
+// Producers and the consumer update them with relaxed atomic increments, without locks, so they can stay enabled in production.
+// A snapshot copies them one by one : each counter in it is exact, but they are not all taken at the same instant.
+// They are off by default, as even a relaxed increment makes a filtered item cost more than its level check : set collectMetrics in the configuration of uLog to collect them.
+
+enum class logCounter : uint8_t {        // per subSystem
+    logged,             // stored in the buffer
+    filtered,           // not wanted by any output, so not stored
+    truncated,          // stored, but cut to maxItemLength
+    dropped,            // lost because the buffer was full
+    overwritten,        // removed from the buffer to make room for a newer item, see overflowPolicy
+    rateLimited,        // dropped by the rate limit
+    suppressed,         // identical to the previous one, so only counted
+    recorded,           // not wanted by any output, but kept in the flight recorder, see logrecorder.h
+    nmbrCounters
+};
+
+enum class logOutputCounter : uint8_t {        // per output
+    writes,            // calls to the output
+    delivered,         // items accepted by the output
+    rejected,          // items handed to the output but not accepted, they are retried later
+    lagged,            // items skipped because the output lagged too far, see lagPolicy
+    nmbrCounters
+};
+
+template <typename subSystemType, uint32_t nmbrOutputs>
+struct logMetricsSnapshot {
+    static constexpr uint32_t nmbrSubSystems     = static_cast<uint8_t>(subSystemType::nmbrOfSubsystems);
+    static constexpr uint32_t nmbrCounters       = static_cast<uint8_t>(logCounter::nmbrCounters);
+    static constexpr uint32_t nmbrOutputCounters = static_cast<uint8_t>(logOutputCounter::nmbrCounters);
+    static constexpr uint32_t nmbrLatencyBuckets = 12U;
+
+    uint32_t counters[nmbrSubSystems][nmbrCounters];                 //
+    uint32_t outputCounters[nmbrOutputs][nmbrOutputCounters];        //
+    uint32_t latency[nmbrOutputs][nmbrLatencyBuckets];               // for each output, the number of items delivered within latencyLimit() of each bucket, and not within the one of the bucket before it
+    uint32_t highWaterMark;                                          // most bytes of the items buffer ever in use at once
+    uint32_t bufferSize;                                             // of the items buffer, in bytes
+
+    uint32_t get(subSystemType theSubSystem, logCounter theCounter) const {
+        return counters[static_cast<uint8_t>(theSubSystem)][static_cast<uint8_t>(theCounter)];
+    }
+    uint32_t get(uint32_t outputIndex, logOutputCounter theCounter) const {
+        return outputCounters[outputIndex][static_cast<uint8_t>(theCounter)];
+    }
+    uint32_t total(logCounter theCounter) const {        // sum over all subSystems
+        uint32_t result{0};
+        for (uint32_t subSystemIndex = 0; subSystemIndex < nmbrSubSystems; subSystemIndex++) {
+            result += counters[subSystemIndex][static_cast<uint8_t>(theCounter)];
+        }
+        return result;
+    }
+    uint32_t total(logOutputCounter theCounter) const {        // sum over all outputs
+        uint32_t result{0};
+        for (uint32_t outputIndex = 0; outputIndex < nmbrOutputs; outputIndex++) {
+            result += outputCounters[outputIndex][static_cast<uint8_t>(theCounter)];
+        }
+        return result;
+    }
+    uint32_t latencyPercentile(uint32_t outputIndex, uint32_t percent) const {        // in us, the latencyLimit() within which at least percent of the items delivered to this output were. 0 when none were
+        uint32_t delivered{0};
+        for (uint32_t bucketIndex = 0; bucketIndex < nmbrLatencyBuckets; bucketIndex++) {
+            delivered += latency[outputIndex][bucketIndex];
+        }
+        uint64_t wanted = ((static_cast<uint64_t>(delivered) * percent) + 99U) / 100U;
+        uint64_t counted{0};
+        for (uint32_t bucketIndex = 0; (bucketIndex < nmbrLatencyBuckets) && (delivered > 0); bucketIndex++) {
+            counted += latency[outputIndex][bucketIndex];
+            if (counted >= wanted) {
+                return latencyLimit(bucketIndex);
+            }
+        }
+        return 0;
+    }
+
+    static constexpr uint32_t latencyLimit(uint32_t bucketIndex) {        // in us, upper limit of a latency bucket : 4 us, 16 us, 64 us, ... 4.2 s, and no limit for the last one
+        return ((bucketIndex + 1U) < nmbrLatencyBuckets) ? (4U << (2U * bucketIndex)) : UINT32_MAX;
+    }
+    static uint32_t latencyBucket(uint32_t latency) {
+        uint32_t bucketIndex{0};
+        while ((latency >= 4U) && ((bucketIndex + 1U) < nmbrLatencyBuckets)) {
+            latency >>= 2;
+            bucketIndex++;
+        }
+        return bucketIndex;
+    }
+};
+
+template <typename subSystemType, uint32_t nmbrOutputs, bool enabled>
+class logMetrics {
+  public:
+    typedef logMetricsSnapshot<subSystemType, nmbrOutputs> snapshot;
+
+    void count(subSystemType theSubSystem, logCounter theCounter) {
+        counters[static_cast<uint8_t>(theSubSystem)][static_cast<uint8_t>(theCounter)].fetch_add(1U, std::memory_order_relaxed);
+    }
+    void count(uint32_t outputIndex, logOutputCounter theCounter, uint32_t amount = 1U) {
+        outputCounters[outputIndex][static_cast<uint8_t>(theCounter)].fetch_add(amount, std::memory_order_relaxed);
+    }
+    void countLatency(uint32_t outputIndex, uint32_t latency) {        // in us
+        latencies[outputIndex][snapshot::latencyBucket(latency)].fetch_add(1U, std::memory_order_relaxed);
+    }
+    void updateHighWaterMark(uint32_t level) {
+        uint32_t highest = highWaterMark.load(std::memory_order_relaxed);
+        while ((level > highest) && !highWaterMark.compare_exchange_weak(highest, level, std::memory_order_relaxed)) {        // on failure, compare_exchange_weak has reloaded highest
+        }
+    }
+    static uint32_t now() {        // stored in each item, for its latency
+        return logMicroseconds();
+    }
+    void get(snapshot& aSnapshot) const {
+        for (uint32_t subSystemIndex = 0; subSystemIndex < snapshot::nmbrSubSystems; subSystemIndex++) {
+            for (uint32_t counterIndex = 0; counterIndex < snapshot::nmbrCounters; counterIndex++) {
+                aSnapshot.counters[subSystemIndex][counterIndex] = counters[subSystemIndex][counterIndex].load(std::memory_order_relaxed);
+            }
+        }
+        for (uint32_t outputIndex = 0; outputIndex < nmbrOutputs; outputIndex++) {
+            for (uint32_t counterIndex = 0; counterIndex < snapshot::nmbrOutputCounters; counterIndex++) {
+                aSnapshot.outputCounters[outputIndex][counterIndex] = outputCounters[outputIndex][counterIndex].load(std::memory_order_relaxed);
+            }
+            for (uint32_t bucketIndex = 0; bucketIndex < snapshot::nmbrLatencyBuckets; bucketIndex++) {
+                aSnapshot.latency[outputIndex][bucketIndex] = latencies[outputIndex][bucketIndex].load(std::memory_order_relaxed);
+            }
+        }
+        aSnapshot.highWaterMark = highWaterMark.load(std::memory_order_relaxed);
+    }
+
+  private:
+    std::atomic<uint32_t> counters[snapshot::nmbrSubSystems][snapshot::nmbrCounters]{};
+    std::atomic<uint32_t> outputCounters[nmbrOutputs][snapshot::nmbrOutputCounters]{};
+    std::atomic<uint32_t> latencies[nmbrOutputs][snapshot::nmbrLatencyBuckets]{};
+    std::atomic<uint32_t> highWaterMark{0};
+};
+
+template <typename subSystemType, uint32_t nmbrOutputs>
+class logMetrics<subSystemType, nmbrOutputs, false> {        // metrics disabled : takes no memory, and counting costs nothing
+  public:
+    typedef logMetricsSnapshot<subSystemType, nmbrOutputs> snapshot;
+
+    void count(subSystemType, logCounter) {}
+    void count(uint32_t, logOutputCounter, uint32_t = 1U) {}
+    void countLatency(uint32_t, uint32_t) {}
+    void updateHighWaterMark(uint32_t) {}
+    static uint32_t now() {
+        return 0;
+    }
+    void get(snapshot& aSnapshot) const {
+        memset(static_cast<void*>(&aSnapshot), 0, sizeof(aSnapshot));
+    }
+};
@@ -2,27 +2,165 @@
 #include <stdint.h>
 #include "logginglevels.h"
 #include "subsystems.h"
+#include "lagpolicy.h"
+#include "logencoding.h"
+
+template <typename subSystemType>
+struct basicLogSpan {        // one formatted item, as handed to a batch output. The text is only valid during the call
+    const char* text;        // zero terminated, so it can also be used as a cstring. For a binary output, a frame ending with its zero delimiter, see logbinary.h
+    uint32_t length;         // number of chars in text, excluding the terminating zero
+    loggingLevel theLoggingLevel;
+    subSystemType theSubSystem;
+};
 
 // represents a destination to which we can send logging output, such as serial port, network, SD card, etc.
+// subSystemType is the enum of subSystems, its last value must be nmbrOfSubsystems
 
-class logOutput {
+template <typename subSystemType>
+class basicLogOutput {
   public:
-    explicit logOutput();
-
-    void setOutputDestination(bool (*aFunction)(const char *));                 // sets a pointer to a function handling the output of the logging to eg serial, network or file on SD card, etc.
-    bool isActive() const;                                                      //
-    void setColoredOutput(bool newSetting);                                     // set the colorize output option
-    bool isColoredOutput() const;                                                     //
-    void setIncludeTimestamp(bool newSetting);                                  // set the includeTimestamp option
-    bool hasTimestampIncluded() const;                                                  //
-    void setLoggingLevel(loggingLevel newLevel);                                // set the loggingLevel for a all subsystem
-    void setLoggingLevel(subSystem theSubSystem, loggingLevel newLevel);        // set the loggingLevel for a given subsystem
-    loggingLevel getLoggingLevel(subSystem theSubSystem) const;                 // returns the current loggingLevel for given subsystem
-    bool write(const char *) const;                                             // send cstyle string to the output
+    typedef basicLogSpan<subSystemType> logSpan;
+    explicit basicLogOutput() {}
+
+    void setOutputDestination(bool (*aFunction)(const char *));                     // sets a pointer to a function handling the output of the logging to eg serial, network or file on SD card, etc.
+    void setBatchOutputDestination(uint32_t (*aFunction)(const logSpan*, uint32_t));        // sets a pointer to a function handling a batch of items in one call, returning how many of them it accepted. Replaces the single item function
+    bool isActive() const;                                                          //
+    void setColoredOutput(bool newSetting);                                         // set the colorize output option
+    bool isColoredOutput() const;                                                         //
+    void setIncludeTimestamp(bool newSetting);                                      // set the includeTimestamp option
+    bool hasTimestampIncluded() const;                                                      //
+    void setEncoding(logEncoding newEncoding);                                      // set how items are rendered. logEncoding::binary is only used with a batch output, as the frames contain zeroes
+    logEncoding getEncoding() const;                                                // the encoding in use : text for a binary output without batch output
+    void setBinaryOutput(bool newSetting);                                          // set the binary output option, same as setEncoding(logEncoding::binary) or setEncoding(logEncoding::text)
+    bool isBinaryOutput() const;                                                    //
+    void setLagLimit(uint32_t newMaxLag, lagPolicy newPolicy);                      // how far, in bytes of the items buffer, this output may lag behind the newest item, and what to do when it lags further
+    uint32_t getLagLimit() const;                                                   //
+    lagPolicy getLagPolicy() const;                                                 //
+    void setLoggingLevel(loggingLevel newLevel);                                    // set the loggingLevel for a all subsystem
+    void setLoggingLevel(subSystemType theSubSystem, loggingLevel newLevel);        // set the loggingLevel for a given subsystem
+    loggingLevel getLoggingLevel(subSystemType theSubSystem) const;                 // returns the current loggingLevel for given subsystem
+    bool write(const char *) const;                                                 // send cstyle string to the output
+    uint32_t write(const logSpan* spans, uint32_t nmbrSpans) const;                 // send a batch of items to the output, returns the number of items accepted, starting from the first one
 
   private:
-    bool (*writeOutput)(const char *){nullptr};                                                                 // pointer to function outputting the logged data - 1 goes to eg serial port
-    bool colorOutput{false};                                                                                    // does this output wants colorization
-    bool addTimestamp{false};                                                                                   // does this output wants timestamps added
-    loggingLevel theLoggingLevel[static_cast<uint8_t>(subSystem::nmbrOfSubsystems)]{loggingLevel::None};        // for each subsystem, the loggingLevel for this output
+    bool (*writeOutput)(const char *){nullptr};                                                                     // pointer to function outputting the logged data - 1 goes to eg serial port
+    uint32_t (*writeBatch)(const logSpan*, uint32_t){nullptr};                                                       // pointer to function outputting a batch of items in one call
+    bool colorOutput{false};                                                                                        // does this output wants colorization
+    bool addTimestamp{false};                                                                                       // does this output wants timestamps added
+    logEncoding theEncoding{logEncoding::text};                                                                     // how this output wants the items rendered
+    uint32_t maxLag{UINT32_MAX};                                                                                    // number of bytes of the items buffer this output may lag behind
+    lagPolicy theLagPolicy{lagPolicy::hold};                                                                        // what to do when it lags further
+    loggingLevel theLoggingLevel[static_cast<uint8_t>(subSystemType::nmbrOfSubsystems)]{loggingLevel::None};        // for each subsystem, the loggingLevel for this output
 };
+
+typedef basicLogSpan<subSystem> logSpan;
+typedef basicLogOutput<subSystem> logOutput;
+
+template <typename subSystemType>
+bool basicLogOutput<subSystemType>::isActive() const {
+    return (writeOutput != nullptr) || (writeBatch != nullptr);
+}
+
+template <typename subSystemType>
+void basicLogOutput<subSystemType>::setLoggingLevel(loggingLevel newLevel) {
+    for (uint8_t i = 0; i < static_cast<uint8_t>(subSystemType::nmbrOfSubsystems); i++) {
+        theLoggingLevel[i] = newLevel;
+    }
+}
+
+template <typename subSystemType>
+void basicLogOutput<subSystemType>::setLoggingLevel(subSystemType theSubSystem, loggingLevel newLevel) {
+    theLoggingLevel[static_cast<uint8_t>(theSubSystem)] = newLevel;
+}
+
+template <typename subSystemType>
+loggingLevel basicLogOutput<subSystemType>::getLoggingLevel(subSystemType theSubSystem) const {
+    return theLoggingLevel[static_cast<uint8_t>(theSubSystem)];
+}
+
+template <typename subSystemType>
+void basicLogOutput<subSystemType>::setColoredOutput(bool newSetting) {
+    colorOutput = newSetting;
+}
+
+template <typename subSystemType>
+void basicLogOutput<subSystemType>::setIncludeTimestamp(bool newSetting) {
+    addTimestamp = newSetting;
+}
+
+template <typename subSystemType>
+void basicLogOutput<subSystemType>::setOutputDestination(bool (*aFunction)(const char *)) {
+    writeOutput = aFunction;
+    writeBatch  = nullptr;
+}
+
+template <typename subSystemType>
+void basicLogOutput<subSystemType>::setBatchOutputDestination(uint32_t (*aFunction)(const logSpan *, uint32_t)) {
+    writeBatch  = aFunction;
+    writeOutput = nullptr;
+}
+
+template <typename subSystemType>
+bool basicLogOutput<subSystemType>::write(const char *theContents) const {
+    return (*writeOutput)(theContents);
+}
+
+template <typename subSystemType>
+uint32_t basicLogOutput<subSystemType>::write(const logSpan *spans, uint32_t nmbrSpans) const {
+    if (writeBatch != nullptr) {
+        uint32_t accepted = (*writeBatch)(spans, nmbrSpans);
+        return (accepted < nmbrSpans) ? accepted : nmbrSpans;
+    }
+    for (uint32_t spanIndex = 0; spanIndex < nmbrSpans; spanIndex++) {        // single item output : one call per item
+        if ((writeOutput == nullptr) || !(*writeOutput)(spans[spanIndex].text)) {
+            return spanIndex;        // not accepted, so this item and the ones after it are retried later
+        }
+    }
+    return nmbrSpans;
+}
+
+template <typename subSystemType>
+bool basicLogOutput<subSystemType>::isColoredOutput() const {
+    return colorOutput;
+}
+
+template <typename subSystemType>
+bool basicLogOutput<subSystemType>::hasTimestampIncluded() const {
+    return addTimestamp;
+}
+
+template <typename subSystemType>
+void basicLogOutput<subSystemType>::setEncoding(logEncoding newEncoding) {
+    theEncoding = newEncoding;
+}
+
+template <typename subSystemType>
+logEncoding basicLogOutput<subSystemType>::getEncoding() const {
+    return ((theEncoding == logEncoding::binary) && (writeBatch == nullptr)) ? logEncoding::text : theEncoding;
+}
+
+template <typename subSystemType>
+void basicLogOutput<subSystemType>::setBinaryOutput(bool newSetting) {
+    theEncoding = newSetting ? logEncoding::binary : logEncoding::text;
+}
+
+template <typename subSystemType>
+bool basicLogOutput<subSystemType>::isBinaryOutput() const {
+    return (getEncoding() == logEncoding::binary);
+}
+
+template <typename subSystemType>
+void basicLogOutput<subSystemType>::setLagLimit(uint32_t newMaxLag, lagPolicy newPolicy) {
+    maxLag       = newMaxLag;
+    theLagPolicy = newPolicy;
+}
+
+template <typename subSystemType>
+uint32_t basicLogOutput<subSystemType>::getLagLimit() const {
+    return maxLag;
+}
+
+template <typename subSystemType>
+lagPolicy basicLogOutput<subSystemType>::getLagPolicy() const {
+    return theLagPolicy;
+}
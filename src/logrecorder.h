@@ -0,0 +1,104 @@
+#pragma once
+#include <stdint.h>
+#include <atomic>
+#include "logginglevels.h"
+#include "logarena.h"
+
+// Flight recorder : items which no output wants, eg. Debug in production, are not dropped but kept in a separate buffer, as they were logged and without formatting them.
+// When an item at the trigger level or above is logged, eg. an Error, the last of these items go to the outputs first, so the error comes with the context that led to it.
+// The recorder keeps the newest items : a new one discards the oldest ones until it fits. Recording is best effort, when another task is busy discarding or dumping, the item is lost.
+// Recording an item costs about what storing it in the items buffer costs. A dump only copies the records into the items buffer, they are formatted by the outputs as any other item.
+
+template <uint32_t size>
+class logRecorder {
+  public:
+    void setLevels(loggingLevel newRecordLevel, loggingLevel newTriggerLevel, uint32_t newMaxDumped) {        // see basicLog::setFlightRecorder()
+        maxDumped.store(newMaxDumped, std::memory_order_relaxed);
+        triggerLevel.store(newTriggerLevel, std::memory_order_relaxed);
+        recordLevel.store(newRecordLevel, std::memory_order_relaxed);
+    }
+    bool isRecorded(loggingLevel theLevel) const {        // is an item of this level, not wanted by any output, recorded
+        return (theLevel <= recordLevel.load(std::memory_order_relaxed)) && (theLevel != loggingLevel::None);
+    }
+    bool isTrigger(loggingLevel theLevel) const {        // does an item of this level dump the recorder
+        return (theLevel <= triggerLevel.load(std::memory_order_relaxed)) && (theLevel != loggingLevel::None);
+    }
+    bool reserve(uint32_t payloadLength, uint32_t& position) {        // reserves room for a new record, discarding the oldest ones. Returns false when the record must be dropped
+        while (!records.reserve(payloadLength, position)) {
+            if (!records.acquireConsumer()) {
+                return false;        // another task is discarding or dumping
+            }
+            uint32_t oldest;
+            bool discarded = records.peek(oldest);
+            if (discarded) {
+                records.pop();
+            }
+            records.releaseConsumer();
+            if (!discarded) {
+                return false;        // the oldest one is still being written, or it does not fit even when empty
+            }
+        }
+        return true;
+    }
+    uint8_t* payload(uint32_t position) {
+        return records.payload(position);
+    }
+    void publish(uint32_t position) {
+        records.publish(position);
+    }
+    template <typename sinkType>
+    uint32_t dump(sinkType sink) {        // hands the newest maxDumped records, oldest first, to sink(payload, payloadLength), and empties the recorder. Returns the number of records handed over
+        if (!records.acquireConsumer()) {
+            return 0;        // another task is dumping, so these records are already on their way
+        }
+        uint32_t nmbrRecords{0};
+        uint32_t position;
+        if (records.peek(position)) {
+            nmbrRecords++;
+            while (records.next(position)) {
+                nmbrRecords++;
+            }
+        }
+        uint32_t limit = maxDumped.load(std::memory_order_relaxed);
+        uint32_t skip  = (nmbrRecords > limit) ? (nmbrRecords - limit) : 0U;
+        for (uint32_t recordIndex = 0; (recordIndex < nmbrRecords) && records.peek(position); recordIndex++) {        // records published meanwhile are kept for the next dump
+            if (recordIndex >= skip) {
+                sink(records.payload(position), records.payloadLength(position));
+            }
+            records.pop();
+        }
+        records.releaseConsumer();
+        return nmbrRecords - skip;
+    }
+
+#ifndef unitTest
+  private:
+#endif
+    logArena<size> records;                                            //
+    std::atomic<loggingLevel> recordLevel{loggingLevel::None};         // None : nothing is recorded
+    std::atomic<loggingLevel> triggerLevel{loggingLevel::None};        // None : nothing triggers a dump
+    std::atomic<uint32_t> maxDumped{0};                                //
+};
+
+template <>
+class logRecorder<0> {        // flight recorder disabled : takes no memory, and costs nothing
+  public:
+    void setLevels(loggingLevel, loggingLevel, uint32_t) {}
+    bool isRecorded(loggingLevel) const {
+        return false;
+    }
+    bool isTrigger(loggingLevel) const {
+        return false;
+    }
+    bool reserve(uint32_t, uint32_t&) {
+        return false;
+    }
+    uint8_t* payload(uint32_t) {
+        return nullptr;
+    }
+    void publish(uint32_t) {}
+    template <typename sinkType>
+    uint32_t dump(sinkType) {
+        return 0;
+    }
+};
@@ -0,0 +1,78 @@
+#pragma once
+#include <stdint.h>
+#include <string.h>
+#include <atomic>
+
+// SubSystems registered by name at runtime, instead of the fixed enum of subsystems.h, so each module brings its own and no header has to be forked per product.
+// A registered subSystem gets a compact handle, which is used exactly as a value of the enum : as an index into dense tables, so the log() path does no lookup and no string compare.
+// All tables sized by subSystem, eg. levels per output, outputMasks, metrics and rate limits, have room for capacity handles, so memory stays bounded however many modules register.
+// When the registry is full, further names share the handle other, so their items are still logged.
+//
+// Usage :
+//   logRegistry<64> theSubSystems;                                                // global, so it is ready before static initialization of any module
+//   basicLog<registryLogConfig<64>> theLog;                                       // see logging.h
+//   static const logRegistry<64>::handle radio = theSubSystems.add("radio");      // in the module, registered during static initialization, or at startup
+//   theLog.log(radio, loggingLevel::Info, "joined");
+//   theLog.setLoggingLevel(0, theSubSystems.find("radio"), loggingLevel::Debug);  // eg. from a console command
+// Handles are only known at runtime, so the per subSystem compile-time filtering of logfilter.h does not apply to them : use LOGGING_MIN_LEVEL, or call the basicLog directly.
+
+template <uint8_t theCapacity>
+class logRegistry {
+  public:
+    static_assert(theCapacity >= 2U, "a registry needs room for other and at least one subSystem");
+    enum class handle : uint8_t {
+        other            = 0,                 // names which did not fit, or were not found
+        nmbrOfSubsystems = theCapacity        // as the last value of a subSystem enum
+    };
+    static constexpr uint32_t capacity = theCapacity;
+
+    handle add(const char* name) {        // registers name, or returns the handle it already has. name must stay valid, eg. a literal
+        handle existing = find(name);
+        if (existing != handle::other) {
+            return existing;
+        }
+        while (registering.test_and_set(std::memory_order_acquire)) {        // registering is rare, so a spin lock will do
+        }
+        existing         = find(name);        // another task may have registered it meanwhile
+        uint8_t nmbrUsed = used.load(std::memory_order_relaxed);
+        if ((existing == handle::other) && (nmbrUsed < theCapacity)) {
+            names[nmbrUsed].store(name, std::memory_order_relaxed);
+            used.store(static_cast<uint8_t>(nmbrUsed + 1U), std::memory_order_release);        // publishes the name
+            existing = static_cast<handle>(nmbrUsed);
+        } else if (existing == handle::other) {
+            overflowed.fetch_add(1U, std::memory_order_relaxed);
+        }
+        registering.clear(std::memory_order_release);
+        return existing;
+    }
+    handle find(const char* name) const {        // handle of a registered name, other when it is not registered
+        uint8_t nmbrUsed = used.load(std::memory_order_acquire);
+        for (uint8_t index = 1; index < nmbrUsed; index++) {
+            if (strcmp(names[index].load(std::memory_order_relaxed), name) == 0) {
+                return static_cast<handle>(index);
+            }
+        }
+        return handle::other;
+    }
+    const char* name(handle aHandle) const {        // "other" for handle::other and handles not registered
+        uint8_t index = static_cast<uint8_t>(aHandle);
+        if ((index == 0) || (index >= used.load(std::memory_order_acquire))) {
+            return "other";
+        }
+        return names[index].load(std::memory_order_relaxed);
+    }
+    uint32_t size() const {        // number of handles in use, including other
+        return used.load(std::memory_order_acquire);
+    }
+    uint32_t getOverflowed() const {        // number of add() calls which did not fit, and got handle other
+        return overflowed.load(std::memory_order_relaxed);
+    }
+
+#ifndef unitTest
+  private:
+#endif
+    std::atomic<const char*> names[theCapacity]{};          // index 0 is other
+    std::atomic<uint8_t> used{1};                           //
+    std::atomic<uint32_t> overflowed{0};                    //
+    std::atomic_flag registering = ATOMIC_FLAG_INIT;        // serializes add()
+};
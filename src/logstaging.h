@@ -0,0 +1,47 @@
+#pragma once
+#include <stdint.h>
+#include <atomic>
+#include "logarena.h"
+
+#if defined(ESP32)
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#endif
+
+// Optional staging buffers, so tasks on different threads / cores do not all contend for the head, tail and cache lines of the one shared buffer.
+// Each thread (native) or core (ESP32) appends to its own staging buffer. The task doing the output merges them into the shared buffer, oldest tick first.
+// Staging buffers are logArenas as well, so it is still safe when several tasks share one, eg. tasks on the same core.
+// Without threads or cores, eg. Teensy, everything goes to staging buffer 0, which only adds a copy, so there it is best left disabled.
+
+template <uint32_t nmbrBuffers, uint32_t bufferSize>
+class logStaging {
+  public:
+    logArena<bufferSize>* buffer(uint32_t bufferIndex) {
+        return &buffers[bufferIndex];
+    }
+    static uint32_t currentIndex() {        // the staging buffer of the calling thread / core
+#if defined(ESP32)
+        return static_cast<uint32_t>(xPortGetCoreID()) % nmbrBuffers;
+#elif !defined(ARDUINO)
+        static std::atomic<uint32_t> nmbrThreads{0};
+        static thread_local uint32_t threadIndex = nmbrThreads++;        // threads get the buffers in turn, the first time they log something
+        return threadIndex % nmbrBuffers;
+#else
+        return 0;
+#endif
+    }
+
+  private:
+    logArena<bufferSize> buffers[nmbrBuffers];
+};
+
+template <uint32_t bufferSize>
+class logStaging<0, bufferSize> {        // staging disabled : takes no memory
+  public:
+    logArena<bufferSize>* buffer(uint32_t) {
+        return nullptr;
+    }
+    static uint32_t currentIndex() {
+        return 0;
+    }
+};
@@ -0,0 +1,66 @@
+#include <string.h>        // required for memcpy()
+#include "logtimestamp.h"
+
+void logTimestamp::setTicksPerSecond(uint32_t newTicksPerSecond) {
+    ticksPerSecond = (newTicksPerSecond > 0) ? newTicksPerSecond : 1U;
+    cachedSecond   = UINT64_MAX;
+}
+
+uint32_t logTimestamp::getTicksPerSecond() const {
+    return ticksPerSecond;
+}
+
+uint32_t logTimestamp::format(uint64_t tick, char* destination) {
+    uint64_t second = tick / ticksPerSecond;
+    if (second != cachedSecond) {
+        uint32_t secondOfDay = static_cast<uint32_t>(second % secondsPerDay);
+        if ((cachedSecond == UINT64_MAX) || ((second / secondsPerDay) != (cachedSecond / secondsPerDay))) {        // other day : date needs to be rewritten as well
+            uint32_t year;
+            uint32_t month;
+            uint32_t day;
+            civilFromDays(static_cast<uint32_t>(second / secondsPerDay), year, month, day);
+            writeDigits(dateTime, year, 4);
+            dateTime[4] = '-';
+            writeDigits(dateTime + 5, month, 2);
+            dateTime[7] = '-';
+            writeDigits(dateTime + 8, day, 2);
+            dateTime[10] = 'T';
+            dateTime[13] = ':';
+            dateTime[16] = ':';
+        }
+        writeDigits(dateTime + dateLength, secondOfDay / 3600U, 2);
+        writeDigits(dateTime + dateLength + 3U, (secondOfDay / 60U) % 60U, 2);
+        writeDigits(dateTime + dateLength + 6U, secondOfDay % 60U, 2);
+        cachedSecond = second;
+    }
+
+    memcpy(destination, dateTime, dateTimeLength);
+    uint32_t length{dateTimeLength};
+    if (ticksPerSecond > 1U) {
+        destination[length++] = '.';
+        writeDigits(destination + length, static_cast<uint32_t>(((tick % ticksPerSecond) * 1000U) / ticksPerSecond), 3);
+        length += 3U;
+    }
+    destination[length++] = 'Z';
+    return length;
+}
+
+void logTimestamp::writeDigits(char* destination, uint32_t value, uint32_t nmbrDigits) {
+    while (nmbrDigits > 0) {
+        nmbrDigits--;
+        destination[nmbrDigits] = static_cast<char>('0' + (value % 10U));
+        value /= 10U;
+    }
+}
+
+void logTimestamp::civilFromDays(uint32_t days, uint32_t& year, uint32_t& month, uint32_t& day) {        // see http://howardhinnant.github.io/date_algorithms.html#civil_from_days
+    uint32_t shiftedDays  = days + 719468U;               // days since 0000-03-01, so a leap day is the last day of its year
+    uint32_t era          = shiftedDays / 146097U;        // periods of 400 years
+    uint32_t dayOfEra     = shiftedDays - (era * 146097U);
+    uint32_t yearOfEra    = (dayOfEra - (dayOfEra / 1460U) + (dayOfEra / 36524U) - (dayOfEra / 146096U)) / 365U;
+    uint32_t dayOfYear    = dayOfEra - ((365U * yearOfEra) + (yearOfEra / 4U) - (yearOfEra / 100U));
+    uint32_t shiftedMonth = ((5U * dayOfYear) + 2U) / 153U;        // 0 is March
+    day                   = dayOfYear - (((153U * shiftedMonth) + 2U) / 5U) + 1U;
+    month                 = (shiftedMonth < 10U) ? (shiftedMonth + 3U) : (shiftedMonth - 9U);
+    year                  = yearOfEra + (era * 400U) + ((month <= 2U) ? 1U : 0U);
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include <stdint.h>
+
+// Formats raw ticks, counted from 1970-01-01T00:00:00Z, into ISO-8601 timestamps such as "2022-01-29T19:46:51.123Z".
+// Items only store the raw tick, and the formatting is done at output time, only for outputs which want timestamps.
+// Consecutive items mostly share their date, and often their second, so the last formatted date and time is cached and only the digits that changed are rewritten.
+// Not thread safe : it is only used by the task having the consumer role.
+
+class logTimestamp {
+  public:
+    static constexpr uint32_t maxLength{24U};        // length of a timestamp with milliseconds, excluding the terminating zero
+
+    void setTicksPerSecond(uint32_t newTicksPerSecond);        // resolution of the ticks, eg. 1000 for milliseconds. With 1 tick per second, the timestamp has no fraction
+    uint32_t getTicksPerSecond() const;                        //
+    uint32_t format(uint64_t tick, char* destination);         // writes the timestamp for tick to destination, which needs room for maxLength chars. Returns the length, no terminating zero is written
+
+#ifndef unitTest
+  private:
+#endif
+    static constexpr uint32_t dateLength{11U};                 // "2022-01-29T"
+    static constexpr uint32_t dateTimeLength{19U};             // "2022-01-29T19:46:51"
+    static constexpr uint32_t secondsPerDay{86400U};
+    static void writeDigits(char* destination, uint32_t value, uint32_t nmbrDigits);
+    static void civilFromDays(uint32_t days, uint32_t& year, uint32_t& month, uint32_t& day);        // converts days since 1970-01-01 into a date
+
+    uint32_t ticksPerSecond{1000U};
+    uint64_t cachedSecond{UINT64_MAX};        // second since 1970-01-01T00:00:00Z held in dateTime, UINT64_MAX when nothing is cached
+    char dateTime[dateTimeLength];            // date and time of cachedSecond, without fraction and without terminating zero
+};
@@ -0,0 +1,133 @@
+#include "logwriter.h"
+
+logWriter::~logWriter() {
+    stop();
+}
+
+bool logWriter::isRunning() const {
+    return running.load();
+}
+
+#if defined(ESP32)
+
+bool logWriter::start(void (*aFunction)(void*), void* aContext, uint32_t pollIntervalInMs) {
+    if (running.load() || !finished.load()) {
+        return false;
+    }
+    work         = aFunction;
+    context      = aContext;
+    pollInterval = pollIntervalInMs;
+    running.store(true);
+    finished.store(false);
+    if (xTaskCreate(taskFunction, "uLog", taskStackSize, this, taskPriority, &task) != pdPASS) {
+        running.store(false);
+        finished.store(true);
+        return false;
+    }
+    return true;
+}
+
+void logWriter::stop() {
+    if (running.exchange(false)) {
+        wake();
+        while (!finished.load()) {        // let the task complete its round and delete itself
+            vTaskDelay(1);
+        }
+        task = nullptr;
+    }
+}
+
+void logWriter::wake() {
+    if (task != nullptr) {
+        if (xPortInIsrContext()) {
+            BaseType_t higherPriorityTaskWoken{pdFALSE};
+            vTaskNotifyGiveFromISR(task, &higherPriorityTaskWoken);
+            if (higherPriorityTaskWoken == pdTRUE) {
+                portYIELD_FROM_ISR();
+            }
+        } else {
+            xTaskNotifyGive(task);
+        }
+    }
+}
+
+void logWriter::yield() {
+    vTaskDelay(1);
+}
+
+void logWriter::taskFunction(void* aWriter) {
+    static_cast<logWriter*>(aWriter)->run();
+    static_cast<logWriter*>(aWriter)->finished.store(true);
+    vTaskDelete(nullptr);
+}
+
+void logWriter::run() {
+    while (running.load()) {
+        work(context);
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(pollInterval));        // task notifications are counted, so a wake() during work() is not lost
+    }
+    work(context);        // last round, for what was logged while stopping
+}
+
+#elif !defined(ARDUINO)
+
+bool logWriter::start(void (*aFunction)(void*), void* aContext, uint32_t pollIntervalInMs) {
+    if (running.load() || thread.joinable()) {
+        return false;
+    }
+    work         = aFunction;
+    context      = aContext;
+    pollInterval = pollIntervalInMs;
+    running.store(true);
+    thread = std::thread(&logWriter::run, this);
+    return true;
+}
+
+void logWriter::stop() {
+    if (running.exchange(false)) {
+        wake();
+        thread.join();
+    }
+}
+
+void logWriter::wake() {
+    pending.store(true);
+    if (sleeping.load()) {
+        std::lock_guard<std::mutex> lock(mutex);        // makes sure the writer is really waiting, so it can't miss the notification
+        wakeUp.notify_one();
+    }
+}
+
+void logWriter::yield() {
+    std::this_thread::yield();
+}
+
+void logWriter::run() {
+    while (running.load()) {
+        work(context);
+        std::unique_lock<std::mutex> lock(mutex);
+        sleeping.store(true);
+        wakeUp.wait_for(lock, std::chrono::milliseconds(pollInterval), [this]() { return pending.load() || !running.load(); });
+        sleeping.store(false);
+        pending.store(false);
+    }
+    work(context);        // last round, for what was logged while stopping
+}
+
+#else
+
+// no threads on this platform : items are output by calling flush()
+
+bool logWriter::start(void (*)(void*), void*, uint32_t) {
+    return false;
+}
+
+void logWriter::stop() {}
+
+void logWriter::wake() {}
+
+void logWriter::yield() {}
+
+void logWriter::run() {}
+
+#endif
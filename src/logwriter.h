@@ -0,0 +1,52 @@
+#pragma once
+#include <stdint.h>
+#include <atomic>
+
+#if defined(ESP32)
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#elif !defined(ARDUINO)
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#endif
+
+// Runs a function on a dedicated thread (native) or FreeRTOS task (ESP32), each time it is woken up, or at least every pollInterval.
+// Used by uLog to output its items in the background, so a slow output does not stall the tasks doing the logging.
+// On other platforms there are no threads, so start() fails and the items need to be output by calling flush().
+
+class logWriter {
+  public:
+    ~logWriter();
+    bool start(void (*aFunction)(void*), void* aContext, uint32_t pollIntervalInMs);        // returns false when this platform does not support it, or when it is already running
+    void stop();                                                                             // waits until the current round is done
+    bool isRunning() const;
+    void wake();             // triggers a new round, without blocking. On ESP32 it can also be called from an ISR
+    static void yield();        // gives other tasks a chance to run, when waiting for the writer
+
+#if defined(ESP32)
+    static constexpr uint32_t taskStackSize{4096U};        // stack of the FreeRTOS task, in bytes
+    static constexpr uint32_t taskPriority{1U};            //
+#endif
+
+#ifndef unitTest
+  private:
+#endif
+    void run();
+    void (*work)(void*){nullptr};             // function to run
+    void* context{nullptr};                   // argument passed to it
+    uint32_t pollInterval{10U};               // in ms
+    std::atomic<bool> running{false};         // set while the writer should keep running
+    std::atomic<bool> sleeping{false};        // set while the writer is waiting for a wake()
+    std::atomic<bool> pending{false};         // set by wake(), so a wake() while a round is ongoing is not lost
+
+#if defined(ESP32)
+    static void taskFunction(void* aWriter);
+    TaskHandle_t task{nullptr};
+    std::atomic<bool> finished{true};
+#elif !defined(ARDUINO)
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable wakeUp;
+#endif
+};
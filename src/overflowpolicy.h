@@ -0,0 +1,11 @@
+#pragma once
+#include <stdint.h>
+
+// what to do with a new item when the items buffer is full
+
+enum class overflowPolicy : uint8_t {
+    dropOldest,        // discard the oldest items to make room for the new one
+    dropNewest,        // keep the buffer as is, the new item is dropped
+    block,             // wait until there is room : outputs the buffer, or lets the writer do so. Never use this from an ISR
+    sample             // keep only one out of every sampleRate new items, discarding the oldest to make room for it, drop the others
+};
@@ -1,6 +1,7 @@
 #pragma once
 #include <stdint.h>
 
+// the fixed subSystems of uLog. To have modules register their own subSystems at runtime, see logregistry.h
 enum class subSystem : uint8_t {
     general,
     memoryUsage,
@@ -0,0 +1,190 @@
+// Benchmarks of the cost of logging, run with : pio test -e benchmark
+// Each result is printed as one line, starting with BENCHMARK and followed by a JSON object, so results can be collected and compared by a script :
+// BENCHMARK {"name":"log_stored","bufferSize":512,"outputs":1,"meanNs":41.3,"p50Ns":38,"p99Ns":61}
+// Latencies are measured per call with steady_clock, so they include the overhead of reading the clock, which is reported as clock_overhead.
+
+#include <stdio.h>
+#include <algorithm>
+#include <chrono>
+#include <unity.h>
+#include "logging.h"
+
+static constexpr uint32_t nmbrSamples = 100000;
+uint32_t samples[nmbrSamples];        // duration in ns of each measured call
+
+template <uint32_t theBufferSize, uint32_t theNmbrOutputs>
+struct benchmarkConfig : logConfig {
+    static constexpr uint32_t bufferSize     = theBufferSize;
+    static constexpr uint32_t maxNmbrOutputs = theNmbrOutputs;
+    static constexpr uint32_t recorderSize   = theBufferSize;
+};
+
+uint32_t nullOutput(const logSpan* spans, uint32_t nmbrSpans) {        // accepts everything, so we only measure the logging itself
+    return nmbrSpans;
+}
+
+uint32_t elapsed(std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point stop) {
+    return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count());
+}
+
+void report(const char* name, uint32_t bufferSize, uint32_t nmbrOutputs) {
+    uint64_t total{0};
+    for (uint32_t sample = 0; sample < nmbrSamples; sample++) {
+        total += samples[sample];
+    }
+    std::sort(samples, samples + nmbrSamples);
+    printf("BENCHMARK {\"name\":\"%s\",\"bufferSize\":%u,\"outputs\":%u,\"meanNs\":%.1f,\"p50Ns\":%u,\"p99Ns\":%u}\n", name, static_cast<unsigned>(bufferSize), static_cast<unsigned>(nmbrOutputs), static_cast<double>(total) / nmbrSamples, static_cast<unsigned>(samples[nmbrSamples / 2]), static_cast<unsigned>(samples[(nmbrSamples * 99U) / 100U]));
+}
+
+template <typename logType, typename callType>
+void measure(const char* name, logType& aLog, callType call) {        // times each call separately. Every now and then the buffer is flushed, outside of the measurement, so it never overflows
+    static constexpr uint32_t callsPerFlush = logType::bufferSize / 64U;
+    for (uint32_t sample = 0; sample < callsPerFlush; sample++) {        // warm up
+        call(sample);
+    }
+    aLog.flush();
+    for (uint32_t sample = 0; sample < nmbrSamples; sample++) {
+        if ((sample % callsPerFlush) == 0) {
+            aLog.flush();
+        }
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        call(sample);
+        samples[sample] = elapsed(start, std::chrono::steady_clock::now());
+    }
+    aLog.flush();
+    report(name, logType::bufferSize, logType::maxNmbrOutputs);
+}
+
+template <typename logType>
+void measureDrain(const char* name, logType& aLog) {        // time to output a full buffer, per item
+    static constexpr uint32_t itemsPerFlush = logType::bufferSize / 64U;
+    for (uint32_t sample = 0; sample < nmbrSamples; sample++) {
+        if ((sample % itemsPerFlush) == 0) {
+            for (uint32_t index = 0; index < itemsPerFlush; index++) {
+                aLog.log(subSystem::general, loggingLevel::Info, "temperature 21.5 C");
+            }
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            aLog.flush();
+            uint32_t perItem = elapsed(start, std::chrono::steady_clock::now()) / itemsPerFlush;
+            for (uint32_t index = sample; (index < (sample + itemsPerFlush)) && (index < nmbrSamples); index++) {
+                samples[index] = perItem;
+            }
+        }
+    }
+    report(name, logType::bufferSize, logType::maxNmbrOutputs);
+}
+
+template <uint32_t bufferSize, uint32_t nmbrOutputs>
+void benchmarkConfiguration() {
+    typedef basicLog<benchmarkConfig<bufferSize, nmbrOutputs>> logType;
+    static logType aLog;        // static, as it can be too large for the stack
+    for (uint32_t outputIndex = 0; outputIndex < nmbrOutputs; outputIndex++) {
+        aLog.setBatchOutput(outputIndex, nullOutput);
+        aLog.setLoggingLevel(outputIndex, loggingLevel::Info);
+    }
+
+    measure("log_filtered_out", aLog, [](uint32_t sample) { aLog.log(subSystem::general, loggingLevel::Debug, "not wanted by any output"); });
+    measure("log_lazy_filtered_out", aLog, [](uint32_t sample) { aLog.log(subSystem::general, loggingLevel::Debug, [sample](char* buffer, uint32_t length) { snprintf(buffer, length, "sensor %u", static_cast<unsigned>(sample)); }); });        // the message is never made
+    measure("log_stored", aLog, [](uint32_t sample) { aLog.log(subSystem::general, loggingLevel::Info, "temperature 21.5 C"); });
+    measure("log_deferred", aLog, [](uint32_t sample) { aLog.logDeferred(subSystem::general, loggingLevel::Info, "sensor %u : %d.%u C", sample & 0x0FU, 21, 5U); });
+    measure("snprintf_output", aLog, [](uint32_t sample) { aLog.snprintf(subSystem::general, loggingLevel::Info, "sensor %u : %d.%u C", sample & 0x0FU, 21, 5U); });
+    aLog.setFlightRecorder(loggingLevel::Debug, loggingLevel::Error);
+    measure("log_recorded", aLog, [](uint32_t sample) { aLog.logDeferred(subSystem::general, loggingLevel::Debug, "sensor %u : %d.%u C", sample & 0x0FU, 21, 5U); });        // to compare with log_deferred
+    aLog.setFlightRecorder(loggingLevel::None);
+    measureDrain("flush_per_item", aLog);
+    TEST_ASSERT_EQUAL_UINT32(0, aLog.getDroppedItems());        // the measurements must not include overflow handling
+}
+
+void test_clock_overhead() {
+    for (uint32_t sample = 0; sample < nmbrSamples; sample++) {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        samples[sample]                             = elapsed(start, std::chrono::steady_clock::now());
+    }
+    report("clock_overhead", 0, 0);
+}
+
+template <typename callType>
+void measureFormat(const char* name, callType call) {        // times a call on its own, without logging, eg. formatting
+    for (uint32_t sample = 0; sample < 1000; sample++) {        // warm up
+        call(sample);
+    }
+    for (uint32_t sample = 0; sample < nmbrSamples; sample++) {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        call(sample);
+        samples[sample] = elapsed(start, std::chrono::steady_clock::now());
+    }
+    report(name, 0, 0);
+}
+
+char formatted[logItem::maxItemLength];
+static constexpr const char* telemetryFormat = "sensor %u : %d.%u C, rssi %d, vbat %.2f V, %s";        // a typical telemetry message
+
+void test_format() {        // the built-in conversions of logconvert.h, used by snprintf() and logDeferred(), versus the snprintf() of the platform
+    measureFormat("format_platform_snprintf", [](uint32_t sample) { snprintf(formatted, sizeof(formatted), telemetryFormat, sample & 0x0FU, 21, 5U, -71 - static_cast<int>(sample & 0x07U), 3.3 + (sample & 0x03U) * 0.01, "ok"); });
+    measureFormat("format_builtin", [](uint32_t sample) {
+        char packed[logItem::maxItemLength];
+        uint32_t packedLength = logArgs::pack(packed, sizeof(packed), sample & 0x0FU, 21, 5U, -71 - static_cast<int>(sample & 0x07U), 3.3 + (sample & 0x03U) * 0.01, "ok");
+        logArgs::render(formatted, sizeof(formatted), telemetryFormat, packed, packedLength);
+    });
+}
+
+static constexpr const char* benchmarkPath = "/tmp/ulog-benchmark.log";
+FILE* naiveFile{nullptr};
+logFileSink benchmarkFile;
+static constexpr const char* fileLine = "2022-01-29T19:46:51.123Z I temperature 21.5 C\n";
+
+bool naiveFileOutput(const char* line) {        // what an application does without logFileSink : a system call per item
+    return (fputs(line, naiveFile) >= 0) && (fflush(naiveFile) == 0);
+}
+
+uint32_t fileSinkOutput(const logSpan* spans, uint32_t nmbrSpans) {
+    return benchmarkFile.write(spans, nmbrSpans);
+}
+
+void test_file_output() {        // writing items to a file : a naive output, versus logFileSink
+    naiveFile = fopen(benchmarkPath, "w");
+    measureFormat("file_naive_write", [](uint32_t sample) { naiveFileOutput(fileLine); });
+    benchmarkFile.open(benchmarkPath, 64U * 1024U * 1024U, 1U);
+    measureFormat("file_sink_write", [](uint32_t sample) { benchmarkFile.write(fileLine); });
+
+    typedef basicLog<benchmarkConfig<8192, 1>> logType;
+    static logType aLog;
+    aLog.setLoggingLevel(0, loggingLevel::Info);
+    aLog.setOutput(0, naiveFileOutput);
+    measureDrain("file_naive_flush_per_item", aLog);
+    aLog.setBatchOutput(0, fileSinkOutput);
+    measureDrain("file_sink_flush_per_item", aLog);
+    TEST_ASSERT_EQUAL_UINT32(0, aLog.getDroppedItems());
+    fclose(naiveFile);
+    benchmarkFile.close();
+    remove(benchmarkPath);
+    remove("/tmp/ulog-benchmark.log.1");
+}
+
+void test_buffer_512_outputs_1() {
+    benchmarkConfiguration<512, 1>();
+}
+
+void test_buffer_512_outputs_4() {
+    benchmarkConfiguration<512, 4>();
+}
+
+void test_buffer_8192_outputs_1() {
+    benchmarkConfiguration<8192, 1>();
+}
+
+void test_buffer_8192_outputs_4() {
+    benchmarkConfiguration<8192, 4>();
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_clock_overhead);
+    RUN_TEST(test_format);
+    RUN_TEST(test_buffer_512_outputs_1);
+    RUN_TEST(test_buffer_512_outputs_4);
+    RUN_TEST(test_buffer_8192_outputs_1);
+    RUN_TEST(test_buffer_8192_outputs_4);
+    RUN_TEST(test_file_output);
+    UNITY_END();
+}
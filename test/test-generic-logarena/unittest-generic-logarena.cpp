@@ -0,0 +1,266 @@
+#define unitTest
+#include <string.h>
+#include <unity.h>
+#include "logarena.h"
+
+typedef logArena<128> testArena;
+static constexpr uint32_t headerSize = testArena::headerSize;
+
+void test_logArena_initialization() {
+    testArena anArena;
+    uint32_t position;
+    TEST_ASSERT_EQUAL_UINT32(0, anArena.level());        // empty after creation
+    TEST_ASSERT_FALSE(anArena.peek(position));           // nothing to consume
+    TEST_ASSERT_TRUE(anArena.acquireConsumer());         // consumer role can only be taken once
+    TEST_ASSERT_FALSE(anArena.acquireConsumer());        //
+    anArena.releaseConsumer();                           //
+    TEST_ASSERT_TRUE(anArena.acquireConsumer());         //
+}
+
+void test_logArena_recordLength() {
+    TEST_ASSERT_EQUAL_UINT32(headerSize, testArena::recordLength(0));                      // empty payload only takes the header
+    TEST_ASSERT_EQUAL_UINT32(headerSize + testArena::alignment, testArena::recordLength(1));        // payload is rounded up to alignment
+    TEST_ASSERT_EQUAL_UINT32(headerSize + testArena::alignment, testArena::recordLength(testArena::alignment));
+}
+
+void test_logArena_variable_length() {
+    testArena anArena;
+    uint32_t position;
+    TEST_ASSERT_TRUE(anArena.reserve(5, position));        // records of different length are packed back to back
+    TEST_ASSERT_EQUAL_UINT32(0, position);
+    memcpy(anArena.payload(position), "abcd", 5);
+    anArena.publish(position);
+    TEST_ASSERT_TRUE(anArena.reserve(20, position));
+    TEST_ASSERT_EQUAL_UINT32(testArena::recordLength(5), position);
+    memcpy(anArena.payload(position), "0123456789012345678", 20);
+    anArena.publish(position);
+    TEST_ASSERT_EQUAL_UINT32(testArena::recordLength(5) + testArena::recordLength(20), anArena.level());
+
+    TEST_ASSERT_TRUE(anArena.peek(position));        // read them back in order
+    TEST_ASSERT_EQUAL_STRING("abcd", reinterpret_cast<const char*>(anArena.payload(position)));
+    anArena.pop();
+    TEST_ASSERT_TRUE(anArena.peek(position));
+    TEST_ASSERT_EQUAL_STRING("0123456789012345678", reinterpret_cast<const char*>(anArena.payload(position)));
+    anArena.pop();
+    TEST_ASSERT_FALSE(anArena.peek(position));
+    TEST_ASSERT_EQUAL_UINT32(0, anArena.level());
+}
+
+void test_logArena_full() {
+    testArena anArena;
+    uint32_t position;
+    uint32_t payloadLength = 32 - headerSize;        // records of 32 bytes, so 4 fit
+    for (uint32_t i = 0; i < 4; i++) {
+        TEST_ASSERT_TRUE(anArena.reserve(payloadLength, position));
+        anArena.publish(position);
+    }
+    TEST_ASSERT_FALSE(anArena.reserve(0, position));        // even the smallest record does not fit anymore
+    TEST_ASSERT_EQUAL_UINT32(128, anArena.level());
+    TEST_ASSERT_TRUE(anArena.peek(position));
+    anArena.pop();
+    TEST_ASSERT_TRUE(anArena.reserve(payloadLength, position));        // room again after consuming one
+}
+
+void test_logArena_wrap_around() {
+    testArena anArena;
+    uint32_t position;
+    uint32_t payloadLength = 48 - headerSize;        // records of 48 bytes : 2 fit before the end, the third one does not fit in the 32 bytes left
+    TEST_ASSERT_TRUE(anArena.reserve(payloadLength, position));
+    anArena.publish(position);
+    TEST_ASSERT_TRUE(anArena.reserve(payloadLength, position));
+    anArena.publish(position);
+    TEST_ASSERT_FALSE(anArena.reserve(payloadLength, position));        // 32 bytes free at the end, but record must not wrap
+    TEST_ASSERT_TRUE(anArena.peek(position));
+    anArena.pop();
+    TEST_ASSERT_TRUE(anArena.reserve(payloadLength, position));        // fits at the start, after a 32 byte padding record at the end
+    TEST_ASSERT_EQUAL_UINT32(128, position);
+    memcpy(anArena.payload(position), "wrapped", 8);
+    anArena.publish(position);
+    TEST_ASSERT_EQUAL_UINT32(48 + 32 + 48, anArena.level());
+
+    TEST_ASSERT_TRUE(anArena.peek(position));
+    TEST_ASSERT_EQUAL_UINT32(48, position);
+    anArena.pop();
+    TEST_ASSERT_TRUE(anArena.peek(position));        // padding is skipped
+    TEST_ASSERT_EQUAL_UINT32(128, position);
+    TEST_ASSERT_EQUAL_STRING("wrapped", reinterpret_cast<const char*>(anArena.payload(position)));
+    anArena.pop();
+    TEST_ASSERT_EQUAL_UINT32(0, anArena.level());
+}
+
+void test_logArena_publish_order() {
+    testArena anArena;
+    uint32_t first;
+    uint32_t second;
+    uint32_t position;
+    TEST_ASSERT_TRUE(anArena.reserve(4, first));
+    TEST_ASSERT_TRUE(anArena.reserve(4, second));
+    anArena.publish(second);
+    TEST_ASSERT_FALSE(anArena.peek(position));        // oldest one is not yet published
+    anArena.publish(first);
+    TEST_ASSERT_TRUE(anArena.peek(position));
+    TEST_ASSERT_EQUAL_UINT32(first, position);
+    anArena.pop();
+    TEST_ASSERT_TRUE(anArena.peek(position));
+    TEST_ASSERT_EQUAL_UINT32(second, position);
+}
+
+void test_logArena_next() {
+    testArena anArena;
+    uint32_t position;
+    uint32_t payloadLength = 48 - headerSize;
+    uint32_t positions[2];
+    TEST_ASSERT_TRUE(anArena.reserve(payloadLength, position));
+    anArena.publish(position);
+    TEST_ASSERT_TRUE(anArena.reserve(payloadLength, positions[0]));
+    anArena.publish(positions[0]);
+    TEST_ASSERT_TRUE(anArena.peek(position));
+    anArena.pop();
+    TEST_ASSERT_TRUE(anArena.reserve(payloadLength, positions[1]));        // after a padding record
+    TEST_ASSERT_TRUE(anArena.peek(position));
+    TEST_ASSERT_FALSE(anArena.next(position));        // not yet published
+    anArena.publish(positions[1]);
+    TEST_ASSERT_TRUE(anArena.peek(position));
+    TEST_ASSERT_EQUAL_UINT32(positions[0], position);
+    TEST_ASSERT_TRUE(anArena.next(position));        // padding is skipped
+    TEST_ASSERT_EQUAL_UINT32(positions[1], position);
+    TEST_ASSERT_FALSE(anArena.next(position));        // end of the records
+    TEST_ASSERT_EQUAL_UINT32(48 + 32 + 48, anArena.level());        // nothing consumed
+}
+
+void test_logArena_next_full() {
+    testArena anArena;
+    uint32_t position;
+    for (uint32_t i = 0; i < 4; i++) {
+        TEST_ASSERT_TRUE(anArena.reserve(32 - headerSize, position));
+        anArena.publish(position);
+    }
+    TEST_ASSERT_TRUE(anArena.peek(position));
+    for (uint32_t i = 0; i < 3; i++) {
+        TEST_ASSERT_TRUE(anArena.next(position));
+    }
+    TEST_ASSERT_FALSE(anArena.next(position));        // buffer is full : the word after the last record is the header of the first one, so it must not be seen again
+}
+
+void test_logArena_attach() {
+    alignas(logArenaRegion<128>) static uint8_t memory[sizeof(logArenaRegion<128>)];        // static, as a region not cleared at reset would be
+    memset(memory, 0xA5, sizeof(memory));                                                   // garbage, as after power up
+    testArena anArena;
+    uint32_t position;
+    TEST_ASSERT_TRUE(anArena.reserve(5, position));        // record written before attaching
+    memcpy(anArena.payload(position), "abcd", 5);
+    anArena.publish(position);
+
+    TEST_ASSERT_FALSE(anArena.attach(memory, sizeof(memory) - 1U));        // too small
+    TEST_ASSERT_FALSE(anArena.attach(memory, sizeof(memory)));             // no records of a previous run
+    TEST_ASSERT_TRUE(anArena.peek(position));                             // record written before is moved along
+    TEST_ASSERT_EQUAL_STRING("abcd", reinterpret_cast<const char*>(anArena.payload(position)));
+    TEST_ASSERT_EQUAL_UINT32(testArena::recordLength(5), anArena.level());
+}
+
+void test_logArena_recover() {
+    alignas(logArenaRegion<128>) static uint8_t memory[sizeof(logArenaRegion<128>)];
+    memset(memory, 0, sizeof(memory));
+    uint32_t position;
+    {
+        logArena<128, false> anArena;                  // without region of its own, nothing can be stored until attached
+        TEST_ASSERT_FALSE(anArena.isAttached());        //
+        TEST_ASSERT_FALSE(anArena.reserve(5, position));
+        TEST_ASSERT_FALSE(anArena.attach(memory, sizeof(memory)));
+        TEST_ASSERT_TRUE(anArena.isAttached());
+        for (uint32_t i = 0; i < 5; i++) {        // 5 records, of which the first one is consumed
+            TEST_ASSERT_TRUE(anArena.reserve(16, position));
+            memcpy(anArena.payload(position), "record", 7);
+            anArena.payload(position)[6] = static_cast<uint8_t>('0' + i);
+            anArena.publish(position);
+            if (i == 1) {
+                TEST_ASSERT_TRUE(anArena.peek(position));
+                anArena.pop();
+            }
+        }
+        TEST_ASSERT_TRUE(anArena.reserve(5, position));        // reserved but never published : crash while writing it
+    }
+    logArena<128, false> anArena;        // the next run
+    TEST_ASSERT_TRUE(anArena.attach(memory, sizeof(memory)));
+    const char* expected[] = {"record1", "record2", "record3", "record4"};
+    TEST_ASSERT_TRUE(anArena.peek(position));
+    for (uint32_t i = 0; i < 4; i++) {
+        TEST_ASSERT_EQUAL_MEMORY(expected[i], anArena.payload(position), 7);
+        TEST_ASSERT_EQUAL(i < 3, anArena.next(position));        // unpublished record is skipped
+    }
+
+    memory[8] ^= 1U;        // a region with another layout, or corrupted, is not used
+    TEST_ASSERT_FALSE(anArena.attach(memory, sizeof(memory)));
+    TEST_ASSERT_FALSE(anArena.peek(position));
+    TEST_ASSERT_EQUAL_UINT32(0, anArena.level());
+}
+
+void test_logArena_recover_corrupt() {
+    alignas(logArenaRegion<128>) static uint8_t memory[sizeof(logArenaRegion<128>)];
+    memset(memory, 0, sizeof(memory));
+    uint32_t position;
+    {
+        logArena<128, false> anArena;
+        anArena.attach(memory, sizeof(memory));
+        TEST_ASSERT_TRUE(anArena.reserve(5, position));
+        anArena.publish(position);
+        TEST_ASSERT_TRUE(anArena.reserve(5, position));
+        anArena.header(position).store(0);        // reserved, but reset before its header was written
+        TEST_ASSERT_TRUE(anArena.reserve(5, position));
+        anArena.publish(position);
+    }
+    logArena<128, false> anArena;
+    TEST_ASSERT_TRUE(anArena.attach(memory, sizeof(memory)));
+    TEST_ASSERT_EQUAL_UINT32(testArena::recordLength(5), anArena.level());        // records from there on are lost
+    TEST_ASSERT_TRUE(anArena.peek(position));
+    TEST_ASSERT_FALSE(anArena.next(position));
+    TEST_ASSERT_TRUE(anArena.reserve(5, position));        // and their room is free again
+    TEST_ASSERT_EQUAL_UINT32(testArena::recordLength(5), position);
+}
+
+void test_logArena_seek() {
+    testArena anArena;
+    uint32_t position;
+    uint32_t payloadLength = 48 - headerSize;
+    uint32_t positions[2];
+    TEST_ASSERT_TRUE(anArena.reserve(payloadLength, position));
+    anArena.publish(position);
+    TEST_ASSERT_TRUE(anArena.reserve(payloadLength, positions[0]));
+    anArena.publish(positions[0]);
+    TEST_ASSERT_TRUE(anArena.peek(position));
+    anArena.pop();
+    TEST_ASSERT_TRUE(anArena.reserve(payloadLength, positions[1]));        // after a padding record
+    position = positions[0] + 48;
+    TEST_ASSERT_FALSE(anArena.seek(position));        // padding is skipped, but the record after it is not yet published
+    TEST_ASSERT_EQUAL_UINT32(positions[1], position);
+    anArena.publish(positions[1]);
+    position = positions[0] + 48;
+    TEST_ASSERT_TRUE(anArena.seek(position));
+    TEST_ASSERT_EQUAL_UINT32(positions[1], position);
+    TEST_ASSERT_FALSE(anArena.next(position));
+    TEST_ASSERT_EQUAL_UINT32(anArena.writePosition(), position);        // end of the records
+
+    anArena.popUntil(positions[1]);        // the record and the padding before it
+    TEST_ASSERT_EQUAL_UINT32(positions[1], anArena.readPosition());
+    TEST_ASSERT_EQUAL_UINT32(48, anArena.level());
+    anArena.popUntil(anArena.writePosition());
+    TEST_ASSERT_EQUAL_UINT32(0, anArena.level());
+    TEST_ASSERT_FALSE(anArena.peek(position));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_logArena_initialization);
+    RUN_TEST(test_logArena_recordLength);
+    RUN_TEST(test_logArena_variable_length);
+    RUN_TEST(test_logArena_full);
+    RUN_TEST(test_logArena_wrap_around);
+    RUN_TEST(test_logArena_publish_order);
+    RUN_TEST(test_logArena_next);
+    RUN_TEST(test_logArena_next_full);
+    RUN_TEST(test_logArena_seek);
+    RUN_TEST(test_logArena_attach);
+    RUN_TEST(test_logArena_recover);
+    RUN_TEST(test_logArena_recover_corrupt);
+    UNITY_END();
+}
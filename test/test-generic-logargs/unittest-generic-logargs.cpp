@@ -0,0 +1,90 @@
+#define unitTest
+#include <string.h>
+#include <math.h>
+#include <unity.h>
+#include "logargs.h"
+
+void test_logArgs_pack() {
+    char buffer[64];
+    TEST_ASSERT_EQUAL_UINT32(0, logArgs::pack(buffer, sizeof(buffer)));                        // no arguments
+    TEST_ASSERT_EQUAL_UINT32(5, logArgs::pack(buffer, sizeof(buffer), 1234));                  // type + 4 bytes
+    TEST_ASSERT_EQUAL_UINT8(logArgType::int32, buffer[0]);                                     //
+    TEST_ASSERT_EQUAL_UINT32(5, logArgs::pack(buffer, sizeof(buffer), 1234ULL));               // 64 bit type, but small value is stored in 32 bits
+    TEST_ASSERT_EQUAL_UINT8(logArgType::uint32, buffer[0]);                                    //
+    TEST_ASSERT_EQUAL_UINT32(9, logArgs::pack(buffer, sizeof(buffer), 0x123456789LL));         // large value needs 64 bits
+    TEST_ASSERT_EQUAL_UINT8(logArgType::int64, buffer[0]);                                     //
+    TEST_ASSERT_EQUAL_UINT32(9, logArgs::pack(buffer, sizeof(buffer), 1.5F));                  // floats are stored as double
+    TEST_ASSERT_EQUAL_UINT8(logArgType::float64, buffer[0]);                                   //
+    TEST_ASSERT_EQUAL_UINT32(7, logArgs::pack(buffer, sizeof(buffer), "lorem"));               // strings are copied, including terminating zero
+    TEST_ASSERT_EQUAL_UINT8(logArgType::string, buffer[0]);                                    //
+    TEST_ASSERT_EQUAL_STRING("lorem", buffer + 1);                                             //
+    TEST_ASSERT_EQUAL_UINT32(12, logArgs::pack(buffer, sizeof(buffer), 'A', "lorem"));        // multiple arguments
+}
+
+void test_logArgs_pack_overflow() {
+    char buffer[8];
+    TEST_ASSERT_EQUAL_UINT32(5, logArgs::pack(buffer, sizeof(buffer), 1, 2));                  // second int does not fit anymore
+    TEST_ASSERT_EQUAL_UINT32(8, logArgs::pack(buffer, sizeof(buffer), "lorem ipsum"));         // too long string is truncated
+    TEST_ASSERT_EQUAL_STRING("lorem ", buffer + 1);                                            //
+    TEST_ASSERT_EQUAL_UINT32(0, logArgs::pack(buffer, 1, "lorem"));                            // no room at all
+}
+
+void test_logArgs_render() {
+    char args[64];
+    char result[64];
+    uint32_t argsLength;
+
+    argsLength = logArgs::pack(args, sizeof(args), "main.cpp", 123);
+    logArgs::render(result, sizeof(result), "Error in %s on line %d", args, argsLength);
+    TEST_ASSERT_EQUAL_STRING("Error in main.cpp on line 123", result);
+
+    argsLength = logArgs::pack(args, sizeof(args), -5, 255U, 255, 3.14159, 'x');
+    logArgs::render(result, sizeof(result), "%3d|%u|%04X|%.2f|%c|100%%", args, argsLength);
+    TEST_ASSERT_EQUAL_STRING(" -5|255|00FF|3.14|x|100%", result);
+
+    argsLength = logArgs::pack(args, sizeof(args), 42L, 7ULL, static_cast<short>(-3));        // length modifiers in the format are replaced by the one of the stored argument
+    logArgs::render(result, sizeof(result), "%ld %llu %hd", args, argsLength);
+    TEST_ASSERT_EQUAL_STRING("42 7 -3", result);
+
+    argsLength = logArgs::pack(args, sizeof(args), 2.5, 10);        // type mismatch between format and argument is converted
+    logArgs::render(result, sizeof(result), "%d %.1f", args, argsLength);
+    TEST_ASSERT_EQUAL_STRING("2 10.0", result);
+
+    argsLength = logArgs::pack(args, sizeof(args), NAN, INFINITY, -INFINITY, 1e30, -2.5e18);        // as integers, values which do not fit are 0
+    logArgs::render(result, sizeof(result), "%d %d %d %d %d", args, argsLength);
+    TEST_ASSERT_EQUAL_STRING("0 0 0 0 -2500000000000000000", result);
+}
+
+void test_logArgs_render_boundaries() {
+    char args[64];
+    char result[8];
+    uint32_t argsLength;
+
+    argsLength = logArgs::pack(args, sizeof(args), 123456789);
+    TEST_ASSERT_EQUAL_UINT32(7, logArgs::render(result, sizeof(result), "v=%d", args, argsLength));        // result is truncated to the destination
+    TEST_ASSERT_EQUAL_STRING("v=12345", result);
+
+    TEST_ASSERT_EQUAL_UINT32(2, logArgs::render(result, sizeof(result), "a%db%s", args, 0));         // missing arguments are left out
+    TEST_ASSERT_EQUAL_STRING("ab", result);
+    TEST_ASSERT_EQUAL_UINT32(0, logArgs::render(result, 0, "lorem", args, 0));
+}
+
+void test_logArgs_fittingLength() {
+    char buffer[64];
+    uint32_t length = logArgs::pack(buffer, sizeof(buffer), 1234, "abc", 5.0);        // 5 + 5 + 9 bytes
+    TEST_ASSERT_EQUAL_UINT32(19, length);
+    TEST_ASSERT_EQUAL_UINT32(19, logArgs::fittingLength(buffer, length, 64));        // all fit
+    TEST_ASSERT_EQUAL_UINT32(10, logArgs::fittingLength(buffer, length, 18));        // only complete args are kept
+    TEST_ASSERT_EQUAL_UINT32(5, logArgs::fittingLength(buffer, length, 9));
+    TEST_ASSERT_EQUAL_UINT32(0, logArgs::fittingLength(buffer, length, 4));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_logArgs_pack);
+    RUN_TEST(test_logArgs_pack_overflow);
+    RUN_TEST(test_logArgs_render);
+    RUN_TEST(test_logArgs_render_boundaries);
+    RUN_TEST(test_logArgs_fittingLength);
+    UNITY_END();
+}
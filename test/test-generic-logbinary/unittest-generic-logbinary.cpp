@@ -0,0 +1,65 @@
+#define unitTest
+#include <string.h>
+#include <unity.h>
+#include "logbinary.h"
+
+void test_logBinary_formatId() {
+    TEST_ASSERT_EQUAL_UINT32(0x811C9DC5U, logBinary::formatId(""));         // FNV-1a reference values
+    TEST_ASSERT_EQUAL_UINT32(0xE40C292CU, logBinary::formatId("a"));        //
+    TEST_ASSERT_NOT_EQUAL(logBinary::formatId("Error in %s on line %d"), logBinary::formatId("Error in %s on line %u"));
+}
+
+void test_logBinary_varint() {
+    uint8_t buffer[logBinary::maxVarintLength];
+    uint64_t value;
+    TEST_ASSERT_EQUAL_UINT32(1, logBinary::putVarint(buffer, 0));        // small values take one byte
+    TEST_ASSERT_EQUAL_UINT8(0, buffer[0]);
+    TEST_ASSERT_EQUAL_UINT32(1, logBinary::putVarint(buffer, 127));
+    TEST_ASSERT_EQUAL_UINT32(2, logBinary::putVarint(buffer, 300));
+    TEST_ASSERT_EQUAL_UINT8(0xAC, buffer[0]);        // least significant 7 bits first
+    TEST_ASSERT_EQUAL_UINT8(0x02, buffer[1]);
+    TEST_ASSERT_EQUAL_UINT32(2, logBinary::getVarint(buffer, 2, value));
+    TEST_ASSERT_EQUAL_UINT64(300, value);
+    TEST_ASSERT_EQUAL_UINT32(0, logBinary::getVarint(buffer, 1, value));        // incomplete
+    TEST_ASSERT_EQUAL_UINT32(6, logBinary::putVarint(buffer, 1643485611123ULL));        // a millisecond tick takes 6 bytes
+    TEST_ASSERT_EQUAL_UINT32(logBinary::maxVarintLength, logBinary::putVarint(buffer, UINT64_MAX));
+    TEST_ASSERT_EQUAL_UINT32(logBinary::maxVarintLength, logBinary::getVarint(buffer, sizeof(buffer), value));
+    TEST_ASSERT_EQUAL_UINT64(UINT64_MAX, value);
+}
+
+void test_logBinary_encode() {
+    const uint8_t frame[] = {0x11, 0x00, 0x00, 0x22, 0x33, 0x00};
+    uint8_t encoded[logBinary::encodedLength(sizeof(frame))];
+    uint8_t decoded[sizeof(encoded)];
+    const uint8_t expected[] = {0x02, 0x11, 0x01, 0x03, 0x22, 0x33, 0x01, 0x00};        // zeroes replaced by the distance to the next one, followed by the delimiter
+    TEST_ASSERT_EQUAL_UINT32(sizeof(expected), logBinary::encode(frame, sizeof(frame), encoded));
+    TEST_ASSERT_EQUAL_MEMORY(expected, encoded, sizeof(expected));
+    TEST_ASSERT_EQUAL_UINT32(sizeof(frame), logBinary::decode(encoded, sizeof(expected) - 1U, decoded));
+    TEST_ASSERT_EQUAL_MEMORY(frame, decoded, sizeof(frame));
+    const uint8_t invalid[] = {0x05, 0x11};        // block longer than the frame
+    TEST_ASSERT_EQUAL_UINT32(0, logBinary::decode(invalid, sizeof(invalid), decoded));
+}
+
+void test_logBinary_encode_long() {
+    uint8_t frame[300];
+    for (uint32_t index = 0; index < sizeof(frame); index++) {        // more than 254 non-zero bytes : the block is split
+        frame[index] = static_cast<uint8_t>((index % 255U) + 1U);
+    }
+    uint8_t encoded[logBinary::encodedLength(sizeof(frame))];
+    uint8_t decoded[sizeof(encoded)];
+    uint32_t length = logBinary::encode(frame, sizeof(frame), encoded);
+    TEST_ASSERT_TRUE(length <= sizeof(encoded));
+    TEST_ASSERT_EQUAL_UINT8(0, encoded[length - 1U]);
+    TEST_ASSERT_NULL(memchr(encoded, 0, length - 1U));        // no zero but the delimiter
+    TEST_ASSERT_EQUAL_UINT32(sizeof(frame), logBinary::decode(encoded, length - 1U, decoded));
+    TEST_ASSERT_EQUAL_MEMORY(frame, decoded, sizeof(frame));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_logBinary_formatId);
+    RUN_TEST(test_logBinary_varint);
+    RUN_TEST(test_logBinary_encode);
+    RUN_TEST(test_logBinary_encode_long);
+    UNITY_END();
+}
@@ -0,0 +1,137 @@
+#define unitTest
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+#include <unity.h>
+#include "logconvert.h"
+
+// the built-in conversions must give the same result as printf(), except for the documented rounding of ties in %f
+
+template <typename valueType>
+void checkSameAsPrintf(const char* format, valueType printfValue) {        // format holds a single conversion
+    char packed[32];
+    char expected[64];
+    char result[64];
+    uint32_t packedLength = logArgs::pack(packed, sizeof(packed), printfValue);
+    snprintf(expected, sizeof(expected), format, printfValue);
+    logArgs::render(result, sizeof(result), format, packed, packedLength);
+    TEST_ASSERT_EQUAL_STRING_MESSAGE(expected, result, format);
+}
+
+void test_logConvert_parse() {
+    logConversion theConversion;
+    const char* rest = logConvert::parse("-+ #012.5llx tail", theConversion);
+    TEST_ASSERT_TRUE(theConversion.leftAlign);
+    TEST_ASSERT_TRUE(theConversion.showSign);
+    TEST_ASSERT_TRUE(theConversion.spaceSign);
+    TEST_ASSERT_TRUE(theConversion.alternate);
+    TEST_ASSERT_TRUE(theConversion.zeroPad);
+    TEST_ASSERT_EQUAL_UINT32(12, theConversion.width);
+    TEST_ASSERT_EQUAL_INT32(5, theConversion.precision);
+    TEST_ASSERT_EQUAL('x', theConversion.conversion);
+    TEST_ASSERT_EQUAL_STRING(" tail", rest);
+    logConvert::parse("5", theConversion);        // format ends before the conversion
+    TEST_ASSERT_EQUAL(0, theConversion.conversion);
+    TEST_ASSERT_EQUAL_INT32(-1, theConversion.precision);
+}
+
+void test_logConvert_integers() {
+    char digits[logConvert::maxDigits];
+    TEST_ASSERT_EQUAL_UINT32(1, logConvert::decimal(digits, 0));
+    TEST_ASSERT_EQUAL_UINT32(20, logConvert::decimal(digits, UINT64_MAX));
+    TEST_ASSERT_EQUAL_MEMORY("18446744073709551615", digits, 20);
+    TEST_ASSERT_EQUAL_UINT32(22, logConvert::octal(digits, UINT64_MAX));
+    TEST_ASSERT_EQUAL_UINT32(8, logConvert::hex(digits, 0xDEADBEEFU, true));
+    TEST_ASSERT_EQUAL_MEMORY("DEADBEEF", digits, 8);
+
+    const char* formats[] = {"%d", "%5d", "%-5d|", "%05d", "%+d", "% d", "%.3d", "%8.3d", "%-08d|", "%.0d", "%u", "%x", "%#x", "%#X", "%08x", "%#010x", "%o", "%#o", "%#.0o", "%c"};
+    int values[] = {0, 7, -7, 42, -42, 123456, -2147483647 - 1, 2147483647, 'A'};
+    for (uint32_t formatIndex = 0; formatIndex < (sizeof(formats) / sizeof(formats[0])); formatIndex++) {
+        for (uint32_t valueIndex = 0; valueIndex < (sizeof(values) / sizeof(values[0])); valueIndex++) {
+            if ((strcmp(formats[formatIndex], "%c") == 0) && (values[valueIndex] <= 0)) {
+                continue;        // no printable char
+            }
+            checkSameAsPrintf(formats[formatIndex], values[valueIndex]);
+        }
+    }
+    checkSameAsPrintf("%lld", -9223372036854775807LL - 1);
+    checkSameAsPrintf("%llu", 18446744073709551615ULL);
+    checkSameAsPrintf("%llx", 0x123456789ABCDEFULL);
+}
+
+void test_logConvert_floats() {
+    const char* formats[] = {"%f", "%.0f", "%.1f", "%.2f", "%.9f", "%8.2f", "%-8.2f|", "%08.2f", "%+.3f", "% .1f", "%#.0f", "%e", "%.3g", "%.12f"};
+    double values[] = {0.0, -0.0, 1.0, -1.5, 3.14159, 21.499, 9.996, 0.001, 123456789.987654, -1e-7, 1e20, INFINITY, -INFINITY};
+    for (uint32_t formatIndex = 0; formatIndex < (sizeof(formats) / sizeof(formats[0])); formatIndex++) {
+        for (uint32_t valueIndex = 0; valueIndex < (sizeof(values) / sizeof(values[0])); valueIndex++) {
+            checkSameAsPrintf(formats[formatIndex], values[valueIndex]);
+        }
+    }
+    char packed[16];
+    char result[16];
+    uint32_t packedLength = logArgs::pack(packed, sizeof(packed), NAN);
+    logArgs::render(result, sizeof(result), "%f|%F", packed, packedLength);
+    TEST_ASSERT_EQUAL_STRING("nan|", result);        // only one arg
+    logArgs::render(result, sizeof(result), "%F", packed, packedLength);
+    TEST_ASSERT_EQUAL_STRING("NAN", result);
+}
+
+void checkNative(const char* expected, uint32_t length, char* result) {
+    result[length] = 0;
+    TEST_ASSERT_EQUAL_STRING(expected, result);
+}
+
+void test_logConvert_native_floats() {        // %e and %g as converted with -DLOGGING_NO_PRINTF
+    char result[40];
+    checkNative("1.234500e+03", logConvert::scientific(result, 1234.5, 6, false, false), result);
+    checkNative("0.00E+00", logConvert::scientific(result, 0.0, 2, false, true), result);
+    checkNative("1.000e+01", logConvert::scientific(result, 9.9996, 3, false, false), result);        // rounding up to the next exponent
+    checkNative("2.50e-07", logConvert::scientific(result, 2.5e-7, 2, false, false), result);
+    checkNative("1.00e-310", logConvert::scientific(result, 1e-310, 2, false, false), result);        // denormal
+    checkNative("0.0001234", logConvert::general(result, 0.0001234, -1, false, false), result);
+    checkNative("1.23457e+06", logConvert::general(result, 1234567.0, -1, false, false), result);
+    checkNative("100", logConvert::general(result, 100.0, -1, false, false), result);
+    checkNative("100.000", logConvert::general(result, 100.0, -1, true, false), result);
+    checkNative("0.5", logConvert::general(result, 0.5, 3, false, false), result);
+    checkNative("1E-05", logConvert::general(result, 1e-5, -1, false, true), result);
+    checkNative("3e+20", logConvert::general(result, 3e20, 0, false, false), result);
+}
+
+void test_logConvert_strings() {
+    const char* formats[] = {"%s", "%8s", "%-8s|", "%.3s", "%8.3s", "%.0s"};
+    const char* values[] = {"", "abc", "lorem ipsum"};
+    for (uint32_t formatIndex = 0; formatIndex < (sizeof(formats) / sizeof(formats[0])); formatIndex++) {
+        for (uint32_t valueIndex = 0; valueIndex < (sizeof(values) / sizeof(values[0])); valueIndex++) {
+            checkSameAsPrintf(formats[formatIndex], values[valueIndex]);
+        }
+    }
+    char packed[16];
+    char result[16];
+    uint32_t packedLength = logArgs::pack(packed, sizeof(packed), reinterpret_cast<const void*>(0x1234));
+    logArgs::render(result, sizeof(result), "%p", packed, packedLength);
+    TEST_ASSERT_EQUAL_STRING("0x1234", result);
+}
+
+void test_logConvert_boundaries() {
+    char result[8];
+    logConversion theConversion;
+    logConvert::parse("10d", theConversion);
+    logArgValue value{logArgType::int32, -5, 0, -5.0, ""};
+    TEST_ASSERT_EQUAL_UINT32(7, logConvert::format(result, sizeof(result), theConversion, value));        // truncated to the destination, always terminated
+    TEST_ASSERT_EQUAL_STRING("       ", result);
+    TEST_ASSERT_EQUAL_UINT32(0, logConvert::format(result, 1, theConversion, value));
+    TEST_ASSERT_EQUAL_STRING("", result);
+    logConvert::parse("n", theConversion);        // unsupported
+    TEST_ASSERT_EQUAL_UINT32(0, logConvert::format(result, sizeof(result), theConversion, value));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_logConvert_parse);
+    RUN_TEST(test_logConvert_integers);
+    RUN_TEST(test_logConvert_floats);
+    RUN_TEST(test_logConvert_native_floats);
+    RUN_TEST(test_logConvert_strings);
+    RUN_TEST(test_logConvert_boundaries);
+    UNITY_END();
+}
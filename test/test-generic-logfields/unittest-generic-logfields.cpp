@@ -0,0 +1,91 @@
+#define unitTest
+#include <string.h>
+#include <math.h>
+#include <unity.h>
+#include "logfields.h"
+
+void test_logFields_pack() {
+    char buffer[64];
+    TEST_ASSERT_EQUAL_UINT32(11, logArgs::pack(buffer, sizeof(buffer), kv("rssi", -71)));              // key as a string, then the value : 6 + 5 bytes
+    TEST_ASSERT_EQUAL_UINT32(0, logArgs::pack(buffer, 8, kv("rssi", -71)));                            // key and value are packed both or not at all
+    logArgValue value;
+    TEST_ASSERT_EQUAL_UINT32(6, logArgs::unpack(buffer, 11, value));                                   //
+    TEST_ASSERT_EQUAL_STRING("rssi", value.stringValue);                                               //
+    TEST_ASSERT_EQUAL_UINT32(5, logArgs::unpack(buffer + 6, 5, value));                                //
+    TEST_ASSERT_EQUAL_INT32(-71, value.signedValue);                                                   //
+    TEST_ASSERT_EQUAL_UINT32(0, logArgs::unpack(buffer + 6, 4, value));                                // incomplete
+}
+
+void test_logFields_encodings() {
+    char fields[64];
+    uint32_t fieldsLength = logArgs::pack(fields, sizeof(fields), kv("rssi", -71), kv("ok", true), kv("ssid", "a b"), kv("ratio", 0.25));
+    char line[64];
+
+    logLineWriter text(line, 0, 60, logEncoding::text);
+    text.addText("joined", 6);
+    text.addFields(fields, fieldsLength);
+    text.end();
+    TEST_ASSERT_EQUAL_STRING("joined rssi=-71 ok=1 ssid=\"a b\" ratio=0.25\n", line);
+
+    logLineWriter logfmt(line, 0, 60, logEncoding::logfmt);
+    logfmt.addString("msg", "", 0);        // empty values are quoted
+    logfmt.addFields(fields, fieldsLength);
+    logfmt.end();
+    TEST_ASSERT_EQUAL_STRING("msg=\"\" rssi=-71 ok=1 ssid=\"a b\" ratio=0.25\n", line);
+
+    logLineWriter json(line, 0, 60, logEncoding::json);
+    json.begin();
+    json.addFields(fields, fieldsLength);
+    json.end();
+    TEST_ASSERT_EQUAL_STRING("{\"rssi\":-71,\"ok\":1,\"ssid\":\"a b\",\"ratio\":0.25}\n", line);
+}
+
+void test_logFields_escaping() {
+    char line[64];
+    logLineWriter logfmt(line, 0, 60, logEncoding::logfmt);
+    logfmt.addString("a", "x=\"1\"\n", 6);
+    logfmt.end();
+    TEST_ASSERT_EQUAL_STRING("a=\"x=\\\"1\\\"\\n\"\n", line);
+
+    logLineWriter json(line, 0, 60, logEncoding::json);
+    json.begin();
+    json.addString("a", "\\\x01", 2);
+    logArgValue value{logArgType::float64, 0, 0, NAN, ""};
+    json.addValue("b", value);        // json has no nan
+    json.end();
+    TEST_ASSERT_EQUAL_STRING("{\"a\":\"\\\\\\u0001\",\"b\":null}\n", line);
+}
+
+void test_logFields_boundaries() {
+    char line[32];
+    logLineWriter truncated(line, 0, 11, logEncoding::json);
+    truncated.begin();
+    TEST_ASSERT_TRUE(truncated.addString("k", "abc\"def", 7));        // string values are truncated, but never within an escape sequence
+    TEST_ASSERT_EQUAL_UINT32(12, truncated.end());                    // closing brace and newline go beyond maxLength
+    TEST_ASSERT_EQUAL_STRING("{\"k\":\"abc\"}\n", line);
+
+    char fields[64];
+    uint32_t fieldsLength = logArgs::pack(fields, sizeof(fields), kv("a", 1), kv("bb", 22), kv("c", 3));
+    logLineWriter dropped(line, 0, 8, logEncoding::logfmt);
+    dropped.addFields(fields, fieldsLength);        // bb=22 does not fit, and c=3 is left out as well to keep the order
+    dropped.end();
+    TEST_ASSERT_EQUAL_STRING("a=1\n", line);
+
+    const char* message;
+    uint32_t messageLength;
+    fieldsLength = logArgs::pack(fields, sizeof(fields), "joined", kv("a", 1));
+    TEST_ASSERT_EQUAL_UINT32(8, logLineWriter::message(fields, fieldsLength, message, messageLength));
+    TEST_ASSERT_EQUAL_UINT32(6, messageLength);
+    TEST_ASSERT_EQUAL_STRING("joined", message);
+    TEST_ASSERT_EQUAL_UINT32(0, logLineWriter::message(fields, 4, message, messageLength));        // incomplete
+    TEST_ASSERT_EQUAL_UINT32(0, messageLength);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_logFields_pack);
+    RUN_TEST(test_logFields_encodings);
+    RUN_TEST(test_logFields_escaping);
+    RUN_TEST(test_logFields_boundaries);
+    UNITY_END();
+}
@@ -0,0 +1,73 @@
+#define unitTest
+#include <string.h>
+#include <unity.h>
+#include "logging.h"
+
+LOGGING_SUBSYSTEM_MIN_LEVEL(subSystem::nfc, loggingLevel::Warning);        // nfc only compiles in Warning and more important
+
+static_assert(compiledLoggingLevel<subSystem::general>::value == loggingLevel::Debug, "default compile-time level is Debug");
+static_assert(compiledLoggingLevel<subSystem::nfc>::value == loggingLevel::Warning, "compile-time level can be set per subSystem");
+
+uint32_t nmbrEvaluations{0};
+uint32_t nmbrOutputs{0};
+
+const char* expensiveArgument() {
+    nmbrEvaluations++;
+    return "expensive";
+}
+
+bool outputFunction(const char* contents) {
+    nmbrOutputs++;
+    return true;
+}
+
+void test_compiled_in() {
+    TEST_ASSERT_TRUE(ULOG_IS_COMPILED_IN(subSystem::general, loggingLevel::Debug));
+    TEST_ASSERT_TRUE(ULOG_IS_COMPILED_IN(subSystem::nfc, loggingLevel::Warning));
+    TEST_ASSERT_TRUE(ULOG_IS_COMPILED_IN(subSystem::nfc, loggingLevel::Critical));
+    TEST_ASSERT_FALSE(ULOG_IS_COMPILED_IN(subSystem::nfc, loggingLevel::Info));
+    TEST_ASSERT_FALSE(ULOG_IS_COMPILED_IN(subSystem::nfc, loggingLevel::Debug));
+}
+
+void test_compiled_out_calls() {
+    uLog aLog;
+    aLog.setOutput(0, outputFunction);
+    aLog.setLoggingLevel(0, loggingLevel::Debug);        // at runtime, the output wants everything
+    nmbrEvaluations = 0;
+    nmbrOutputs     = 0;
+
+    ULOG_SNPRINTF(aLog, subSystem::nfc, loggingLevel::Debug, "frame %s", expensiveArgument());        // compiled out : arguments are not evaluated
+    ULOG_DEFERRED(aLog, subSystem::nfc, loggingLevel::Info, "frame %s", expensiveArgument());         //
+    ULOG_OUTPUT(aLog, subSystem::nfc, loggingLevel::Debug, expensiveArgument());                      //
+    ULOG_INTERNED(aLog, subSystem::nfc, loggingLevel::Info, "frame %s", expensiveArgument());         //
+    TEST_ASSERT_EQUAL_UINT32(0, nmbrEvaluations);
+    TEST_ASSERT_EQUAL_UINT32(0, nmbrOutputs);
+
+    ULOG_SNPRINTF(aLog, subSystem::nfc, loggingLevel::Error, "frame %s", expensiveArgument());        // compiled in
+    ULOG_DEFERRED(aLog, subSystem::general, loggingLevel::Debug, "frame %s", expensiveArgument());    //
+    ULOG_LOG(aLog, subSystem::general, loggingLevel::Debug, expensiveArgument());                     //
+    ULOG_OUTPUT(aLog, subSystem::general, loggingLevel::Debug, expensiveArgument());                  //
+    ULOG_INTERNED(aLog, subSystem::general, loggingLevel::Debug, "frame %s", expensiveArgument());    //
+    ULOG_INTERNED(aLog, subSystem::general, loggingLevel::Debug, "no arguments");                     //
+    aLog.flush();
+    TEST_ASSERT_EQUAL_UINT32(5, nmbrEvaluations);
+    TEST_ASSERT_EQUAL_UINT32(6, nmbrOutputs);
+}
+
+void test_enabled() {
+    uLog aLog;
+    aLog.setOutput(0, outputFunction);
+    aLog.setLoggingLevel(0, loggingLevel::Info);
+    TEST_ASSERT_TRUE(ULOG_IS_ENABLED(aLog, subSystem::general, loggingLevel::Info));
+    TEST_ASSERT_FALSE(ULOG_IS_ENABLED(aLog, subSystem::general, loggingLevel::Debug));        // filtered at runtime
+    TEST_ASSERT_FALSE(ULOG_IS_ENABLED(aLog, subSystem::nfc, loggingLevel::Info));             // compiled out
+    TEST_ASSERT_TRUE(ULOG_IS_ENABLED(aLog, subSystem::nfc, loggingLevel::Warning));           //
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_compiled_in);
+    RUN_TEST(test_compiled_out_calls);
+    RUN_TEST(test_enabled);
+    UNITY_END();
+}
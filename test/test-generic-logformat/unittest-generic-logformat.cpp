@@ -0,0 +1,31 @@
+#define unitTest
+#include <string.h>
+#include <unity.h>
+#include "logformat.h"
+#include "logbinary.h"
+
+static_assert(logFormatId("") == 0x811C9DC5U, "ID is computed at compile time");
+static_assert(logFormatId("a") == 0xE40C292CU, "ID is the FNV-1a hash of the format");
+
+const logFormat& someLogSite() {
+    return ULOG_FORMAT("Error in %s on line %d");
+}
+
+void test_logFormat_id() {
+    TEST_ASSERT_EQUAL_UINT32(logBinary::formatId("Error in %s on line %d"), logFormatId("Error in %s on line %d"));        // the same as the binary output computes for formats which are not interned
+    TEST_ASSERT_EQUAL_UINT32(logBinary::formatId("\x1B[31;40m \"%5.2f\"\n"), logFormatId("\x1B[31;40m \"%5.2f\"\n"));
+}
+
+void test_logFormat_site() {
+    const logFormat& theFormat = someLogSite();
+    TEST_ASSERT_EQUAL_STRING("Error in %s on line %d", theFormat.text);
+    TEST_ASSERT_EQUAL_UINT32(logFormatId("Error in %s on line %d"), theFormat.id);
+    TEST_ASSERT_EQUAL_PTR(&theFormat, &someLogSite());        // one static logFormat per log site
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_logFormat_id);
+    RUN_TEST(test_logFormat_site);
+    UNITY_END();
+}
@@ -1,5 +1,7 @@
 #define unitTest
 #include <string.h>
+#include <stdio.h>
+#include <stddef.h>
 #include <unity.h>
 #include "logging.h"
 
@@ -17,6 +19,11 @@ bool outputFunctionTestLength(const char* contents) {
     return true;
 }
 
+bool outputFunctionTestDeferred(const char* contents) {
+    TEST_ASSERT_EQUAL_STRING("W Error in main.cpp on line 123\n", contents);
+    return true;
+}
+
 bool loggingTime(char* contents, uint32_t length) {
     strcpy(contents, "2022-01-29T19:46:51Z");
     return true;
@@ -38,6 +45,12 @@ bool outputFunction3(const char* contents) {
     return true;
 }
 
+void waitMicroseconds(uint32_t duration) {        // without std::this_thread, which not all targets have
+    uint32_t start = logMicroseconds();
+    while ((logMicroseconds() - start) < duration) {
+    }
+}
+
 /*
 2022-01-29T19:46:51+00:00
 2022-01-29T19:46:51Z
@@ -77,36 +90,132 @@ void test_uLog_filtering() {
     TEST_ASSERT_FALSE(aLog.checkLoggingLevel(subSystem::general, loggingLevel::Debug));         // lower level should NOT be logged
 }
 
+void test_uLog_outputMasks() {
+    uLog aLog;
+    TEST_ASSERT_EQUAL_UINT8(0, aLog.outputMask(subSystem::general, loggingLevel::Critical));        // no outputs, so nobody is interested
+    aLog.setLoggingLevel(0, loggingLevel::Warning);                                                 // level of an inactive output does not count
+    TEST_ASSERT_EQUAL_UINT8(0, aLog.outputMask(subSystem::general, loggingLevel::Critical));        //
+    aLog.setOutput(0, outputFunctionTestLength);                                                    // activating the output updates the masks
+    aLog.setOutput(1, outputFunctionTestLength);                                                    //
+    aLog.setLoggingLevel(1, subSystem::nfc, loggingLevel::Debug);                                   //
+    TEST_ASSERT_EQUAL_UINT8(0x01, aLog.outputMask(subSystem::general, loggingLevel::Warning));
+    TEST_ASSERT_EQUAL_UINT8(0x00, aLog.outputMask(subSystem::general, loggingLevel::Info));
+    TEST_ASSERT_EQUAL_UINT8(0x03, aLog.outputMask(subSystem::nfc, loggingLevel::Error));
+    TEST_ASSERT_EQUAL_UINT8(0x02, aLog.outputMask(subSystem::nfc, loggingLevel::Debug));
+    aLog.setOutput(0, nullptr);                                                                                                                  // deactivating the output updates the masks
+    TEST_ASSERT_EQUAL_UINT8(0x02, aLog.outputMask(subSystem::nfc, loggingLevel::Error));
+    TEST_ASSERT_FALSE(aLog.checkLoggingLevel(subSystem::general, loggingLevel::Error));
+    TEST_ASSERT_TRUE(aLog.checkLoggingLevel(subSystem::nfc, loggingLevel::Error));
+    TEST_ASSERT_EQUAL_UINT32(0, reinterpret_cast<uintptr_t>(&aLog.outputMasks[0]) % uLog::cacheLineSize);        // each table on cache lines of its own
+    TEST_ASSERT_EQUAL_UINT32(0, reinterpret_cast<uintptr_t>(&aLog.outputMasks[1]) % uLog::cacheLineSize);        //
+}
+
+const char* networkNames(subSystem aSubSystem) {
+    switch (aSubSystem) {
+        case subSystem::networkCtrl:
+            return "networkCtrl";
+        case subSystem::networkData:
+            return "networkData";
+        case subSystem::general:
+            return nullptr;        // no name, so it goes by its number
+        default:
+            return "other";
+    }
+}
+
+void test_uLog_level_rules() {
+    uLog aLog;
+    aLog.setOutput(0, outputFunctionTestLength);
+    aLog.setOutput(1, outputFunctionTestLength);
+    uint32_t generation = aLog.getLevelsGeneration();
+    TEST_ASSERT_TRUE(aLog.setLoggingLevels("*=Warning 1:1?=Debug 1:12=None"));        // without names, rules match the numbers of the subSystems
+    TEST_ASSERT_EQUAL_UINT32(generation + 1U, aLog.getLevelsGeneration());             // all rules published at once
+    TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(loggingLevel::Warning), static_cast<uint8_t>(aLog.getLoggingLevel(0, subSystem::networkCtrl)));
+    TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(loggingLevel::Debug), static_cast<uint8_t>(aLog.getLoggingLevel(1, subSystem::networkCtrl)));
+    TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(loggingLevel::None), static_cast<uint8_t>(aLog.getLoggingLevel(1, subSystem::networkData)));
+    TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(loggingLevel::Warning), static_cast<uint8_t>(aLog.getLoggingLevel(1, subSystem::general)));
+    TEST_ASSERT_EQUAL_UINT8(0x02, aLog.outputMask(subSystem::networkCtrl, loggingLevel::Debug));
+    TEST_ASSERT_EQUAL_UINT8(0x01, aLog.outputMask(subSystem::networkData, loggingLevel::Warning));
+
+    aLog.setSubSystemNames(networkNames);
+    TEST_ASSERT_TRUE(aLog.setLoggingLevels("network*=info; 0:*Data=Error"));
+    TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(loggingLevel::Info), static_cast<uint8_t>(aLog.getLoggingLevel(1, subSystem::networkData)));
+    TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(loggingLevel::Error), static_cast<uint8_t>(aLog.getLoggingLevel(0, subSystem::networkData)));
+    TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(loggingLevel::Info), static_cast<uint8_t>(aLog.getLoggingLevel(0, subSystem::networkCtrl)));
+    TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(loggingLevel::Warning), static_cast<uint8_t>(aLog.getLoggingLevel(0, subSystem::general)));        // not matched, so unchanged
+    TEST_ASSERT_TRUE(aLog.setLoggingLevels("1:0=Error"));
+    TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(loggingLevel::Error), static_cast<uint8_t>(aLog.getLoggingLevel(1, subSystem::general)));        // a subSystem without a name matches its number
+    TEST_ASSERT_TRUE(aLog.setLoggingLevels("1:0=Warning"));
+
+    generation = aLog.getLevelsGeneration();
+    TEST_ASSERT_FALSE(aLog.setLoggingLevels("*=None 2:*=Debug"));        // no output 2, so nothing changes
+    TEST_ASSERT_EQUAL_UINT32(generation, aLog.getLevelsGeneration());
+    TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(loggingLevel::Warning), static_cast<uint8_t>(aLog.getLoggingLevel(0, subSystem::general)));
+}
+
 void test_uLog_circular_buffer() {
     uLog aLog;
-    TEST_ASSERT_EQUAL_UINT32(0, aLog.level);        // empty after creation
-    TEST_ASSERT_EQUAL_UINT32(0, aLog.head);
+    TEST_ASSERT_EQUAL_UINT32(0, aLog.items.level());        // empty after creation
+    TEST_ASSERT_EQUAL_UINT32(0, aLog.items.head());
 
-    uint32_t newIndex;
+    static constexpr uint32_t recordLength = 64U;                                                 // choose an item size so each record takes 64 bytes
+    static constexpr uint32_t itemSize     = recordLength - logArena<uLog::bufferSize>::headerSize;        //
+    static constexpr uint32_t capacity     = uLog::bufferSize / recordLength;                     //
+    uint32_t position;
 
-    for (int i = 0; i < aLog.length; i++) {            // fill the buffer
-        TEST_ASSERT_EQUAL_UINT32(0, aLog.head);        // before pushing
-        TEST_ASSERT_EQUAL_UINT32(i, aLog.level);
-        newIndex = aLog.pushItem();
-        TEST_ASSERT_EQUAL_UINT32(i, newIndex);        // after pushing
-        TEST_ASSERT_EQUAL_UINT32(0, aLog.head);
-        TEST_ASSERT_EQUAL_UINT32((i + 1), aLog.level);
+    for (uint32_t i = 0; i < capacity; i++) {        // fill the buffer
+        TEST_ASSERT_EQUAL_UINT32(0, aLog.items.head());        // before pushing
+        TEST_ASSERT_EQUAL_UINT32(i * recordLength, aLog.items.level());
+        TEST_ASSERT_TRUE(aLog.pushItem(position, itemSize));
+        TEST_ASSERT_EQUAL_UINT32(i * recordLength, position);        // after pushing
+        aLog.items.publish(position);
+        TEST_ASSERT_EQUAL_UINT32(0, aLog.items.head());
+        TEST_ASSERT_EQUAL_UINT32((i + 1) * recordLength, aLog.items.level());
     }
-    newIndex = aLog.pushItem();
-    TEST_ASSERT_EQUAL_UINT32(0, newIndex);        // test overflow
-    TEST_ASSERT_EQUAL_UINT32(0, aLog.head);
-    TEST_ASSERT_EQUAL_UINT32(aLog.length, aLog.level);
+    TEST_ASSERT_TRUE(aLog.pushItem(position, itemSize));        // test overflow : the oldest item is discarded to make room
+    TEST_ASSERT_EQUAL_UINT32(uLog::bufferSize, position);
+    aLog.items.publish(position);
+    TEST_ASSERT_EQUAL_UINT32(recordLength, aLog.items.head());
+    TEST_ASSERT_EQUAL_UINT32(uLog::bufferSize, aLog.items.level());
+    TEST_ASSERT_EQUAL_UINT32(1, aLog.droppedItems);
 
-    for (int i = 0; i < aLog.length; i++) {        // empty the buffer
-        TEST_ASSERT_EQUAL_UINT32(i, aLog.head);
-        TEST_ASSERT_EQUAL_UINT32((aLog.length - i), aLog.level);
+    for (uint32_t i = 0; i < capacity; i++) {        // empty the buffer
+        TEST_ASSERT_TRUE(aLog.items.peek(position));
+        TEST_ASSERT_EQUAL_UINT32((i + 1) * recordLength, position);
+        TEST_ASSERT_EQUAL_UINT32((capacity - i) * recordLength, aLog.items.level());
         aLog.popItem();
-        TEST_ASSERT_EQUAL_UINT32((i + 1) % aLog.length, aLog.head);
-        TEST_ASSERT_EQUAL_UINT32((aLog.length - (i + 1)), aLog.level);
+        TEST_ASSERT_EQUAL_UINT32((i + 2) * recordLength, aLog.items.head());
+        TEST_ASSERT_EQUAL_UINT32((capacity - (i + 1)) * recordLength, aLog.items.level());
     }
     aLog.popItem();        // test underflow
-    TEST_ASSERT_EQUAL_UINT32(0, aLog.head);
-    TEST_ASSERT_EQUAL_UINT32(0, aLog.level);
+    TEST_ASSERT_EQUAL_UINT32((capacity + 1) * recordLength, aLog.items.head());
+    TEST_ASSERT_EQUAL_UINT32(0, aLog.items.level());
+}
+
+void test_uLog_packed_items() {
+    uLog aLog;
+    aLog.setOutput(0, outputFunctionTestLength);
+    aLog.setLoggingLevel(0, loggingLevel::Info);
+    for (uint32_t i = 0; i < 12; i++) {        // short items only take the bytes they need, so many more fit than in fixed size slots
+        aLog.log(subSystem::general, loggingLevel::Info, "short");
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, aLog.droppedItems);
+    aLog.flush();
+    TEST_ASSERT_EQUAL_UINT32(0, aLog.items.level());
+}
+
+void test_uLog_publish() {
+    uLog aLog;
+    uint32_t first;
+    uint32_t second;
+    uint32_t position;
+    TEST_ASSERT_TRUE(aLog.pushItem(first, 8));          // two producers reserve an item
+    TEST_ASSERT_TRUE(aLog.pushItem(second, 8));         //
+    aLog.items.publish(second);                         // second one is published first
+    TEST_ASSERT_FALSE(aLog.items.peek(position));        // consumer must not see anything until the oldest item is published
+    aLog.items.publish(first);
+    TEST_ASSERT_TRUE(aLog.items.peek(position));
+    TEST_ASSERT_EQUAL_UINT32(first, position);
 }
 
 void test_uLog_output() {
@@ -160,14 +269,902 @@ void test_uLog_output2() {
     aLog.output(subSystem::general, loggingLevel::Critical, "Critical Error");
 }
 
+void test_uLog_deferred() {
+    uLog aLog;
+    aLog.setOutput(0, outputFunctionTestDeferred);
+    aLog.setLoggingLevel(0, loggingLevel::Warning);
+    char fileName[16];
+    strcpy(fileName, "main.cpp");
+    aLog.logDeferred(subSystem::general, loggingLevel::Warning, "Error in %s on line %d", fileName, 123);        // only format pointer and args are stored
+    aLog.logDeferred(subSystem::general, loggingLevel::Info, "Error in %s on line %d", fileName, 456);           // filtered out
+    strcpy(fileName, "other.cpp");                                                                                  // string args are copied, so changing them afterwards has no effect
+    uint32_t position;
+    TEST_ASSERT_TRUE(aLog.items.peek(position));
+    TEST_ASSERT_NOT_NULL(aLog.item(position)->format);
+    TEST_ASSERT_EQUAL_UINT32(aLog.items.level(), logArena<uLog::bufferSize>::recordLength(logItem::storageLength(1, aLog.item(position)->contentsSize)));        // only one item stored
+    aLog.flush();        // now it gets formatted
+    TEST_ASSERT_EQUAL_UINT32(0, aLog.items.level());
+}
+
+uint32_t nmbrOutputCalls{0};
+
+bool outputFunctionCount(const char* contents) {
+    nmbrOutputCalls++;
+    return true;
+}
+
+static constexpr uint32_t itemSize = 64U - logArena<uLog::bufferSize>::headerSize;        // item size resulting in records of 64 bytes
+
+void fillBuffer(uLog& aLog) {        // fills the buffer with items of 64 bytes, without outputting them
+    uint32_t position;
+    for (uint32_t i = 0; i < (uLog::bufferSize / 64U); i++) {
+        TEST_ASSERT_TRUE(aLog.pushItem(position, itemSize));
+        aLog.items.publish(position);
+    }
+    TEST_ASSERT_EQUAL_UINT32(uLog::bufferSize, aLog.items.level());
+}
+
+void test_uLog_overflow_policies() {
+    uLog aLog;
+    uint32_t position;
+    TEST_ASSERT_EQUAL(overflowPolicy::dropOldest, aLog.getOverflowPolicy());        // default
+    aLog.setOverflowPolicy(overflowPolicy::dropNewest);
+    fillBuffer(aLog);
+    TEST_ASSERT_FALSE(aLog.pushItem(position, itemSize));        // no room, and new item is dropped
+    TEST_ASSERT_EQUAL_UINT32(1, aLog.getDroppedItems());
+    TEST_ASSERT_EQUAL_UINT32(0, aLog.items.head());        // oldest item is still there
+
+    aLog.setOverflowPolicy(overflowPolicy::sample, 3);        // one out of 3 new items is kept
+    TEST_ASSERT_TRUE(aLog.pushItem(position, itemSize));
+    aLog.items.publish(position);
+    TEST_ASSERT_FALSE(aLog.pushItem(position, itemSize));
+    TEST_ASSERT_FALSE(aLog.pushItem(position, itemSize));
+    TEST_ASSERT_EQUAL_UINT32(4, aLog.getDroppedItems());        // 1 + oldest item discarded + 2 not sampled
+
+    aLog.setOverflowPolicy(overflowPolicy::dropOldest);
+    TEST_ASSERT_TRUE(aLog.pushItem(position, itemSize));
+    aLog.items.publish(position);
+}
+
+void test_uLog_overflow_block() {
+    uLog aLog;
+    aLog.setOutput(0, outputFunctionCount);
+    aLog.setLoggingLevel(0, loggingLevel::Info);
+    aLog.setOverflowPolicy(overflowPolicy::block);
+    nmbrOutputCalls = 0;
+    for (uint32_t i = 0; i < 100; i++) {        // much more than fits in the buffer : when full, the items are output to make room
+        aLog.log(subSystem::general, loggingLevel::Info, "blocking rather than dropping");
+    }
+    aLog.flush();
+    TEST_ASSERT_EQUAL_UINT32(0, aLog.getDroppedItems());
+    TEST_ASSERT_EQUAL_UINT32(100, nmbrOutputCalls);
+}
+
+uint32_t nmbrBatches{0};
+uint32_t nmbrBatchItems{0};
+uint32_t batchAccepts{UINT32_MAX};        // how many items the batch output accepts
+char batchReceived[256];
+
+uint32_t outputFunctionBatch(const logSpan* spans, uint32_t nmbrSpans) {
+    nmbrBatches++;
+    uint32_t accepted = (nmbrSpans < batchAccepts) ? nmbrSpans : batchAccepts;
+    for (uint32_t index = 0; index < accepted; index++) {
+        TEST_ASSERT_EQUAL_UINT32(strlen(spans[index].text), spans[index].length);
+        strcat(batchReceived, spans[index].text);
+    }
+    nmbrBatchItems += accepted;
+    return accepted;
+}
+
+bool outputFunctionBusy(const char* contents) {
+    return (batchAccepts > 0);
+}
+
+void test_uLog_batch_output() {
+    uLog aLog;
+    aLog.setBatchOutput(0, outputFunctionBatch);
+    aLog.setLoggingLevel(0, loggingLevel::Info);
+    TEST_ASSERT_TRUE(aLog.outputIsActive(0));
+    nmbrBatches      = 0;
+    nmbrBatchItems   = 0;
+    batchAccepts     = UINT32_MAX;
+    batchReceived[0] = 0;
+    aLog.log(subSystem::general, loggingLevel::Info, "a");
+    aLog.log(subSystem::general, loggingLevel::Debug, "-");        // filtered out
+    aLog.log(subSystem::general, loggingLevel::Info, "b");
+    aLog.log(subSystem::general, loggingLevel::Info, "c");
+    aLog.flush();
+    TEST_ASSERT_EQUAL_UINT32(1, nmbrBatches);        // all items in one call
+    TEST_ASSERT_EQUAL_STRING("I a\nI b\nI c\n", batchReceived);
+
+    for (uint32_t i = 0; i < (uLog::batchSize + 1U); i++) {        // more than one batch
+        aLog.log(subSystem::general, loggingLevel::Info, "d");
+    }
+    aLog.flush();
+    TEST_ASSERT_EQUAL_UINT32(3, nmbrBatches);
+    TEST_ASSERT_EQUAL_UINT32(3 + uLog::batchSize + 1U, nmbrBatchItems);
+    TEST_ASSERT_EQUAL_UINT32(0, aLog.items.level());
+}
+
+void test_uLog_batch_retry() {
+    uLog aLog;
+    aLog.setBatchOutput(0, outputFunctionBatch);
+    aLog.setLoggingLevel(0, loggingLevel::Info);
+    aLog.setOutput(1, outputFunctionBusy);
+    aLog.setLoggingLevel(1, loggingLevel::Info);
+    nmbrBatchItems   = 0;
+    batchAccepts     = 1;        // output 0 only takes one item at a time
+    batchReceived[0] = 0;
+    aLog.log(subSystem::general, loggingLevel::Info, "a");
+    aLog.log(subSystem::general, loggingLevel::Info, "b");
+    aLog.log(subSystem::general, loggingLevel::Info, "c");
+    aLog.flush();        // one item per round, until all are accepted
+    TEST_ASSERT_EQUAL_STRING("I a\nI b\nI c\n", batchReceived);
+    TEST_ASSERT_EQUAL_UINT32(0, aLog.items.level());
+
+    batchAccepts     = 0;        // both outputs busy
+    batchReceived[0] = 0;
+    aLog.log(subSystem::general, loggingLevel::Info, "d");
+    aLog.flush();
+    TEST_ASSERT_NOT_EQUAL(0, aLog.items.level());        // kept for a later retry
+    batchAccepts = 1;
+    aLog.flush();
+    TEST_ASSERT_EQUAL_STRING("I d\n", batchReceived);        // and output once
+    TEST_ASSERT_EQUAL_UINT32(0, aLog.items.level());
+    TEST_ASSERT_EQUAL_UINT32(4, nmbrBatchItems);
+    batchAccepts = UINT32_MAX;
+}
+
+uint32_t nmbrTicks{0};
+
+uint64_t loggingTick() {
+    nmbrTicks++;
+    return 1643485611123ULL;
+}
+
+const char* sharedLines[uLog::maxNmbrOutputs];        // spans are only valid during the call, so we keep a copy of the text as well
+char sharedTexts[uLog::maxNmbrOutputs][uLog::lineSize];
+
+uint32_t outputFunctionShared0(const logSpan* spans, uint32_t nmbrSpans) {
+    sharedLines[0] = spans[0].text;
+    strcpy(sharedTexts[0], spans[0].text);
+    return nmbrSpans;
+}
+
+uint32_t outputFunctionShared1(const logSpan* spans, uint32_t nmbrSpans) {
+    sharedLines[1] = spans[0].text;
+    strcpy(sharedTexts[1], spans[0].text);
+    return nmbrSpans;
+}
+
+void test_uLog_format() {
+    uLog aLog;
+    char line[uLog::lineSize];
+    uint32_t position;
+    aLog.setTimeSource(loggingTime);
+    aLog.setOutput(0, outputFunctionCount);
+    aLog.setLoggingLevel(0, loggingLevel::Info);
+    aLog.log(subSystem::general, loggingLevel::Warning, "lorem ipse");
+    TEST_ASSERT_TRUE(aLog.items.peek(position));
+    TEST_ASSERT_EQUAL_UINT32(13, aLog.format(0, *aLog.item(position), line));
+    TEST_ASSERT_EQUAL_STRING("W lorem ipse\n", line);
+    aLog.setIncludeTimestamp(0, true);
+    aLog.setColoredOutput(0, true);
+    TEST_ASSERT_EQUAL_UINT32(8 + 21 + 12 + 4 + 1, aLog.format(0, *aLog.item(position), line));
+    TEST_ASSERT_EQUAL_STRING("\033[33;40m2022-01-29T19:46:51Z W lorem ipse\033[0m\n", line);
+
+    char longText[logItem::maxItemLength + 16U];
+    memset(longText, 'x', sizeof(longText) - 1U);
+    longText[sizeof(longText) - 1U] = 0;
+    aLog.flush();
+    aLog.log(subSystem::general, loggingLevel::Warning, longText);
+    TEST_ASSERT_TRUE(aLog.items.peek(position));
+    TEST_ASSERT_EQUAL_UINT32(logItem::maxItemLength, aLog.format(0, *aLog.item(position), line));        // truncated to maxItemLength, keeping color postfix and newline
+    TEST_ASSERT_EQUAL_STRING("\033[0m\n", line + logItem::maxItemLength - 5U);
+}
+
+void test_uLog_tick_timestamp() {
+    uLog aLog;
+    char line[uLog::lineSize];
+    uint32_t position;
+    aLog.setTimeSource(loggingTime);
+    aLog.setTickSource(loggingTick);        // takes precedence over the time source
+    aLog.setOutput(0, outputFunctionCount);
+    aLog.setLoggingLevel(0, loggingLevel::Info);
+    nmbrTicks = 0;
+    aLog.log(subSystem::general, loggingLevel::Warning, "lorem ipse");
+    TEST_ASSERT_EQUAL_UINT32(1, nmbrTicks);
+    TEST_ASSERT_TRUE(aLog.items.peek(position));
+    TEST_ASSERT_TRUE(aLog.item(position)->tickTimestamp);
+    TEST_ASSERT_EQUAL_UINT32(sizeof(uint64_t), aLog.item(position)->timestampSize);        // only the raw tick is stored
+    aLog.format(0, *aLog.item(position), line);
+    TEST_ASSERT_EQUAL_STRING("W lorem ipse\n", line);
+    aLog.setIncludeTimestamp(0, true);
+    aLog.format(0, *aLog.item(position), line);        // formatted at output time
+    TEST_ASSERT_EQUAL_STRING("2022-01-29T19:46:51.123Z W lorem ipse\n", line);
+}
+
+void test_uLog_shared_lines() {
+    uLog aLog;
+    aLog.setBatchOutput(0, outputFunctionShared0);
+    aLog.setLoggingLevel(0, loggingLevel::Info);
+    aLog.setBatchOutput(1, outputFunctionShared1);
+    aLog.setLoggingLevel(1, loggingLevel::Info);
+    aLog.output(subSystem::general, loggingLevel::Info, "same format");
+    TEST_ASSERT_EQUAL_PTR(sharedLines[0], sharedLines[1]);        // formatted once, for both outputs
+    TEST_ASSERT_EQUAL_STRING("I same format\n", sharedTexts[0]);
+
+    aLog.setIncludeTimestamp(1, true);
+    aLog.output(subSystem::general, loggingLevel::Info, "other format");
+    TEST_ASSERT_EQUAL_STRING("I other format\n", sharedTexts[0]);
+    TEST_ASSERT_EQUAL_STRING(" I other format\n", sharedTexts[1]);        // no time source, so an empty timestamp
+}
+
+enum class sensorSubSystem : uint8_t {
+    radio,
+    sensor,
+    nmbrOfSubsystems
+};
+
+struct gatewayLogConfig : logConfig {
+    static constexpr uint32_t maxNmbrOutputs = 8;
+    static constexpr uint32_t bufferSize     = 2048;
+    static constexpr uint32_t maxItemLength  = 128;
+    static constexpr bool collectMetrics     = false;
+    typedef sensorSubSystem subSystemType;
+};
+
+typedef basicLog<gatewayLogConfig> gatewayLog;
+
+uint32_t gatewayLength{0};
+sensorSubSystem gatewaySubSystem{sensorSubSystem::radio};
+
+uint32_t outputFunctionGateway(const gatewayLog::logSpan* spans, uint32_t nmbrSpans) {
+    gatewayLength    = spans[0].length;
+    gatewaySubSystem = spans[0].theSubSystem;
+    return nmbrSpans;
+}
+
+void test_uLog_configuration() {
+    static_assert(gatewayLog::maxNmbrOutputs == 8, "configured");
+    static_assert(sizeof(gatewayLog) > sizeof(uLog), "buffer and outputs are sized by the configuration");
+    gatewayLog aLog;
+    aLog.setBatchOutput(7, outputFunctionGateway);        // last of 8 outputs
+    aLog.setLoggingLevel(7, sensorSubSystem::sensor, loggingLevel::Info);
+    TEST_ASSERT_TRUE(aLog.outputIsActive(7));
+    TEST_ASSERT_FALSE(aLog.outputIsActive(8));
+
+    char longText[200];
+    memset(longText, 'x', sizeof(longText) - 1U);
+    longText[sizeof(longText) - 1U] = 0;
+    ULOG_OUTPUT(aLog, sensorSubSystem::radio, loggingLevel::Info, longText);        // not wanted by the output
+    TEST_ASSERT_EQUAL_UINT32(0, gatewayLength);
+    ULOG_OUTPUT(aLog, sensorSubSystem::sensor, loggingLevel::Info, longText);
+    TEST_ASSERT_EQUAL_UINT32(gatewayLogConfig::maxItemLength, gatewayLength);        // truncated to the configured length
+    TEST_ASSERT_TRUE(gatewaySubSystem == sensorSubSystem::sensor);
+    gatewayLog::metricsSnapshot aSnapshot;
+    aLog.getMetrics(aSnapshot);
+    TEST_ASSERT_EQUAL_UINT32(0, aSnapshot.total(logCounter::logged));        // metrics disabled in this configuration
+    TEST_ASSERT_EQUAL_UINT32(gatewayLogConfig::bufferSize, aSnapshot.bufferSize);
+}
+
+struct stagedLogConfig : logConfig {
+    static constexpr uint32_t nmbrStagingBuffers = 4;
+};
+
+typedef basicLog<stagedLogConfig> stagedLog;
+
+char stagedReceived[2048];
+
+bool outputFunctionStaged(const char* contents) {
+    strcat(stagedReceived, contents);
+    return true;
+}
+
+void test_uLog_staging_full() {
+    stagedLog aLog;
+    aLog.setOutput(0, outputFunctionStaged);
+    aLog.setLoggingLevel(0, loggingLevel::Info);
+    stagedReceived[0] = 0;
+    char text[8];
+    for (uint32_t index = 0; index < 10; index++) {        // more than fits in one staging buffer : it gets merged into the shared buffer
+        ::snprintf(text, sizeof(text), "%u", index);
+        aLog.log(subSystem::general, loggingLevel::Info, text);
+    }
+    TEST_ASSERT_NOT_EQUAL(0, aLog.items.level());
+    aLog.flush();
+    TEST_ASSERT_EQUAL_STRING("I 0\nI 1\nI 2\nI 3\nI 4\nI 5\nI 6\nI 7\nI 8\nI 9\n", stagedReceived);
+    TEST_ASSERT_EQUAL_UINT32(0, aLog.getDroppedItems());
+}
+
+struct persistentLogConfig : logConfig {
+    static constexpr bool externalBuffer = true;
+};
+
+typedef basicLog<persistentLogConfig> persistentLog;
+
+char persistentReceived[512];
+
+bool outputFunctionPersistent(const char* contents) {
+    strcat(persistentReceived, contents);
+    return true;
+}
+
+void test_uLog_persistent_buffer() {
+    alignas(logArenaRegion<persistentLog::bufferSize>) static uint8_t memory[persistentLog::attachedBufferSize];        // as a .noinit section
+    memset(memory, 0xA5, sizeof(memory));
+    persistentReceived[0] = 0;
+    {
+        persistentLog aLog;
+        aLog.setOutput(0, outputFunctionPersistent);
+        aLog.setLoggingLevel(0, loggingLevel::Info);
+        aLog.log(subSystem::general, loggingLevel::Info, "lost");        // nowhere to store it yet
+        TEST_ASSERT_EQUAL_UINT32(1, aLog.getDroppedItems());
+        TEST_ASSERT_FALSE(aLog.attachBuffer(memory, sizeof(memory)));        // first run
+        TEST_ASSERT_EQUAL_UINT32(0, aLog.getRecoveredItems());
+        aLog.log(subSystem::general, loggingLevel::Info, "before reset");
+        aLog.logDeferred(subSystem::general, loggingLevel::Error, "value %d", 42);
+        uint32_t position;
+        TEST_ASSERT_TRUE(aLog.items.peek(position));
+        TEST_ASSERT_EQUAL_PTR(memory, reinterpret_cast<uint8_t*>(aLog.item(position)) - offsetof(logArenaRegion<persistentLog::bufferSize>, storage) - logArena<persistentLog::bufferSize>::headerSize);        // written in place
+    }        // reset, without outputting them
+    TEST_ASSERT_EQUAL_STRING("", persistentReceived);
+
+    persistentLog aLog;        // the next run
+    aLog.setOutput(0, outputFunctionPersistent);
+    aLog.setLoggingLevel(0, loggingLevel::Info);
+    TEST_ASSERT_TRUE(aLog.attachBuffer(memory, sizeof(memory)));
+    TEST_ASSERT_EQUAL_UINT32(2, aLog.getRecoveredItems());
+    aLog.output(subSystem::general, loggingLevel::Info, "after reset");
+    TEST_ASSERT_EQUAL_STRING("I before reset\nE (deferred item of a previous run)\nI after reset\n", persistentReceived);
+}
+
+uint8_t binaryFrames[4][uLog::lineSize];        // as received, COBS encoded
+uint32_t binaryLengths[4];
+uint32_t nmbrBinaryFrames{0};
+
+uint32_t outputFunctionBinary(const logSpan* spans, uint32_t nmbrSpans) {
+    for (uint32_t index = 0; index < nmbrSpans; index++) {
+        memcpy(binaryFrames[nmbrBinaryFrames], spans[index].text, spans[index].length);
+        binaryLengths[nmbrBinaryFrames++] = spans[index].length;
+    }
+    return nmbrSpans;
+}
+
+void test_uLog_binary_output() {
+    uLog aLog;
+    aLog.setTickSource(loggingTick);
+    aLog.setBatchOutput(0, outputFunctionBinary);
+    aLog.setBinaryOutput(0, true);
+    aLog.setLoggingLevel(0, loggingLevel::Info);
+    TEST_ASSERT_TRUE(aLog.isBinaryOutput(0));
+    nmbrBinaryFrames = 0;
+    aLog.log(subSystem::nfc, loggingLevel::Warning, "lorem ipse");
+    aLog.logDeferred(subSystem::general, loggingLevel::Error, "Error in %s on line %d", "main.cpp", 123);
+    aLog.flush();
+    TEST_ASSERT_EQUAL_UINT32(2, nmbrBinaryFrames);
+
+    uint8_t frame[uLog::lineSize];
+    TEST_ASSERT_EQUAL_UINT8(0, binaryFrames[0][binaryLengths[0] - 1U]);        // text item
+    TEST_ASSERT_NULL(memchr(binaryFrames[0], 0, binaryLengths[0] - 1U));       // delimiter is the only zero
+    uint32_t length = logBinary::decode(binaryFrames[0], binaryLengths[0] - 1U, frame);
+    uint8_t tick[logBinary::maxVarintLength];
+    uint32_t tickLength = logBinary::putVarint(tick, loggingTick());
+    TEST_ASSERT_EQUAL_UINT32(1 + tickLength + 1 + 10, length);        // flags, tick, level and subSystem, text
+    TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(logBinary::recordType::text) | (static_cast<uint8_t>(logBinary::timestampType::tick) << 2), frame[0]);
+    TEST_ASSERT_EQUAL_MEMORY(tick, frame + 1, tickLength);
+    TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(loggingLevel::Warning) | (static_cast<uint8_t>(subSystem::nfc) << 3), frame[1 + tickLength]);
+    TEST_ASSERT_EQUAL_MEMORY("lorem ipse", frame + 2 + tickLength, 10);
+
+    length = logBinary::decode(binaryFrames[1], binaryLengths[1] - 1U, frame);        // deferred item : format ID and raw args
+    TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(logBinary::recordType::deferred) | (static_cast<uint8_t>(logBinary::timestampType::tick) << 2), frame[0]);
+    uint64_t formatId;
+    uint32_t index = 2 + tickLength;
+    index += logBinary::getVarint(frame + index, length - index, formatId);
+    TEST_ASSERT_EQUAL_UINT32(logBinary::formatId("Error in %s on line %d"), formatId);
+    char rendered[64];
+    logArgs::render(rendered, sizeof(rendered), "Error in %s on line %d", reinterpret_cast<const char*>(frame + index), length - index);
+    TEST_ASSERT_EQUAL_STRING("Error in main.cpp on line 123", rendered);
+}
+
+char internedLine[uLog::lineSize];
+
+bool outputFunctionInterned(const char* contents) {
+    strcpy(internedLine, contents);
+    return true;
+}
+
+void test_uLog_interned_format() {
+    uLog aLog;
+    aLog.setOutput(0, outputFunctionInterned);
+    aLog.setLoggingLevel(0, loggingLevel::Info);
+    aLog.setBatchOutput(1, outputFunctionBinary);
+    aLog.setBinaryOutput(1, true);
+    aLog.setLoggingLevel(1, loggingLevel::Info);
+    nmbrBinaryFrames = 0;
+    aLog.logDeferred(subSystem::general, loggingLevel::Error, ULOG_FORMAT("Error in %s on line %d"), "main.cpp", 123);
+    uint32_t position;
+    TEST_ASSERT_TRUE(aLog.items.peek(position));
+    TEST_ASSERT_TRUE(aLog.item(position)->internedFormat);
+    TEST_ASSERT_EQUAL_STRING("Error in %s on line %d", aLog.item(position)->formatText());
+    aLog.flush();
+    TEST_ASSERT_EQUAL_STRING("E Error in main.cpp on line 123\n", internedLine);        // text outputs still get the text
+
+    uint8_t frame[uLog::lineSize];        // binary outputs get the ID computed at compile time
+    uint32_t length = logBinary::decode(binaryFrames[0], binaryLengths[0] - 1U, frame);
+    uint64_t formatId;
+    TEST_ASSERT_NOT_EQUAL(0, logBinary::getVarint(frame + 2, length - 2, formatId));        // no timestamp
+    TEST_ASSERT_EQUAL_UINT32(logFormatId("Error in %s on line %d"), formatId);
+}
+
+char structuredLines[2][uLog::lineSize];
+
+bool outputFunctionStructured0(const char* contents) {
+    strcpy(structuredLines[0], contents);
+    return true;
+}
+
+bool outputFunctionStructured1(const char* contents) {
+    strcpy(structuredLines[1], contents);
+    return true;
+}
+
+void test_uLog_structured() {
+    uLog aLog;
+    aLog.setOutput(0, outputFunctionStructured0);
+    aLog.setLoggingLevel(0, loggingLevel::Info);
+    aLog.setOutput(1, outputFunctionStructured1);
+    aLog.setLoggingLevel(1, loggingLevel::Info);
+    aLog.setEncoding(1, logEncoding::logfmt);
+    TEST_ASSERT_EQUAL(logEncoding::logfmt, aLog.getEncoding(1));
+    aLog.log(subSystem::networkData, loggingLevel::Warning, "joined", kv("rssi", -71), kv("slot", 3U), kv("ssid", "my net"));
+    uint32_t position;
+    TEST_ASSERT_TRUE(aLog.items.peek(position));
+    TEST_ASSERT_TRUE(aLog.item(position)->structured);        // stored packed, formatted by each output
+    aLog.flush();
+    TEST_ASSERT_EQUAL_STRING("W joined rssi=-71 slot=3 ssid=\"my net\"\n", structuredLines[0]);
+    TEST_ASSERT_EQUAL_STRING("level=Warning subsystem=12 msg=joined rssi=-71 slot=3 ssid=\"my net\"\n", structuredLines[1]);
+
+    aLog.setEncoding(0, logEncoding::json);
+    aLog.log(subSystem::general, loggingLevel::Error, "ratio", kv("value", 0.5), kv("note", "say \"hi\""));
+    aLog.log(subSystem::general, loggingLevel::Info, "plain text");        // unstructured items get the same envelope
+    aLog.logDeferred(subSystem::general, loggingLevel::Info, "value %d", 7);
+    aLog.flush();
+    TEST_ASSERT_EQUAL_STRING("{\"level\":\"Info\",\"subsystem\":0,\"msg\":\"value 7\"}\n", structuredLines[0]);
+    TEST_ASSERT_EQUAL_STRING("level=Info subsystem=0 msg=\"value 7\"\n", structuredLines[1]);
+
+    aLog.setEncoding(1, logEncoding::json);
+    aLog.log(subSystem::general, loggingLevel::Error, "ratio", kv("value", 0.5), kv("note", "say \"hi\""));
+    aLog.flush();
+    TEST_ASSERT_EQUAL_STRING("{\"level\":\"Error\",\"subsystem\":0,\"msg\":\"ratio\",\"value\":0.5,\"note\":\"say \\\"hi\\\"\"}\n", structuredLines[0]);
+    TEST_ASSERT_EQUAL_STRING(structuredLines[0], structuredLines[1]);        // same format, so formatted once
+
+    aLog.setEncoding(0, logEncoding::text);
+    char longValue[2 * logItem::maxItemLength];
+    memset(longValue, 'x', sizeof(longValue) - 1U);
+    longValue[sizeof(longValue) - 1U] = 0;
+    aLog.log(subSystem::general, loggingLevel::Info, "long", kv("first", 1), kv("long", static_cast<const char*>(longValue)), kv("last", 2));
+    aLog.flush();
+    TEST_ASSERT_EQUAL_STRING("I long first=1\n", structuredLines[0]);        // fields not fitting are left out, not cut
+    TEST_ASSERT_EQUAL_STRING("{\"level\":\"Info\",\"subsystem\":0,\"msg\":\"long\",\"first\":1}\n", structuredLines[1]);
+}
+
+void test_uLog_structured_binary() {
+    uLog aLog;
+    aLog.setBatchOutput(0, outputFunctionBinary);
+    aLog.setEncoding(0, logEncoding::binary);
+    aLog.setLoggingLevel(0, loggingLevel::Info);
+    nmbrBinaryFrames = 0;
+    aLog.log(subSystem::nfc, loggingLevel::Info, "card", kv("uid", 0x1234U), kv("valid", 1));
+    aLog.flush();
+    TEST_ASSERT_EQUAL_UINT32(1, nmbrBinaryFrames);
+
+    uint8_t frame[uLog::lineSize];        // packed message and fields, as stored
+    uint32_t length = logBinary::decode(binaryFrames[0], binaryLengths[0] - 1U, frame);
+    TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(logBinary::recordType::structured), frame[0]);
+    const char* message;
+    uint32_t messageLength;
+    uint32_t fieldsStart = logLineWriter::message(reinterpret_cast<const char*>(frame + 2), length - 2, message, messageLength);
+    char line[uLog::lineSize];
+    logLineWriter aLine(line, 0, logItem::maxItemLength - 1U, logEncoding::text);
+    aLine.addText(message, messageLength);
+    aLine.addFields(reinterpret_cast<const char*>(frame + 2 + fieldsStart), length - (2 + fieldsStart));
+    aLine.end();
+    TEST_ASSERT_EQUAL_STRING("card uid=4660 valid=1\n", line);
+}
+
+char limitedReceived[1024];
+
+bool outputFunctionLimited(const char* contents) {
+    strcat(limitedReceived, contents);
+    return true;
+}
+
+struct limitedLogConfig : logConfig {
+    static constexpr bool rateLimiting = true;
+};
+
+typedef basicLog<limitedLogConfig> limitedLog;
+
+void test_uLog_suppress_duplicates() {
+    limitedLog aLog;
+    aLog.setOutput(0, outputFunctionLimited);
+    aLog.setLoggingLevel(0, loggingLevel::Info);
+    aLog.setSuppressDuplicates(true);
+    limitedReceived[0] = 0;
+    for (uint32_t index = 0; index < 57; index++) {
+        aLog.log(subSystem::networkData, loggingLevel::Warning, "link down");
+        aLog.logDeferred(subSystem::general, loggingLevel::Info, "value %d", 1);        // interleaved, but of another subSystem
+    }
+    aLog.log(subSystem::networkData, loggingLevel::Info, "link up");
+    aLog.flush();
+    TEST_ASSERT_EQUAL_STRING("W link down\nI value 1\nW last message repeated 56 times\nI link up\nI last message repeated 56 times\n", limitedReceived);
+}
+
+void test_uLog_rate_limit() {
+    limitedLog aLog;
+    aLog.setOutput(0, outputFunctionLimited);
+    aLog.setLoggingLevel(0, loggingLevel::Info);
+    aLog.setRateLimit(subSystem::wifiSignalStrenght, 1, 2);        // 1 item per second, bursts of 2
+    limitedReceived[0] = 0;
+    char text[16];
+    for (uint32_t index = 0; index < 20; index++) {
+        ::snprintf(text, sizeof(text), "rssi %u", index);
+        aLog.log(subSystem::wifiSignalStrenght, loggingLevel::Info, text);
+    }
+    aLog.log(subSystem::general, loggingLevel::Info, "other");        // not starved
+    TEST_ASSERT_EQUAL_UINT32(18, aLog.getRateLimitedItems());
+    TEST_ASSERT_EQUAL_UINT32(0, aLog.getDroppedItems());
+    aLog.flush();
+    TEST_ASSERT_EQUAL_STRING("I rssi 0\nI rssi 1\nI other\nW 18 items dropped by the rate limit\n", limitedReceived);
+}
+
+void test_uLog_rate_limit_disabled() {
+    static_assert(sizeof(uLog) < sizeof(limitedLog), "without rateLimiting, the limiter takes no memory");
+    uLog aLog;        // rateLimiting false
+    aLog.setOutput(0, outputFunctionLimited);
+    aLog.setLoggingLevel(0, loggingLevel::Info);
+    aLog.setRateLimit(subSystem::wifiSignalStrenght, 1, 1);
+    aLog.setSuppressDuplicates(true);
+    limitedReceived[0] = 0;
+    aLog.log(subSystem::wifiSignalStrenght, loggingLevel::Info, "rssi");
+    aLog.log(subSystem::wifiSignalStrenght, loggingLevel::Info, "rssi");
+    aLog.flush();
+    TEST_ASSERT_EQUAL_STRING("I rssi\nI rssi\n", limitedReceived);
+    TEST_ASSERT_EQUAL_UINT32(0, aLog.getRateLimitedItems());
+}
+
+bool slowAccepts{true};        // does the slow output accept items
+uint32_t nmbrSlowItems{0};
+char slowReceived[1024];
+
+bool outputFunctionSlow(const char* contents) {
+    if (slowAccepts) {
+        strcat(slowReceived, contents);
+        nmbrSlowItems++;
+    }
+    return slowAccepts;
+}
+
+void test_uLog_independent_outputs() {
+    uLog aLog;
+    aLog.setOutput(0, outputFunctionLimited);
+    aLog.setLoggingLevel(0, loggingLevel::Info);
+    aLog.setOutput(1, outputFunctionSlow);
+    aLog.setLoggingLevel(1, loggingLevel::Info);
+    limitedReceived[0] = 0;
+    slowReceived[0]    = 0;
+    nmbrSlowItems      = 0;
+    slowAccepts        = false;        // output 1 is stalled
+    char text[16];
+    for (uint32_t index = 0; index < 10; index++) {        // more than a batch
+        ::snprintf(text, sizeof(text), "item %u", index);
+        aLog.log(subSystem::general, loggingLevel::Info, text);
+    }
+    aLog.flush();
+    TEST_ASSERT_EQUAL_STRING("I item 0\nI item 1\nI item 2\nI item 3\nI item 4\nI item 5\nI item 6\nI item 7\nI item 8\nI item 9\n", limitedReceived);        // not held back by output 1
+    TEST_ASSERT_NOT_EQUAL(0, aLog.items.level());        // kept for output 1
+    TEST_ASSERT_EQUAL_UINT32(0, nmbrSlowItems);
+    slowAccepts        = true;
+    limitedReceived[0] = 0;
+    aLog.flush();
+    TEST_ASSERT_EQUAL_UINT32(10, nmbrSlowItems);
+    TEST_ASSERT_EQUAL_STRING("", limitedReceived);        // output 0 gets nothing twice
+    TEST_ASSERT_EQUAL_UINT32(0, aLog.items.level());
+    TEST_ASSERT_EQUAL_UINT32(0, aLog.getLaggedItems(1));
+}
+
+void test_uLog_lag_limit() {
+    uLog aLog;
+    aLog.setOutput(0, outputFunctionLimited);
+    aLog.setLoggingLevel(0, loggingLevel::Info);
+    aLog.setOutput(1, outputFunctionSlow);
+    aLog.setLoggingLevel(1, loggingLevel::Info);
+    aLog.log(subSystem::general, loggingLevel::Info, "item x");
+    uint32_t itemBytes = aLog.items.level();        // all items below have the same length
+    slowAccepts        = true;
+    aLog.flush();
+
+    aLog.setLagLimit(1, 3 * itemBytes);        // output 1 may lag 3 items
+    TEST_ASSERT_EQUAL_UINT32(3 * itemBytes, aLog.outputs[1].getLagLimit());
+    limitedReceived[0] = 0;
+    slowReceived[0]    = 0;
+    slowAccepts        = false;
+    char text[16];
+    for (uint32_t index = 0; index < 10; index++) {
+        ::snprintf(text, sizeof(text), "item %u", index);
+        aLog.log(subSystem::general, loggingLevel::Info, text);
+    }
+    aLog.flush();
+    TEST_ASSERT_EQUAL_UINT32(7, aLog.getLaggedItems(1));
+    TEST_ASSERT_EQUAL_UINT32(3 * itemBytes, aLog.items.level());        // output 1 only holds on to its 3 newest items
+    slowAccepts = true;
+    aLog.flush();
+    TEST_ASSERT_EQUAL_STRING("I item 7\nI item 8\nI item 9\n", slowReceived);
+    TEST_ASSERT_EQUAL_UINT32(0, aLog.items.level());
+
+    aLog.setLagLimit(1, 3 * itemBytes, lagPolicy::skipToNewest);
+    slowReceived[0] = 0;
+    slowAccepts     = false;
+    for (uint32_t index = 0; index < 5; index++) {
+        ::snprintf(text, sizeof(text), "item %u", index);
+        aLog.log(subSystem::general, loggingLevel::Info, text);
+    }
+    aLog.flush();
+    TEST_ASSERT_EQUAL_UINT32(7 + 5, aLog.getLaggedItems(1));
+    TEST_ASSERT_EQUAL_UINT32(0, aLog.items.level());
+    slowAccepts = true;
+    aLog.log(subSystem::general, loggingLevel::Info, "newest");
+    aLog.flush();
+    TEST_ASSERT_EQUAL_STRING("I newest\n", slowReceived);
+    TEST_ASSERT_EQUAL_UINT32(0, aLog.getLaggedItems(0));
+}
+
+struct metricsLogConfig : logConfig {
+    static constexpr bool collectMetrics = true;
+};
+
+typedef basicLog<metricsLogConfig> metricsLog;
+
+void test_uLog_metrics() {
+    metricsLog aLog;
+    metricsLog::metricsSnapshot aSnapshot;
+    aLog.setOutput(0, outputFunctionLimited);
+    aLog.setLoggingLevel(0, loggingLevel::Info);
+    aLog.setOutput(1, outputFunctionSlow);
+    aLog.setLoggingLevel(1, loggingLevel::Info);
+    limitedReceived[0] = 0;
+    slowReceived[0]    = 0;
+    slowAccepts        = false;
+    char longText[logItem::maxItemLength + 16U];
+    memset(longText, 'x', sizeof(longText) - 1U);
+    longText[sizeof(longText) - 1U] = 0;
+    aLog.log(subSystem::nfc, loggingLevel::Info, "a");
+    aLog.log(subSystem::nfc, loggingLevel::Debug, "filtered");
+    aLog.logDeferred(subSystem::nfc, loggingLevel::Debug, "filtered %d", 1);
+    aLog.log(subSystem::display, loggingLevel::Info, longText);
+    aLog.snprintf(subSystem::display, loggingLevel::Info, "%s", longText);        // also outputs
+    uint32_t level = aLog.items.level();
+    aLog.flush();
+    aLog.getMetrics(aSnapshot);
+    TEST_ASSERT_EQUAL_UINT32(1, aSnapshot.get(subSystem::nfc, logCounter::logged));
+    TEST_ASSERT_EQUAL_UINT32(2, aSnapshot.get(subSystem::nfc, logCounter::filtered));
+    TEST_ASSERT_EQUAL_UINT32(2, aSnapshot.get(subSystem::display, logCounter::logged));
+    TEST_ASSERT_EQUAL_UINT32(2, aSnapshot.get(subSystem::display, logCounter::truncated));
+    TEST_ASSERT_EQUAL_UINT32(3, aSnapshot.total(logCounter::logged));
+    TEST_ASSERT_EQUAL_UINT32(3, aSnapshot.get(0, logOutputCounter::delivered));
+    TEST_ASSERT_EQUAL_UINT32(0, aSnapshot.get(0, logOutputCounter::rejected));
+    TEST_ASSERT_EQUAL_UINT32(0, aSnapshot.get(1, logOutputCounter::delivered));
+    TEST_ASSERT_TRUE(aSnapshot.get(1, logOutputCounter::rejected) >= 3);        // offered at each round, and not accepted
+    TEST_ASSERT_TRUE(aSnapshot.highWaterMark >= level);
+    TEST_ASSERT_EQUAL_UINT32(metricsLog::bufferSize, aSnapshot.bufferSize);
+    TEST_ASSERT_TRUE(aSnapshot.latencyPercentile(0, 100) > 0);
+    TEST_ASSERT_EQUAL_UINT32(0, aSnapshot.latencyPercentile(1, 100));
+
+    while (aLog.items.level() < (metricsLog::bufferSize / 2U)) {        // output 1 holds on to its items, so the buffer fills up
+        aLog.log(subSystem::nfc, loggingLevel::Info, longText);
+    }
+    for (uint32_t index = 0; index < 20; index++) {
+        aLog.log(subSystem::nfc, loggingLevel::Info, longText);
+    }
+    aLog.getMetrics(aSnapshot);
+    TEST_ASSERT_TRUE(aSnapshot.get(subSystem::nfc, logCounter::overwritten) > 0);        // overflowPolicy::dropOldest
+    TEST_ASSERT_EQUAL_UINT32(aLog.getDroppedItems(), aSnapshot.total(logCounter::overwritten) + aSnapshot.total(logCounter::dropped));
+    TEST_ASSERT_TRUE(aSnapshot.highWaterMark > (metricsLog::bufferSize / 2U));
+    slowAccepts = true;
+    aLog.flush();
+
+    limitedReceived[0] = 0;
+    aLog.setMetricsInterval(1, subSystem::general);
+    waitMicroseconds(2000U);
+    aLog.flush();
+    TEST_ASSERT_EQUAL_STRING_LEN("I metrics log ", limitedReceived, 14);        // logged by output()
+    aLog.setMetricsInterval(0, subSystem::general);
+    limitedReceived[0] = 0;
+    waitMicroseconds(2000U);
+    aLog.flush();
+    TEST_ASSERT_EQUAL_STRING("", limitedReceived);
+}
+
+struct recorderLogConfig : logConfig {
+    static constexpr uint32_t bufferSize   = 2048;
+    static constexpr uint32_t recorderSize = 512;
+    static constexpr bool collectMetrics   = true;
+};
+
+char recorderReceived[2][1024];
+
+bool outputFunctionRecorder0(const char* contents) {
+    strcat(recorderReceived[0], contents);
+    return true;
+}
+
+bool outputFunctionRecorder1(const char* contents) {
+    strcat(recorderReceived[1], contents);
+    return true;
+}
+
+void test_uLog_flight_recorder() {
+    basicLog<recorderLogConfig> aLog;
+    aLog.setOutput(0, outputFunctionRecorder0);
+    aLog.setLoggingLevel(0, loggingLevel::Info);
+    aLog.setFlightRecorder(loggingLevel::Debug, loggingLevel::Error, 3);
+    recorderReceived[0][0] = 0;
+    aLog.log(subSystem::nfc, loggingLevel::Debug, "d1");
+    aLog.log(subSystem::nfc, loggingLevel::Debug, "d2");
+    char format[8];
+    strcpy(format, "d%d");
+    aLog.snprintf(subSystem::nfc, loggingLevel::Debug, format, 3);                     // formatted when recorded
+    strcpy(format, "x%d");                                                             // so its format may change, or go out of scope
+    aLog.logDeferred(subSystem::display, loggingLevel::Debug, "d%s", "4");             // not formatted until dumped
+    aLog.log(subSystem::nfc, loggingLevel::Debug, "d5", kv("uid", 5));                 //
+    aLog.log(subSystem::general, loggingLevel::Info, "i1");                            // wanted by the output, but no trigger
+    aLog.flush();
+    TEST_ASSERT_EQUAL_STRING("I i1\n", recorderReceived[0]);
+    aLog.log(subSystem::general, loggingLevel::Error, "e1");
+    aLog.flush();
+    TEST_ASSERT_EQUAL_STRING("I i1\nD d3\nD d4\nD d5 uid=5\nE e1\n", recorderReceived[0]);        // the last 3, then the trigger
+    aLog.log(subSystem::general, loggingLevel::Critical, "c1");        // the recorder was emptied by the previous dump
+    aLog.flush();
+    TEST_ASSERT_EQUAL_STRING("I i1\nD d3\nD d4\nD d5 uid=5\nE e1\nC c1\n", recorderReceived[0]);
+
+    basicLog<recorderLogConfig>::metricsSnapshot aSnapshot;
+    aLog.getMetrics(aSnapshot);
+    TEST_ASSERT_EQUAL_UINT32(5, aSnapshot.total(logCounter::recorded));
+    TEST_ASSERT_EQUAL_UINT32(0, aSnapshot.total(logCounter::filtered));
+    TEST_ASSERT_EQUAL_UINT32(3, aSnapshot.total(logCounter::logged));
+
+    aLog.setFlightRecorder(loggingLevel::None);
+    aLog.log(subSystem::nfc, loggingLevel::Debug, "d6");
+    aLog.log(subSystem::general, loggingLevel::Error, "e2");
+    aLog.flush();
+    TEST_ASSERT_EQUAL_STRING("I i1\nD d3\nD d4\nD d5 uid=5\nE e1\nC c1\nE e2\n", recorderReceived[0]);
+}
+
+void test_uLog_flight_recorder_outputs() {
+    basicLog<recorderLogConfig> aLog;
+    aLog.setOutput(0, outputFunctionRecorder0);
+    aLog.setOutput(1, outputFunctionRecorder1);
+    aLog.setLoggingLevel(0, loggingLevel::Error);
+    aLog.setLoggingLevel(1, loggingLevel::Critical);
+    aLog.setLoggingLevel(1, subSystem::nfc, loggingLevel::Info);
+    aLog.setFlightRecorder(loggingLevel::Info, loggingLevel::Error);
+    recorderReceived[0][0] = 0;
+    recorderReceived[1][0] = 0;
+    char text[16];
+    for (uint32_t index = 0; index < 100; index++) {        // more than the recorder holds, so it keeps the newest ones
+        ::snprintf(text, sizeof(text), "w%u", index);
+        aLog.log(subSystem::general, loggingLevel::Warning, text);
+    }
+    aLog.log(subSystem::nfc, loggingLevel::Info, "n1");        // wanted by output 1, so not recorded
+    aLog.log(subSystem::general, loggingLevel::Error, "e1");        // dumps to output 0 only, as output 1 does not want it
+    aLog.flush();
+    TEST_ASSERT_EQUAL_STRING("I n1\n", recorderReceived[1]);
+    TEST_ASSERT_EQUAL_STRING("W w99\nE e1\n", strstr(recorderReceived[0], "W w99\n"));
+    const char* oldest = recorderReceived[0] + 2;
+    uint32_t nmbrDumped = static_cast<uint32_t>(100U - strtoul(oldest + 1, nullptr, 10));        // the dumped items are the newest, in order
+    TEST_ASSERT_TRUE((nmbrDumped > 5U) && (nmbrDumped < 100U));
+    char expected[1024] = "";
+    for (uint32_t index = 100U - nmbrDumped; index < 100U; index++) {
+        ::snprintf(text, sizeof(text), "W w%u\n", index);
+        strcat(expected, text);
+    }
+    strcat(expected, "E e1\n");
+    TEST_ASSERT_EQUAL_STRING(expected, recorderReceived[0]);
+}
+
+void test_uLog_flight_recorder_disabled() {
+    uLog aLog;        // recorderSize 0
+    aLog.setOutput(0, outputFunctionRecorder0);
+    aLog.setLoggingLevel(0, loggingLevel::Info);
+    aLog.setFlightRecorder(loggingLevel::Debug);
+    recorderReceived[0][0] = 0;
+    aLog.log(subSystem::nfc, loggingLevel::Debug, "d1");
+    aLog.log(subSystem::nfc, loggingLevel::Error, "e1");
+    aLog.flush();
+    TEST_ASSERT_EQUAL_STRING("E e1\n", recorderReceived[0]);
+}
+
+void test_uLog_lazy_message() {
+    basicLog<recorderLogConfig> aLog;
+    aLog.setOutput(0, outputFunctionRecorder0);
+    aLog.setLoggingLevel(0, loggingLevel::Info);
+    recorderReceived[0][0] = 0;
+    uint32_t nmbrCalls{0};
+    TEST_ASSERT_FALSE(aLog.isEnabled(subSystem::nfc, loggingLevel::Debug));
+    TEST_ASSERT_TRUE(aLog.isEnabled(subSystem::nfc, loggingLevel::Info));
+    aLog.log(subSystem::nfc, loggingLevel::Debug, [&nmbrCalls](char* buffer, uint32_t length) {
+        nmbrCalls++;
+        ::snprintf(buffer, length, "frame %02X", 0xA5);
+    });
+    TEST_ASSERT_EQUAL_UINT32(0, nmbrCalls);        // filtered, so the message is not even made
+    aLog.log(subSystem::nfc, loggingLevel::Info, [&nmbrCalls](char* buffer, uint32_t length) {
+        nmbrCalls++;
+        ::snprintf(buffer, length, "frame %02X", 0xA5);
+    });
+    TEST_ASSERT_EQUAL_UINT32(1, nmbrCalls);
+    aLog.log(subSystem::nfc, loggingLevel::Info, [](char* buffer, uint32_t length) {
+        memset(buffer, 'x', length);        // not terminated, so it is cut to the longest item
+    });
+    aLog.log(subSystem::nfc, loggingLevel::Info, [](char* buffer, uint32_t length) {});        // writes nothing
+    aLog.flush();
+    TEST_ASSERT_EQUAL_STRING_LEN("I frame A5\nI xxxxxxxxxx", recorderReceived[0], 23);
+    TEST_ASSERT_EQUAL_STRING("x\nI \n", recorderReceived[0] + strlen(recorderReceived[0]) - 5U);
+    TEST_ASSERT_TRUE(strlen(recorderReceived[0]) < (11U + recorderLogConfig::maxItemLength + 4U));
+
+    aLog.setFlightRecorder(loggingLevel::Debug);        // recorded items are made as well
+    TEST_ASSERT_TRUE(aLog.isEnabled(subSystem::nfc, loggingLevel::Debug));
+    aLog.log(subSystem::nfc, loggingLevel::Debug, [&nmbrCalls](char* buffer, uint32_t length) {
+        nmbrCalls++;
+        ::snprintf(buffer, length, "frame %02X", 0x5A);
+    });
+    TEST_ASSERT_EQUAL_UINT32(2, nmbrCalls);
+    recorderReceived[0][0] = 0;
+    aLog.log(subSystem::nfc, loggingLevel::Error, "crc");
+    aLog.flush();
+    TEST_ASSERT_EQUAL_STRING("D frame 5A\nE crc\n", recorderReceived[0]);
+
+    char text[16] = "not a callable";        // a char buffer still selects log() of a text
+    aLog.log(subSystem::nfc, loggingLevel::Info, text);
+}
+
 int main(int argc, char** argv) {
     UNITY_BEGIN();
     RUN_TEST(test_uLog_initialization);
     RUN_TEST(test_uLog_filtering);
+    RUN_TEST(test_uLog_outputMasks);
+    RUN_TEST(test_uLog_level_rules);
     RUN_TEST(test_uLog_circular_buffer);
+    RUN_TEST(test_uLog_packed_items);
+    RUN_TEST(test_uLog_publish);
     RUN_TEST(test_uLog_output);
     RUN_TEST(test_uLog_getTime);
     RUN_TEST(test_uLog_boundaries);
     RUN_TEST(test_uLog_output2);
+    RUN_TEST(test_uLog_deferred);
+    RUN_TEST(test_uLog_overflow_policies);
+    RUN_TEST(test_uLog_overflow_block);
+    RUN_TEST(test_uLog_batch_output);
+    RUN_TEST(test_uLog_batch_retry);
+    RUN_TEST(test_uLog_format);
+    RUN_TEST(test_uLog_tick_timestamp);
+    RUN_TEST(test_uLog_shared_lines);
+    RUN_TEST(test_uLog_configuration);
+    RUN_TEST(test_uLog_staging_full);
+    RUN_TEST(test_uLog_persistent_buffer);
+    RUN_TEST(test_uLog_binary_output);
+    RUN_TEST(test_uLog_interned_format);
+    RUN_TEST(test_uLog_structured);
+    RUN_TEST(test_uLog_structured_binary);
+    RUN_TEST(test_uLog_suppress_duplicates);
+    RUN_TEST(test_uLog_rate_limit);
+    RUN_TEST(test_uLog_rate_limit_disabled);
+    RUN_TEST(test_uLog_independent_outputs);
+    RUN_TEST(test_uLog_lag_limit);
+    RUN_TEST(test_uLog_metrics);
+    RUN_TEST(test_uLog_flight_recorder);
+    RUN_TEST(test_uLog_flight_recorder_outputs);
+    RUN_TEST(test_uLog_flight_recorder_disabled);
+    RUN_TEST(test_uLog_lazy_message);
     UNITY_END();
 }
\ No newline at end of file
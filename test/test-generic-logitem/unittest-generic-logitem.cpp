@@ -3,7 +3,21 @@
 #include <unity.h>
 #include "logging.h"
 
+void test_logItem_layout() {
+    alignas(logItem) uint8_t storage[logItem::storageLength(4, 6)];        // item header, followed by timestamp and contents
+    logItem* anItem       = reinterpret_cast<logItem*>(storage);
+    anItem->timestampSize = 4;
+    anItem->contentsSize  = 6;
+    strcpy(anItem->timestamp(), "123");
+    strcpy(anItem->contents(), "lorem");
+    TEST_ASSERT_EQUAL_UINT32(sizeof(logItem) + 10, sizeof(storage));
+    TEST_ASSERT_EQUAL_STRING("123", anItem->timestamp());
+    TEST_ASSERT_EQUAL_STRING("lorem", anItem->contents());
+    TEST_ASSERT_EQUAL(reinterpret_cast<char*>(storage) + sizeof(logItem) + 4, anItem->contents());
+}
+
 int main(int argc, char** argv) {
     UNITY_BEGIN();
+    RUN_TEST(test_logItem_layout);
     UNITY_END();
-}
\ No newline at end of file
+}
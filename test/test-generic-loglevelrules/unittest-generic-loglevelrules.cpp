@@ -0,0 +1,80 @@
+#define unitTest
+#include <unity.h>
+#include "loglevelrules.h"
+
+void test_logLevelRules_parseLevel() {
+    loggingLevel theLevel;
+    TEST_ASSERT_TRUE(logLevelRules::parseLevel("Debug", 5, theLevel));
+    TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(loggingLevel::Debug), static_cast<uint8_t>(theLevel));
+    TEST_ASSERT_TRUE(logLevelRules::parseLevel("wARNING", 7, theLevel));        // any case
+    TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(loggingLevel::Warning), static_cast<uint8_t>(theLevel));
+    TEST_ASSERT_TRUE(logLevelRules::parseLevel("0", 1, theLevel));        // by number
+    TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(loggingLevel::None), static_cast<uint8_t>(theLevel));
+    TEST_ASSERT_TRUE(logLevelRules::parseLevel("Infox", 4, theLevel));        // only textLength counts
+    TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(loggingLevel::Info), static_cast<uint8_t>(theLevel));
+    TEST_ASSERT_FALSE(logLevelRules::parseLevel("6", 1, theLevel));
+    TEST_ASSERT_FALSE(logLevelRules::parseLevel("Debu", 4, theLevel));
+    TEST_ASSERT_FALSE(logLevelRules::parseLevel("", 0, theLevel));
+}
+
+void test_logLevelRules_matchesPattern() {
+    TEST_ASSERT_TRUE(logLevelRules::matchesPattern("nfc", 3, "nfc"));
+    TEST_ASSERT_FALSE(logLevelRules::matchesPattern("nfc", 3, "nfcReader"));        // the whole name
+    TEST_ASSERT_TRUE(logLevelRules::matchesPattern("network*", 8, "networkCtrl"));
+    TEST_ASSERT_TRUE(logLevelRules::matchesPattern("network*", 8, "network"));
+    TEST_ASSERT_FALSE(logLevelRules::matchesPattern("network*", 8, "netData"));
+    TEST_ASSERT_TRUE(logLevelRules::matchesPattern("*", 1, "anything"));
+    TEST_ASSERT_TRUE(logLevelRules::matchesPattern("*Data", 5, "networkData"));
+    TEST_ASSERT_TRUE(logLevelRules::matchesPattern("n*t*a", 5, "networkData"));        // needs backtracking
+    TEST_ASSERT_TRUE(logLevelRules::matchesPattern("p?", 2, "pc"));
+    TEST_ASSERT_FALSE(logLevelRules::matchesPattern("p?", 2, "p"));
+    TEST_ASSERT_FALSE(logLevelRules::matchesPattern("", 0, "pc"));
+}
+
+void test_logLevelRules_parse() {
+    logLevelRules rules;
+    TEST_ASSERT_TRUE(rules.parse("  *=Warning, 1:network*=Debug;*:3=none\t12=5 ", 2));
+    TEST_ASSERT_EQUAL_UINT32(4, rules.size());
+    TEST_ASSERT_EQUAL_UINT8(0x03, rules[0].outputMask);        // no selector : all outputs
+    TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(loggingLevel::Warning), static_cast<uint8_t>(rules[0].theLevel));
+    TEST_ASSERT_EQUAL_UINT8(0x02, rules[1].outputMask);
+    TEST_ASSERT_EQUAL_UINT32(8, rules[1].patternLength);
+    TEST_ASSERT_TRUE(rules.matches(1, "networkData"));
+    TEST_ASSERT_EQUAL_UINT8(0x03, rules[2].outputMask);        // explicitly all outputs
+    TEST_ASSERT_TRUE(rules.matches(2, "3"));
+    TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(loggingLevel::None), static_cast<uint8_t>(rules[2].theLevel));
+    TEST_ASSERT_EQUAL_UINT8(0x03, rules[3].outputMask);        // digits without : are the pattern
+    TEST_ASSERT_TRUE(rules.matches(3, "12"));
+    TEST_ASSERT_FALSE(rules.matches(4, "12"));        // no such rule
+
+    TEST_ASSERT_TRUE(rules.parse("", 2));
+    TEST_ASSERT_EQUAL_UINT32(0, rules.size());
+}
+
+void test_logLevelRules_invalid() {
+    logLevelRules rules;
+    TEST_ASSERT_FALSE(rules.parse("*=Debug 2:nfc=Debug", 2));        // no output 2
+    TEST_ASSERT_EQUAL_UINT32(0, rules.size());                        // and not even the valid first rule
+    TEST_ASSERT_FALSE(rules.parse("nfc=Verbose", 2));
+    TEST_ASSERT_FALSE(rules.parse("nfc", 2));
+    TEST_ASSERT_FALSE(rules.parse("=Debug", 2));
+    TEST_ASSERT_FALSE(rules.parse("1:=Debug", 2));
+    TEST_ASSERT_FALSE(rules.parse("nfc=", 2));
+    TEST_ASSERT_FALSE(rules.parse("99999999999:nfc=Debug", 2));
+    TEST_ASSERT_TRUE(rules.parse("a=1 b=1 c=1 d=1 e=1 f=1 g=1 h=1 i=1 j=1 k=1 l=1 m=1 n=1 o=1 p=1", 2));
+    TEST_ASSERT_EQUAL_UINT32(logLevelRules::maxNmbrRules, rules.size());
+    TEST_ASSERT_FALSE(rules.parse("a=1 b=1 c=1 d=1 e=1 f=1 g=1 h=1 i=1 j=1 k=1 l=1 m=1 n=1 o=1 p=1 q=1", 2));        // too many
+    TEST_ASSERT_TRUE(rules.parse("7:nfc=Debug", 8));
+    TEST_ASSERT_EQUAL_UINT8(0x80, rules[0].outputMask);
+    TEST_ASSERT_TRUE(rules.parse("nfc=Debug", 8));
+    TEST_ASSERT_EQUAL_UINT8(0xFF, rules[0].outputMask);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_logLevelRules_parseLevel);
+    RUN_TEST(test_logLevelRules_matchesPattern);
+    RUN_TEST(test_logLevelRules_parse);
+    RUN_TEST(test_logLevelRules_invalid);
+    UNITY_END();
+}
@@ -0,0 +1,76 @@
+#define unitTest
+#include <string.h>
+#include <unity.h>
+#include "loglimiter.h"
+
+typedef logLimiter<4> testLimiter;
+
+void test_logLimiter_initialization() {
+    testLimiter aLimiter;
+    TEST_ASSERT_FALSE(aLimiter.isActive());        // nothing limited by default
+    TEST_ASSERT_FALSE(aLimiter.isSuppressingDuplicates());
+    for (uint32_t index = 0; index < 1000; index++) {
+        TEST_ASSERT_TRUE(aLimiter.isAllowed(0));
+    }
+    aLimiter.setRateLimit(1, 10, 5);
+    TEST_ASSERT_TRUE(aLimiter.isActive());
+    aLimiter.setRateLimit(1, 0, 5);
+    TEST_ASSERT_FALSE(aLimiter.isActive());
+}
+
+void test_logLimiter_burst() {
+    testLimiter aLimiter;
+    aLimiter.setRateLimit(1, 1, 3);        // 1 item per second, bursts of 3
+    TEST_ASSERT_TRUE(aLimiter.isAllowed(1));
+    TEST_ASSERT_TRUE(aLimiter.isAllowed(1));
+    TEST_ASSERT_TRUE(aLimiter.isAllowed(1));
+    TEST_ASSERT_FALSE(aLimiter.isAllowed(1));        // bucket is empty
+    TEST_ASSERT_FALSE(aLimiter.isAllowed(1));
+    TEST_ASSERT_TRUE(aLimiter.isAllowed(0));         // other subSystems are not affected
+    TEST_ASSERT_EQUAL_UINT32(2, aLimiter.takeRejected(1));
+    TEST_ASSERT_EQUAL_UINT32(0, aLimiter.takeRejected(1));        // only counted once
+}
+
+void test_logLimiter_refill() {
+    testLimiter aLimiter;
+    aLimiter.setRateLimit(2, 100, 1);        // one item every 10 ms
+    TEST_ASSERT_TRUE(aLimiter.isAllowed(2));
+    TEST_ASSERT_FALSE(aLimiter.isAllowed(2));
+    uint32_t start = logMicroseconds();
+    while ((logMicroseconds() - start) < 20000U) {
+    }
+    TEST_ASSERT_TRUE(aLimiter.isAllowed(2));
+    aLimiter.states[2].theoreticalArrival.store(logMicroseconds() + 0x80000000U);        // as after the clock wrapped around : the bucket is full, not empty
+    TEST_ASSERT_TRUE(aLimiter.isAllowed(2));
+}
+
+void test_logLimiter_duplicates() {
+    testLimiter aLimiter;
+    aLimiter.setSuppressDuplicates(true);
+    TEST_ASSERT_TRUE(aLimiter.isActive());
+    uint32_t repeated{99};
+    uint8_t repeatedLevel{99};
+    uint32_t hashA = testLimiter::hash(2166136261U, "A", 1);
+    uint32_t hashB = testLimiter::hash(2166136261U, "B", 1);
+    TEST_ASSERT_FALSE(aLimiter.isDuplicate(0, hashA, 3, repeated, repeatedLevel));
+    TEST_ASSERT_EQUAL_UINT32(0, repeated);
+    TEST_ASSERT_TRUE(aLimiter.isDuplicate(0, hashA, 3, repeated, repeatedLevel));
+    TEST_ASSERT_TRUE(aLimiter.isDuplicate(0, hashA, 3, repeated, repeatedLevel));
+    TEST_ASSERT_FALSE(aLimiter.isDuplicate(1, hashA, 3, repeated, repeatedLevel));        // per subSystem
+    TEST_ASSERT_FALSE(aLimiter.isDuplicate(0, hashB, 4, repeated, repeatedLevel));        // a different item tells how often the previous one was repeated
+    TEST_ASSERT_EQUAL_UINT32(2, repeated);
+    TEST_ASSERT_EQUAL_UINT8(3, repeatedLevel);
+    TEST_ASSERT_TRUE(aLimiter.isDuplicate(0, hashB, 4, repeated, repeatedLevel));
+    TEST_ASSERT_EQUAL_UINT32(1, aLimiter.takeRepeated(0, repeatedLevel));
+    TEST_ASSERT_EQUAL_UINT8(4, repeatedLevel);
+    TEST_ASSERT_EQUAL_UINT32(0, aLimiter.takeRepeated(0, repeatedLevel));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_logLimiter_initialization);
+    RUN_TEST(test_logLimiter_burst);
+    RUN_TEST(test_logLimiter_refill);
+    RUN_TEST(test_logLimiter_duplicates);
+    UNITY_END();
+}
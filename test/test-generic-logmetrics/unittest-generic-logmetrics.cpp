@@ -0,0 +1,93 @@
+#define unitTest
+#include <string.h>
+#include <unity.h>
+#include "logmetrics.h"
+#include "subsystems.h"
+
+typedef logMetrics<subSystem, 2, true> testMetrics;
+typedef testMetrics::snapshot testSnapshot;
+
+void test_logMetrics_counters() {
+    testMetrics theMetrics;
+    testSnapshot aSnapshot;
+    theMetrics.get(aSnapshot);
+    TEST_ASSERT_EQUAL_UINT32(0, aSnapshot.total(logCounter::logged));        // all zero after creation
+    TEST_ASSERT_EQUAL_UINT32(0, aSnapshot.highWaterMark);
+    theMetrics.count(subSystem::nfc, logCounter::logged);
+    theMetrics.count(subSystem::nfc, logCounter::logged);
+    theMetrics.count(subSystem::display, logCounter::logged);
+    theMetrics.count(subSystem::display, logCounter::dropped);
+    theMetrics.count(1, logOutputCounter::delivered, 5);
+    theMetrics.count(0, logOutputCounter::delivered);
+    theMetrics.get(aSnapshot);
+    TEST_ASSERT_EQUAL_UINT32(2, aSnapshot.get(subSystem::nfc, logCounter::logged));
+    TEST_ASSERT_EQUAL_UINT32(0, aSnapshot.get(subSystem::nfc, logCounter::dropped));
+    TEST_ASSERT_EQUAL_UINT32(3, aSnapshot.total(logCounter::logged));
+    TEST_ASSERT_EQUAL_UINT32(1, aSnapshot.total(logCounter::dropped));
+    TEST_ASSERT_EQUAL_UINT32(5, aSnapshot.get(1, logOutputCounter::delivered));
+    TEST_ASSERT_EQUAL_UINT32(6, aSnapshot.total(logOutputCounter::delivered));
+}
+
+void test_logMetrics_highWaterMark() {
+    testMetrics theMetrics;
+    testSnapshot aSnapshot;
+    theMetrics.updateHighWaterMark(100);
+    theMetrics.updateHighWaterMark(40);        // lower, so ignored
+    theMetrics.get(aSnapshot);
+    TEST_ASSERT_EQUAL_UINT32(100, aSnapshot.highWaterMark);
+    theMetrics.updateHighWaterMark(101);
+    theMetrics.get(aSnapshot);
+    TEST_ASSERT_EQUAL_UINT32(101, aSnapshot.highWaterMark);
+}
+
+void test_logMetrics_latency() {
+    TEST_ASSERT_EQUAL_UINT32(0, testSnapshot::latencyBucket(0));
+    TEST_ASSERT_EQUAL_UINT32(0, testSnapshot::latencyBucket(3));
+    TEST_ASSERT_EQUAL_UINT32(1, testSnapshot::latencyBucket(4));
+    TEST_ASSERT_EQUAL_UINT32(1, testSnapshot::latencyBucket(15));
+    TEST_ASSERT_EQUAL_UINT32(4, testSnapshot::latencyBucket(1000));
+    TEST_ASSERT_EQUAL_UINT32(testSnapshot::nmbrLatencyBuckets - 1U, testSnapshot::latencyBucket(UINT32_MAX));
+    for (uint32_t latency = 1; latency < 10000000U; latency = latency * 3U) {        // each latency is within the limit of its bucket, and beyond the one of the bucket before
+        uint32_t bucketIndex = testSnapshot::latencyBucket(latency);
+        TEST_ASSERT_TRUE(latency < testSnapshot::latencyLimit(bucketIndex));
+        TEST_ASSERT_TRUE((bucketIndex == 0) || (latency >= testSnapshot::latencyLimit(bucketIndex - 1U)));
+    }
+    TEST_ASSERT_EQUAL_UINT32(UINT32_MAX, testSnapshot::latencyLimit(testSnapshot::nmbrLatencyBuckets - 1U));
+
+    testMetrics theMetrics;
+    testSnapshot aSnapshot;
+    theMetrics.get(aSnapshot);
+    TEST_ASSERT_EQUAL_UINT32(0, aSnapshot.latencyPercentile(0, 99));        // nothing delivered yet
+    for (uint32_t index = 0; index < 98; index++) {
+        theMetrics.countLatency(0, 10);
+    }
+    theMetrics.countLatency(0, 100);
+    theMetrics.countLatency(0, 5000);
+    theMetrics.get(aSnapshot);
+    TEST_ASSERT_EQUAL_UINT32(16, aSnapshot.latencyPercentile(0, 50));
+    TEST_ASSERT_EQUAL_UINT32(16, aSnapshot.latencyPercentile(0, 98));
+    TEST_ASSERT_EQUAL_UINT32(256, aSnapshot.latencyPercentile(0, 99));
+    TEST_ASSERT_EQUAL_UINT32(16384, aSnapshot.latencyPercentile(0, 100));
+    TEST_ASSERT_EQUAL_UINT32(0, aSnapshot.latencyPercentile(1, 100));        // per output
+}
+
+void test_logMetrics_disabled() {
+    logMetrics<subSystem, 2, false> theMetrics;
+    testSnapshot aSnapshot;
+    memset(static_cast<void*>(&aSnapshot), 0xFF, sizeof(aSnapshot));
+    theMetrics.count(subSystem::nfc, logCounter::logged);
+    theMetrics.updateHighWaterMark(100);
+    theMetrics.get(aSnapshot);
+    TEST_ASSERT_EQUAL_UINT32(0, aSnapshot.total(logCounter::logged));
+    TEST_ASSERT_EQUAL_UINT32(0, aSnapshot.highWaterMark);
+    TEST_ASSERT_TRUE(sizeof(theMetrics) < sizeof(testMetrics));        // takes no memory
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_logMetrics_counters);
+    RUN_TEST(test_logMetrics_highWaterMark);
+    RUN_TEST(test_logMetrics_latency);
+    RUN_TEST(test_logMetrics_disabled);
+    UNITY_END();
+}
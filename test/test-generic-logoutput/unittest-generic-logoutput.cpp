@@ -15,6 +15,17 @@ bool outputFunction1(const char* contents) {
     return true;
 }
 
+uint32_t batchFunction(const logSpan* spans, uint32_t nmbrSpans) {
+    return (nmbrSpans > 2U) ? 2U : nmbrSpans;        // accepts no more than 2 items per call
+}
+
+uint32_t nmbrSingleCalls{0};
+
+bool singleFunction(const char* contents) {
+    nmbrSingleCalls++;
+    return (strcmp(contents, "busy") != 0);
+}
+
 bool loggingTime(char* contents, uint32_t length) {
     strcpy(contents, "2022-01-29T19:46:51Z");
     return true;
@@ -61,10 +72,40 @@ void test_logOutput_write() {
     TEST_ASSERT_TRUE(result);                              // check it was succesfully written
 }
 
+void test_logOutput_write_batch() {
+    logOutput anOutput;
+    logSpan spans[3] = {{"one", 3, loggingLevel::Info, subSystem::general}, {"busy", 4, loggingLevel::Info, subSystem::general}, {"three", 5, loggingLevel::Info, subSystem::general}};
+    TEST_ASSERT_EQUAL_UINT32(0, anOutput.write(spans, 3));        // no output function : nothing accepted
+    anOutput.setBatchOutputDestination(batchFunction);
+    TEST_ASSERT_TRUE(anOutput.isActive());
+    TEST_ASSERT_EQUAL_UINT32(2, anOutput.write(spans, 3));        // partially accepted
+    TEST_ASSERT_EQUAL_UINT32(1, anOutput.write(spans, 1));
+    anOutput.setOutputDestination(singleFunction);        // a single item function replaces the batch function
+    nmbrSingleCalls = 0;
+    TEST_ASSERT_EQUAL_UINT32(1, anOutput.write(spans, 3));        // one call per item, stopping at the first one not accepted
+    TEST_ASSERT_EQUAL_UINT32(2, nmbrSingleCalls);
+    anOutput.setBatchOutputDestination(nullptr);
+    TEST_ASSERT_FALSE(anOutput.isActive());
+}
+
+void test_logOutput_binary() {
+    logOutput anOutput;
+    anOutput.setBinaryOutput(true);
+    TEST_ASSERT_FALSE(anOutput.isBinaryOutput());        // no output function
+    anOutput.setOutputDestination(singleFunction);
+    TEST_ASSERT_FALSE(anOutput.isBinaryOutput());        // a single item function can't handle zeroes
+    anOutput.setBatchOutputDestination(batchFunction);
+    TEST_ASSERT_TRUE(anOutput.isBinaryOutput());
+    anOutput.setBinaryOutput(false);
+    TEST_ASSERT_FALSE(anOutput.isBinaryOutput());
+}
+
 int main(int argc, char** argv) {
     UNITY_BEGIN();
     RUN_TEST(test_logOutput_initialization);
     RUN_TEST(test_logOutput_settings);
     RUN_TEST(test_logOutput_write);
+    RUN_TEST(test_logOutput_write_batch);
+    RUN_TEST(test_logOutput_binary);
     UNITY_END();
 }
\ No newline at end of file
@@ -0,0 +1,70 @@
+#define unitTest
+#include <string.h>
+#include <stdio.h>
+#include <unity.h>
+#include "logging.h"
+
+typedef logRegistry<8> testRegistry;
+
+void test_logRegistry_add() {
+    testRegistry aRegistry;
+    TEST_ASSERT_EQUAL_UINT32(1, aRegistry.size());        // only other
+    testRegistry::handle radio = aRegistry.add("radio");
+    testRegistry::handle nfc   = aRegistry.add("nfc");
+    TEST_ASSERT_EQUAL_UINT8(1, static_cast<uint8_t>(radio));
+    TEST_ASSERT_EQUAL_UINT8(2, static_cast<uint8_t>(nfc));
+    char sameName[8];
+    strcpy(sameName, "radio");
+    TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(radio), static_cast<uint8_t>(aRegistry.add(sameName)));        // registered once, by contents
+    TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(nfc), static_cast<uint8_t>(aRegistry.find("nfc")));
+    TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(testRegistry::handle::other), static_cast<uint8_t>(aRegistry.find("display")));
+    TEST_ASSERT_EQUAL_STRING("radio", aRegistry.name(radio));
+    TEST_ASSERT_EQUAL_STRING("other", aRegistry.name(testRegistry::handle::other));
+    TEST_ASSERT_EQUAL_STRING("other", aRegistry.name(static_cast<testRegistry::handle>(5)));        // not registered
+    TEST_ASSERT_EQUAL_UINT32(3, aRegistry.size());
+}
+
+void test_logRegistry_full() {
+    logRegistry<3> aRegistry;
+    TEST_ASSERT_EQUAL_UINT8(1, static_cast<uint8_t>(aRegistry.add("a")));
+    TEST_ASSERT_EQUAL_UINT8(2, static_cast<uint8_t>(aRegistry.add("b")));
+    TEST_ASSERT_EQUAL_UINT8(0, static_cast<uint8_t>(aRegistry.add("c")));        // no room : shares other
+    TEST_ASSERT_EQUAL_UINT8(0, static_cast<uint8_t>(aRegistry.add("d")));
+    TEST_ASSERT_EQUAL_UINT8(2, static_cast<uint8_t>(aRegistry.add("b")));        // existing names still work
+    TEST_ASSERT_EQUAL_UINT32(2, aRegistry.getOverflowed());
+    TEST_ASSERT_EQUAL_UINT32(3, aRegistry.size());
+}
+
+testRegistry theSubSystems;        // global, as an application would have it
+const testRegistry::handle radio = theSubSystems.add("radio");        // registered during static initialization
+const testRegistry::handle power = theSubSystems.add("power");
+
+char registryReceived[256];
+
+bool outputFunctionRegistry(const char* contents) {
+    strcat(registryReceived, contents);
+    return true;
+}
+
+void test_logRegistry_logging() {
+    static basicLog<registryLogConfig<8>> aLog;
+    aLog.setOutput(0, outputFunctionRegistry);
+    aLog.setLoggingLevel(0, loggingLevel::Warning);
+    aLog.setLoggingLevel(0, theSubSystems.find("radio"), loggingLevel::Debug);        // configured by name
+    aLog.setEncoding(0, logEncoding::logfmt);
+    aLog.setSubSystemNames([](testRegistry::handle aHandle) { return theSubSystems.name(aHandle); });
+    registryReceived[0] = 0;
+    aLog.log(radio, loggingLevel::Debug, "joined");
+    aLog.log(power, loggingLevel::Info, "filtered");
+    aLog.log(power, loggingLevel::Error, "brownout");
+    aLog.flush();
+    TEST_ASSERT_EQUAL_STRING("level=Debug subsystem=radio msg=joined\nlevel=Error subsystem=power msg=brownout\n", registryReceived);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_logRegistry_add);
+    RUN_TEST(test_logRegistry_full);
+    RUN_TEST(test_logRegistry_logging);
+    UNITY_END();
+}
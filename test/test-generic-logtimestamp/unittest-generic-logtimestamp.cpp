@@ -0,0 +1,50 @@
+#define unitTest
+#include <string.h>
+#include <unity.h>
+#include "logtimestamp.h"
+
+char result[logTimestamp::maxLength + 1U];
+
+const char* format(logTimestamp& aTimestamp, uint64_t tick) {
+    uint32_t length = aTimestamp.format(tick, result);
+    result[length]  = 0;
+    return result;
+}
+
+void test_logTimestamp_format() {
+    logTimestamp aTimestamp;
+    TEST_ASSERT_EQUAL_UINT32(1000, aTimestamp.getTicksPerSecond());        // default is milliseconds
+    TEST_ASSERT_EQUAL_STRING("1970-01-01T00:00:00.000Z", format(aTimestamp, 0));
+    TEST_ASSERT_EQUAL_STRING("2022-01-29T19:46:51.123Z", format(aTimestamp, 1643485611123ULL));
+    TEST_ASSERT_EQUAL_UINT32(logTimestamp::maxLength, strlen(result));
+    TEST_ASSERT_EQUAL_STRING("2024-02-29T23:59:59.999Z", format(aTimestamp, 1709251199999ULL));        // leap day
+    TEST_ASSERT_EQUAL_STRING("2100-03-01T00:00:00.000Z", format(aTimestamp, 4107542400000ULL));        // 2100 is not a leap year
+}
+
+void test_logTimestamp_cache() {
+    logTimestamp aTimestamp;
+    TEST_ASSERT_EQUAL_STRING("2022-01-29T19:46:51.123Z", format(aTimestamp, 1643485611123ULL));
+    TEST_ASSERT_EQUAL_UINT64(1643485611ULL, aTimestamp.cachedSecond);
+    TEST_ASSERT_EQUAL_STRING("2022-01-29T19:46:51.999Z", format(aTimestamp, 1643485611999ULL));        // same second : only the fraction changes
+    TEST_ASSERT_EQUAL_STRING("2022-01-29T23:59:59.000Z", format(aTimestamp, 1643500799000ULL));        // same day : only the time changes
+    TEST_ASSERT_EQUAL_STRING("2022-01-30T00:00:00.001Z", format(aTimestamp, 1643500800001ULL));        // next day
+    TEST_ASSERT_EQUAL_STRING("2022-01-29T19:46:51.123Z", format(aTimestamp, 1643485611123ULL));        // and back
+}
+
+void test_logTimestamp_resolution() {
+    logTimestamp aTimestamp;
+    aTimestamp.setTicksPerSecond(1);        // seconds : no fraction
+    TEST_ASSERT_EQUAL_STRING("2022-01-29T19:46:51Z", format(aTimestamp, 1643485611ULL));
+    aTimestamp.setTicksPerSecond(1000000);        // microseconds : rounded down to milliseconds
+    TEST_ASSERT_EQUAL_STRING("2022-01-29T19:46:51.123Z", format(aTimestamp, 1643485611123999ULL));
+    aTimestamp.setTicksPerSecond(0);        // invalid, taken as 1
+    TEST_ASSERT_EQUAL_UINT32(1, aTimestamp.getTicksPerSecond());
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_logTimestamp_format);
+    RUN_TEST(test_logTimestamp_cache);
+    RUN_TEST(test_logTimestamp_resolution);
+    UNITY_END();
+}
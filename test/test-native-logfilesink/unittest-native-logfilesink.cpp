@@ -0,0 +1,204 @@
+#define unitTest
+#include <string.h>
+#include <stdio.h>
+#include <unity.h>
+#include "logging.h"
+
+static constexpr const char* testPath = "/tmp/ulog-filesink-test.log";
+
+uint32_t readFile(const char* path, char* contents, uint32_t maxLength) {        // returns the length of the file, contents is zero terminated
+    FILE* aFile = fopen(path, "rb");
+    if (aFile == nullptr) {
+        contents[0] = 0;
+        return 0;
+    }
+    uint32_t length  = fread(contents, 1, maxLength - 1U, aFile);
+    contents[length] = 0;
+    fclose(aFile);
+    return length;
+}
+
+void removeFiles() {
+    char rotated[64];
+    remove(testPath);
+    for (uint32_t index = 1; index <= 4; index++) {
+        snprintf(rotated, sizeof(rotated), "%s.%u", testPath, static_cast<unsigned>(index));
+        remove(rotated);
+    }
+}
+
+char contents[1024];
+
+void test_logFileSink_buffered() {
+    removeFiles();
+    logFileSink aSink;
+    TEST_ASSERT_FALSE(aSink.write("not open\n"));
+    TEST_ASSERT_TRUE(aSink.open(testPath));
+    TEST_ASSERT_TRUE(aSink.isOpen());
+    aSink.setFlushInterval(60000U);
+    TEST_ASSERT_TRUE(aSink.write("first\n"));
+    TEST_ASSERT_TRUE(aSink.write("second\n", 7, loggingLevel::Info));
+    TEST_ASSERT_EQUAL_UINT32(0, readFile(testPath, contents, sizeof(contents)));        // still in the buffer
+    TEST_ASSERT_EQUAL_UINT32(0, aSink.nmbrWrites);
+    TEST_ASSERT_EQUAL_UINT64(13U, aSink.getFileSize());
+    TEST_ASSERT_TRUE(aSink.flush());
+    TEST_ASSERT_EQUAL_UINT32(1, aSink.nmbrWrites);
+    readFile(testPath, contents, sizeof(contents));
+    TEST_ASSERT_EQUAL_STRING("first\nsecond\n", contents);
+    aSink.close();
+    TEST_ASSERT_FALSE(aSink.isOpen());
+
+    TEST_ASSERT_TRUE(aSink.open(testPath));        // appends to what is there
+    TEST_ASSERT_EQUAL_UINT64(13U, aSink.getFileSize());
+    aSink.write("third\n");
+    aSink.close();
+    readFile(testPath, contents, sizeof(contents));
+    TEST_ASSERT_EQUAL_STRING("first\nsecond\nthird\n", contents);
+    removeFiles();
+}
+
+void test_logFileSink_large_writes() {
+    removeFiles();
+    logFileSink aSink;
+    TEST_ASSERT_TRUE(aSink.open(testPath));
+    aSink.setFlushInterval(60000U);
+    static constexpr uint32_t nmbrLines = 10000;
+    static constexpr const char* line   = "2022-01-29T19:46:51.123Z I temperature 21.5 C\n";
+    for (uint32_t index = 0; index < nmbrLines; index++) {
+        TEST_ASSERT_TRUE(aSink.write(line, strlen(line), loggingLevel::Info));
+    }
+    aSink.flush();
+    TEST_ASSERT_EQUAL_UINT32(((nmbrLines * strlen(line)) / logFileSink::bufferSize) + 1U, aSink.nmbrWrites);        // one writev() per full buffer, and the last one
+    aSink.close();
+    FILE* aFile = fopen(testPath, "rb");
+    fseek(aFile, 0, SEEK_END);
+    TEST_ASSERT_EQUAL_UINT32(nmbrLines * strlen(line), static_cast<uint32_t>(ftell(aFile)));
+    fclose(aFile);
+    removeFiles();
+
+    static char largeItem[(logFileSink::bufferSize * 2U) + 100U];        // larger than the buffer : written directly, and never cut
+    memset(largeItem, 'x', sizeof(largeItem));
+    TEST_ASSERT_TRUE(aSink.open(testPath));
+    TEST_ASSERT_TRUE(aSink.write("first\n", 6, loggingLevel::Info));
+    TEST_ASSERT_TRUE(aSink.write(largeItem, sizeof(largeItem), loggingLevel::Info));
+    aSink.close();
+    aFile = fopen(testPath, "rb");
+    fseek(aFile, 0, SEEK_END);
+    TEST_ASSERT_EQUAL_UINT32(6U + sizeof(largeItem), static_cast<uint32_t>(ftell(aFile)));
+    fclose(aFile);
+    removeFiles();
+}
+
+void test_logFileSink_rotation() {
+    removeFiles();
+    logFileSink aSink;
+    TEST_ASSERT_TRUE(aSink.open(testPath, 100, 2));
+    for (uint32_t index = 0; index < 10; index++) {        // 30 bytes each, so 3 per file
+        char line[32];
+        snprintf(line, sizeof(line), "line %02u .....................\n", static_cast<unsigned>(index));
+        TEST_ASSERT_EQUAL_UINT32(30, strlen(line));
+        TEST_ASSERT_TRUE(aSink.write(line, 30, loggingLevel::Info));
+    }
+    aSink.close();
+    TEST_ASSERT_EQUAL_UINT32(3, aSink.nmbrRotations);
+    TEST_ASSERT_EQUAL_UINT32(30, readFile(testPath, contents, sizeof(contents)));
+    TEST_ASSERT_EQUAL_STRING_LEN("line 09", contents, 7);
+    char rotated[64];
+    snprintf(rotated, sizeof(rotated), "%s.1", testPath);
+    TEST_ASSERT_EQUAL_UINT32(90, readFile(rotated, contents, sizeof(contents)));        // items are never split over two files
+    TEST_ASSERT_EQUAL_STRING_LEN("line 06", contents, 7);
+    snprintf(rotated, sizeof(rotated), "%s.2", testPath);
+    TEST_ASSERT_EQUAL_UINT32(90, readFile(rotated, contents, sizeof(contents)));
+    TEST_ASSERT_EQUAL_STRING_LEN("line 03", contents, 7);
+    snprintf(rotated, sizeof(rotated), "%s.3", testPath);
+    TEST_ASSERT_EQUAL_UINT32(0, readFile(rotated, contents, sizeof(contents)));        // only 2 old files are kept
+
+    TEST_ASSERT_TRUE(aSink.open(testPath));
+    aSink.setRotation(0, 2, 0);        // by number of items, keeping no old files
+    aSink.write("a\n");
+    aSink.write("b\n");
+    aSink.write("c\n");
+    aSink.close();
+    readFile(testPath, contents, sizeof(contents));
+    TEST_ASSERT_EQUAL_STRING("c\n", contents);
+    removeFiles();
+}
+
+void test_logFileSink_sync() {
+    removeFiles();
+    logFileSink aSink;
+    TEST_ASSERT_TRUE(aSink.open(testPath));
+    aSink.setFlushInterval(60000U);
+    aSink.setSync(loggingLevel::Critical, 60000U);
+    aSink.write("info\n", 5, loggingLevel::Info);
+    TEST_ASSERT_EQUAL_UINT32(0, aSink.nmbrSyncs);
+    aSink.write("critical\n", 9, loggingLevel::Critical);        // synced right away, with the items before it
+    TEST_ASSERT_EQUAL_UINT32(1, aSink.nmbrSyncs);
+    TEST_ASSERT_FALSE(aSink.unsynced);
+    readFile(testPath, contents, sizeof(contents));
+    TEST_ASSERT_EQUAL_STRING("info\ncritical\n", contents);
+
+    aSink.setFlushInterval(0);
+    aSink.setSync(loggingLevel::None, 0);
+    aSink.write("line\n");        // flushed at the end of the call, never synced
+    TEST_ASSERT_EQUAL_UINT32(1, aSink.nmbrSyncs);
+    TEST_ASSERT_EQUAL_UINT32(19, readFile(testPath, contents, sizeof(contents)));
+    aSink.setSync(loggingLevel::None, 1);
+    uint32_t start = logMicroseconds();
+    while ((logMicroseconds() - start) < 2000U) {
+    }
+    aSink.poll();        // the sync interval has elapsed
+    TEST_ASSERT_EQUAL_UINT32(2, aSink.nmbrSyncs);
+    aSink.poll();        // nothing new to sync
+    TEST_ASSERT_EQUAL_UINT32(2, aSink.nmbrSyncs);
+    aSink.close();
+    removeFiles();
+}
+
+logFileSink theSink;
+
+uint32_t toFile(const logSpan* spans, uint32_t nmbrSpans) {
+    return theSink.write(spans, nmbrSpans);
+}
+
+void test_logFileSink_output() {
+    removeFiles();
+    uLog aLog;
+    TEST_ASSERT_TRUE(theSink.open(testPath));
+    theSink.setFlushInterval(60000U);
+    aLog.setBatchOutput(0, toFile);
+    aLog.setLoggingLevel(0, loggingLevel::Info);
+    aLog.setEncoding(0, logEncoding::logfmt);
+    aLog.log(subSystem::general, loggingLevel::Info, "booted");
+    aLog.log(subSystem::general, loggingLevel::Debug, "filtered");
+    aLog.flush();
+    TEST_ASSERT_EQUAL_UINT32(0, readFile(testPath, contents, sizeof(contents)));        // the sink keeps it in its buffer
+    aLog.log(subSystem::general, loggingLevel::Critical, "brownout");
+    aLog.flush();
+    readFile(testPath, contents, sizeof(contents));
+    TEST_ASSERT_EQUAL_STRING("level=Info subsystem=0 msg=booted\nlevel=Critical subsystem=0 msg=brownout\n", contents);
+    theSink.close();
+    removeFiles();
+}
+
+void test_logFileSink_path() {
+    logFileSink aSink;
+    char longPath[logFileSink::maxPathLength];
+    memset(longPath, 'a', sizeof(longPath) - 1U);
+    longPath[sizeof(longPath) - 1U] = 0;
+    TEST_ASSERT_FALSE(aSink.open(longPath));        // no room for the suffix of the rotated files
+    TEST_ASSERT_FALSE(aSink.open("/nonexistent-directory/app.log"));
+    TEST_ASSERT_FALSE(aSink.isOpen());
+    TEST_ASSERT_FALSE(aSink.flush());
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_logFileSink_buffered);
+    RUN_TEST(test_logFileSink_large_writes);
+    RUN_TEST(test_logFileSink_rotation);
+    RUN_TEST(test_logFileSink_sync);
+    RUN_TEST(test_logFileSink_output);
+    RUN_TEST(test_logFileSink_path);
+    UNITY_END();
+}
@@ -0,0 +1,247 @@
+#define unitTest
+#include <string.h>
+#include <stdio.h>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <unity.h>
+#include "logging.h"
+
+// tests of uLog needing threads, so they only run on native, see test-generic-logging for the others
+
+bool outputFunctionTestLength(const char* contents) {
+    uint32_t contentsLength = strlen(contents);
+    TEST_ASSERT_LESS_OR_EQUAL(logItem::maxItemLength, contentsLength);
+    return true;
+}
+
+static constexpr uint32_t nmbrProducers    = 4;
+static constexpr uint32_t itemsPerProducer = 5000;
+uint32_t stressReceived{0};
+uint32_t stressNextIndex[nmbrProducers]{0};
+bool stressCorrupted{false};
+
+bool outputFunctionStress(const char* contents) {
+    unsigned int producer{0};
+    unsigned int index{0};
+    char expected[logItem::maxItemLength];
+    if ((sscanf(contents, "I p%u i%u", &producer, &index) != 2) || (producer >= nmbrProducers)) {
+        stressCorrupted = true;
+        return true;
+    }
+    snprintf(expected, logItem::maxItemLength, "I p%u i%u c%u\n", producer, index, producer * 100003U + index);
+    if (strcmp(expected, contents) != 0) {        // torn item, mixing contents of different producers
+        stressCorrupted = true;
+    }
+    if (index < stressNextIndex[producer]) {        // items of one producer must arrive in order, and only once
+        stressCorrupted = true;
+    }
+    stressNextIndex[producer] = index + 1;
+    stressReceived++;
+    return true;
+}
+
+void test_uLog_level_rules_concurrent() {
+    static uLog aLog;
+    aLog.setOutput(0, outputFunctionTestLength);
+    std::atomic<bool> done{false};
+    std::atomic<bool> sawIntermediate{false};
+    std::thread producers[2];
+    for (uint32_t producer = 0; producer < 2; producer++) {
+        producers[producer] = std::thread([&done, &sawIntermediate]() {
+            while (!done) {
+                if (aLog.checkLoggingLevel(subSystem::networkData, loggingLevel::Debug)) {        // neither set of rules wants these
+                    sawIntermediate = true;
+                }
+            }
+        });
+    }
+    std::thread configurer([&done]() {        // another configurer, eg. a serial command, changing an output which is not active
+        while (!done) {
+            aLog.setLoggingLevel(1, subSystem::general, loggingLevel::Debug);
+            aLog.setLoggingLevels("1:*=Info");
+        }
+    });
+    for (uint32_t index = 0; index < 2000U; index++) {        // the first rule of the second set alone would enable networkData
+        TEST_ASSERT_TRUE(aLog.setLoggingLevels((index % 2) ? "0:*=None" : "0:*=Debug 0:12=None"));
+    }
+    done = true;
+    for (uint32_t producer = 0; producer < 2; producer++) {
+        producers[producer].join();
+    }
+    configurer.join();
+    TEST_ASSERT_FALSE(sawIntermediate);
+    TEST_ASSERT_FALSE(aLog.checkLoggingLevel(subSystem::general, loggingLevel::Debug));        // the last rules were *=None
+}
+
+std::atomic<uint32_t> nmbrOutputCalls{0};
+std::thread::id outputThread;
+
+bool outputFunctionWriter(const char* contents) {
+    outputThread = std::this_thread::get_id();
+    nmbrOutputCalls++;
+    return true;
+}
+
+void test_uLog_writer() {
+    uLog aLog;
+    aLog.setOutput(0, outputFunctionWriter);
+    aLog.setLoggingLevel(0, loggingLevel::Info);
+    nmbrOutputCalls = 0;
+    outputThread    = std::this_thread::get_id();
+
+    TEST_ASSERT_TRUE(aLog.startWriter());
+    TEST_ASSERT_FALSE(aLog.startWriter());        // already running
+    aLog.output(subSystem::general, loggingLevel::Info, "output by the writer");
+    for (uint32_t i = 0; (i < 1000) && (nmbrOutputCalls == 0); i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    TEST_ASSERT_EQUAL_UINT32(1, nmbrOutputCalls);
+    TEST_ASSERT_TRUE(outputThread != std::this_thread::get_id());        // output was done on the writer thread
+
+    aLog.log(subSystem::general, loggingLevel::Info, "output when stopping the writer");
+    aLog.stopWriter();
+    TEST_ASSERT_EQUAL_UINT32(2, nmbrOutputCalls);
+    TEST_ASSERT_EQUAL_UINT32(0, aLog.items.level());
+}
+
+template <typename logType>
+void concurrentProducers() {
+    logType aLog;
+    stressReceived  = 0;
+    stressCorrupted = false;
+    for (uint32_t producer = 0; producer < nmbrProducers; producer++) {
+        stressNextIndex[producer] = 0;
+    }
+    aLog.setOutput(0, outputFunctionStress);
+    aLog.setLoggingLevel(0, loggingLevel::Info);
+
+    std::atomic<uint32_t> producersDone{0};
+    std::thread producers[nmbrProducers];
+    for (uint32_t producer = 0; producer < nmbrProducers; producer++) {
+        producers[producer] = std::thread([&aLog, &producersDone, producer]() {
+            char text[logItem::maxItemLength];
+            for (uint32_t index = 0; index < itemsPerProducer; index++) {
+                if (index % 2) {
+                    aLog.snprintf(subSystem::general, loggingLevel::Info, "p%u i%u c%u", producer, index, producer * 100003U + index);        // stores and outputs
+                } else {
+                    ::snprintf(text, logItem::maxItemLength, "p%u i%u c%u", producer, index, producer * 100003U + index);
+                    aLog.log(subSystem::general, loggingLevel::Info, text);        // only stores
+                }
+            }
+            producersDone++;
+        });
+    }
+    while (producersDone < nmbrProducers) {        // main thread competes with the producers for outputting
+        aLog.flush();
+    }
+    for (uint32_t producer = 0; producer < nmbrProducers; producer++) {
+        producers[producer].join();
+    }
+    aLog.flush();
+
+    TEST_ASSERT_FALSE(stressCorrupted);
+    TEST_ASSERT_GREATER_THAN(0U, stressReceived);
+    TEST_ASSERT_EQUAL_UINT32(nmbrProducers * itemsPerProducer, stressReceived + aLog.droppedItems);        // every item is either output or counted as dropped
+    TEST_ASSERT_EQUAL_UINT32(0, aLog.items.level());
+}
+
+void test_uLog_concurrent_producers() {
+    concurrentProducers<uLog>();
+}
+
+struct stagedLogConfig : logConfig {
+    static constexpr uint32_t nmbrStagingBuffers = 4;
+};
+
+typedef basicLog<stagedLogConfig> stagedLog;
+
+uint64_t stagedTick{0};
+
+uint64_t stagedTickSource() {
+    return stagedTick;
+}
+
+char stagedReceived[2048];
+
+bool outputFunctionStaged(const char* contents) {
+    strcat(stagedReceived, contents);
+    return true;
+}
+
+void test_uLog_staging() {
+    stagedLog aLog;
+    aLog.setTickSource(stagedTickSource);
+    aLog.setOutput(0, outputFunctionStaged);
+    aLog.setLoggingLevel(0, loggingLevel::Info);
+    stagedReceived[0] = 0;
+    stagedTick        = 3;
+    std::thread([&aLog]() { aLog.log(subSystem::general, loggingLevel::Info, "3"); }).join();
+    std::thread([&aLog]() {
+        stagedTick = 1;
+        aLog.log(subSystem::general, loggingLevel::Info, "1");
+        stagedTick = 2;
+        aLog.log(subSystem::general, loggingLevel::Info, "2");
+    }).join();
+    TEST_ASSERT_EQUAL_UINT32(0, aLog.items.level());        // the two threads logged in their own staging buffer
+    aLog.flush();
+    TEST_ASSERT_EQUAL_STRING("I 1\nI 2\nI 3\n", stagedReceived);        // merged oldest tick first
+    TEST_ASSERT_EQUAL_UINT32(0, aLog.items.level());
+}
+
+void test_uLog_staging_concurrent_producers() {
+    concurrentProducers<stagedLog>();
+}
+
+struct recorderLogConfig : logConfig {
+    static constexpr uint32_t bufferSize   = 2048;
+    static constexpr uint32_t recorderSize = 512;
+};
+
+std::atomic<uint32_t> recorderLines{0};
+std::atomic<bool> recorderCorrupted{false};
+
+bool outputFunctionRecorderStress(const char* contents) {
+    if (((contents[0] != 'D') && (contents[0] != 'E')) || (strncmp(contents + 1, " p", 2) != 0)) {
+        recorderCorrupted = true;
+    }
+    recorderLines++;
+    return true;
+}
+
+void test_uLog_flight_recorder_concurrent() {
+    static basicLog<recorderLogConfig> aLog;
+    aLog.setOutput(0, outputFunctionRecorderStress);
+    aLog.setLoggingLevel(0, loggingLevel::Error);
+    aLog.setFlightRecorder(loggingLevel::Debug, loggingLevel::Error, 8);
+    std::atomic<uint32_t> producersDone{0};
+    std::thread producers[2];
+    for (uint32_t producer = 0; producer < 2; producer++) {
+        producers[producer] = std::thread([&producersDone, producer]() {
+            for (uint32_t index = 0; index < 2000U; index++) {
+                aLog.snprintf(subSystem::general, ((index % 50U) == 49U) ? loggingLevel::Error : loggingLevel::Debug, "p%u i%u", producer, index);        // recording, dumping and outputting all at once
+            }
+            producersDone++;
+        });
+    }
+    while (producersDone < 2) {
+        aLog.flush();
+    }
+    for (uint32_t producer = 0; producer < 2; producer++) {
+        producers[producer].join();
+    }
+    aLog.flush();
+    TEST_ASSERT_FALSE(recorderCorrupted);
+    TEST_ASSERT_GREATER_THAN(0U, recorderLines.load());
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_uLog_level_rules_concurrent);
+    RUN_TEST(test_uLog_writer);
+    RUN_TEST(test_uLog_concurrent_producers);
+    RUN_TEST(test_uLog_staging);
+    RUN_TEST(test_uLog_staging_concurrent_producers);
+    RUN_TEST(test_uLog_flight_recorder_concurrent);
+    UNITY_END();
+}
@@ -0,0 +1,46 @@
+#define unitTest
+#include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <unity.h>
+#include "logging.h"
+
+char persistentReceived[512];
+
+bool outputFunctionPersistent(const char* contents) {
+    strcat(persistentReceived, contents);
+    return true;
+}
+
+void test_uLog_mapped_file() {
+    char path[] = "/tmp/unittest-ulog-XXXXXX";
+    int file    = mkstemp(path);
+    TEST_ASSERT_TRUE(file >= 0);
+    close(file);
+    persistentReceived[0] = 0;
+    {
+        logMappedFile theFile;
+        TEST_ASSERT_TRUE(theFile.open(path, uLog::attachedBufferSize));
+        uLog aLog;
+        aLog.setOutput(0, outputFunctionPersistent);
+        aLog.setLoggingLevel(0, loggingLevel::Info);
+        TEST_ASSERT_FALSE(aLog.attachBuffer(theFile.address(), theFile.length()));
+        aLog.log(subSystem::general, loggingLevel::Info, "crashed");
+    }        // the process crashes
+    logMappedFile theFile;
+    TEST_ASSERT_TRUE(theFile.open(path, uLog::attachedBufferSize));
+    uLog aLog;
+    aLog.setOutput(0, outputFunctionPersistent);
+    aLog.setLoggingLevel(0, loggingLevel::Info);
+    TEST_ASSERT_TRUE(aLog.attachBuffer(theFile.address(), theFile.length()));
+    aLog.flush();
+    TEST_ASSERT_EQUAL_STRING("I crashed\n", persistentReceived);
+    TEST_ASSERT_TRUE(theFile.sync());
+    unlink(path);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_uLog_mapped_file);
+    UNITY_END();
+}
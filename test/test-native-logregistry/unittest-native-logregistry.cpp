@@ -0,0 +1,37 @@
+#define unitTest
+#include <thread>
+#include <unity.h>
+#include "logging.h"
+
+typedef logRegistry<8> testRegistry;
+
+void test_logRegistry_concurrent() {
+    static testRegistry aRegistry;
+    static const char* names[] = {"a", "b", "c", "d", "e", "f", "g"};
+    static uint8_t handles[4][7];
+    std::thread threads[4];
+    for (uint32_t threadIndex = 0; threadIndex < 4; threadIndex++) {
+        threads[threadIndex] = std::thread([threadIndex]() {
+            for (uint32_t nameIndex = 0; nameIndex < 7; nameIndex++) {
+                handles[threadIndex][(nameIndex + threadIndex) % 7] = static_cast<uint8_t>(aRegistry.add(names[(nameIndex + threadIndex) % 7]));        // each thread in another order
+            }
+        });
+    }
+    for (uint32_t threadIndex = 0; threadIndex < 4; threadIndex++) {
+        threads[threadIndex].join();
+    }
+    TEST_ASSERT_EQUAL_UINT32(8, aRegistry.size());        // every name once
+    for (uint32_t nameIndex = 0; nameIndex < 7; nameIndex++) {
+        TEST_ASSERT_NOT_EQUAL(0, handles[0][nameIndex]);
+        for (uint32_t threadIndex = 1; threadIndex < 4; threadIndex++) {
+            TEST_ASSERT_EQUAL_UINT8(handles[0][nameIndex], handles[threadIndex][nameIndex]);        // all threads got the same handle
+        }
+        TEST_ASSERT_EQUAL_STRING(names[nameIndex], aRegistry.name(static_cast<testRegistry::handle>(handles[0][nameIndex])));
+    }
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_logRegistry_concurrent);
+    UNITY_END();
+}
@@ -0,0 +1,364 @@
+// Host side decoder for the binary output of uLog, see src/logbinary.h
+// Reads a captured stream of frames and writes the items as uLog would have output them as text.
+//
+// Build : make -C tools/ulog-decode, see README.md
+// Usage : ulog-decode [options] [capture file, default stdin]
+//   --formats <file>            C / C++ source, or any text file, to take the format strings of deferred items from. Every string literal in it is hashed. Can be repeated
+//   --no-color                  no color escape codes, as for an output with setColoredOutput(false)
+//   --no-timestamp              no timestamps, as for an output with setIncludeTimestamp(false)
+//   --ticks-per-second <n>      resolution of the tick source, as passed to setTickSource(). Default 1000
+//   --write-table <file>        writes the mapping table of the format IDs to the format strings found with --formats, one 0xID "format" per line, and exits.
+//                               This table can be read back with --formats, eg. when the sources are not at hand, or used by a sink having to decode the IDs itself
+//
+// The items uLog logs itself, eg. "last message repeated n times", have their formats in src/logging.h, so pass it with --formats as well
+//
+// Example : ulog-decode --formats src/main.cpp --formats lib/sensor/sensor.cpp --formats src/logging.h /dev/ttyUSB0
+//           ulog-decode --formats src/main.cpp --formats src/logging.h --write-table formats.txt
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <map>
+#include <string>
+#include <vector>
+#include "logbinary.h"
+#include "logargs.h"
+#include "logfields.h"
+#include "logtimestamp.h"
+#include "logginglevels.h"
+
+namespace {
+
+std::map<uint32_t, std::string> formats;        // format strings, by their ID
+uint32_t nmbrCollisions{0};                     // different format strings having the same ID
+
+bool coloredOutput{true};
+bool includeTimestamp{true};
+logTimestamp timestamps;
+
+// ------------------------------
+// finding the format strings
+// ------------------------------
+
+uint32_t unescape(const std::string& source, uint32_t index, std::string& destination) {        // appends the char of the escape sequence at index, just after the backslash. Returns the index after it
+    char escaped = source[index++];
+    switch (escaped) {
+        case 'n':
+            destination += '\n';
+            break;
+        case 't':
+            destination += '\t';
+            break;
+        case 'r':
+            destination += '\r';
+            break;
+        case 'a':
+            destination += '\a';
+            break;
+        case 'b':
+            destination += '\b';
+            break;
+        case 'f':
+            destination += '\f';
+            break;
+        case 'v':
+            destination += '\v';
+            break;
+        case 'e':
+            destination += '\x1B';
+            break;
+        case 'x': {
+            uint32_t value{0};
+            while ((index < source.size()) && isxdigit(static_cast<unsigned char>(source[index]))) {
+                value = (value * 16U) + static_cast<uint32_t>(isdigit(static_cast<unsigned char>(source[index])) ? (source[index] - '0') : ((tolower(source[index]) - 'a') + 10));
+                index++;
+            }
+            destination += static_cast<char>(value);
+        } break;
+        default:
+            if ((escaped >= '0') && (escaped <= '7')) {
+                uint32_t value = static_cast<uint32_t>(escaped - '0');
+                for (uint32_t digits = 1; (digits < 3) && (index < source.size()) && (source[index] >= '0') && (source[index] <= '7'); digits++) {
+                    value = (value * 8U) + static_cast<uint32_t>(source[index++] - '0');
+                }
+                destination += static_cast<char>(value);
+            } else {
+                destination += escaped;        // \\, \", \' and \?
+            }
+            break;
+    }
+    return index;
+}
+
+void addFormat(const std::string& format) {
+    uint32_t id = logBinary::formatId(format.c_str());
+    std::map<uint32_t, std::string>::const_iterator existing = formats.find(id);
+    if ((existing != formats.end()) && (existing->second != format)) {
+        fprintf(stderr, "ulog-decode : \"%s\" and \"%s\" have the same ID 0x%08X\n", existing->second.c_str(), format.c_str(), id);        // very unlikely, but then one of them needs rewording
+        nmbrCollisions++;
+    }
+    formats[id] = format;
+}
+
+std::string escape(const std::string& text) {        // as a C string literal
+    std::string result{"\""};
+    for (uint32_t index = 0; index < text.size(); index++) {
+        unsigned char theChar = static_cast<unsigned char>(text[index]);
+        switch (theChar) {
+            case '\n':
+                result += "\\n";
+                break;
+            case '\t':
+                result += "\\t";
+                break;
+            case '\r':
+                result += "\\r";
+                break;
+            case '"':
+            case '\\':
+                result += '\\';
+                result += static_cast<char>(theChar);
+                break;
+            default:
+                if ((theChar < 0x20U) || (theChar >= 0x7FU)) {
+                    char octal[8];
+                    snprintf(octal, sizeof(octal), "\\%03o", theChar);        // octal, as a hex escape would also take the hex digits following it
+                    result += octal;
+                } else {
+                    result += static_cast<char>(theChar);
+                }
+                break;
+        }
+    }
+    result += '"';
+    return result;
+}
+
+bool writeTable(const char* path) {
+    FILE* file = fopen(path, "wb");
+    if (file == nullptr) {
+        return false;
+    }
+    for (std::map<uint32_t, std::string>::const_iterator entry = formats.begin(); entry != formats.end(); ++entry) {
+        fprintf(file, "0x%08X %s\n", entry->first, escape(entry->second).c_str());
+    }
+    return (fclose(file) == 0);
+}
+
+void addFormats(const std::string& source) {        // adds all string literals, adjacent literals concatenated as the compiler does
+    std::string literal;
+    bool inLiteral{false};        // a literal was found, and only whitespace and comments followed it so far
+    uint32_t index{0};
+    while (index < source.size()) {
+        char theChar = source[index];
+        if ((theChar == '/') && ((index + 1U) < source.size()) && (source[index + 1U] == '/')) {
+            size_t end = source.find('\n', index);
+            index      = (end == std::string::npos) ? source.size() : end;
+        } else if ((theChar == '/') && ((index + 1U) < source.size()) && (source[index + 1U] == '*')) {
+            size_t end = source.find("*/", index + 2U);
+            index      = (end == std::string::npos) ? source.size() : (end + 2U);
+        } else if (theChar == '\'') {        // char literal, so a '"' is not taken as the start of a string
+            index++;
+            while ((index < source.size()) && (source[index] != '\'')) {
+                index += (source[index] == '\\') ? 2U : 1U;
+            }
+            index++;
+        } else if (theChar == '"') {
+            inLiteral = true;
+            index++;
+            while ((index < source.size()) && (source[index] != '"')) {
+                if (source[index] == '\\') {
+                    index = unescape(source, index + 1U, literal);
+                } else {
+                    literal += source[index++];
+                }
+            }
+            index++;
+        } else if (isspace(static_cast<unsigned char>(theChar))) {
+            index++;
+        } else {
+            if (inLiteral) {
+                addFormat(literal);
+                literal.clear();
+                inLiteral = false;
+            }
+            index++;
+        }
+    }
+    if (inLiteral) {
+        addFormat(literal);
+    }
+}
+
+bool readFile(FILE* file, std::string& contents) {
+    char buffer[4096];
+    size_t length;
+    while ((length = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        contents.append(buffer, length);
+    }
+    return (ferror(file) == 0);
+}
+
+// ------------------------------
+// decoding the frames
+// ------------------------------
+
+bool decodeFrame(const uint8_t* frame, uint32_t frameLength, std::string& line) {        // formats the item in frame as uLog::format() does, returns false when the frame is invalid
+    if (frameLength < 2U) {
+        return false;
+    }
+    logBinary::recordType theRecordType       = static_cast<logBinary::recordType>(frame[0] & 0x03U);
+    logBinary::timestampType theTimestampType = static_cast<logBinary::timestampType>((frame[0] >> 2) & 0x03U);
+    uint32_t index{1};
+    char timestamp[logTimestamp::maxLength + 256U];
+    uint32_t timestampLength{0};
+    uint64_t value;
+    if (theTimestampType == logBinary::timestampType::tick) {
+        uint32_t used = logBinary::getVarint(frame + index, frameLength - index, value);
+        if (used == 0) {
+            return false;
+        }
+        index += used;
+        timestampLength = timestamps.format(value, timestamp);
+    } else if (theTimestampType == logBinary::timestampType::text) {
+        uint32_t used = logBinary::getVarint(frame + index, frameLength - index, value);
+        if ((used == 0) || (value > 255U) || ((index + used + value) > frameLength)) {
+            return false;
+        }
+        index += used;
+        memcpy(timestamp, frame + index, value);
+        timestampLength = static_cast<uint32_t>(value);
+        index += timestampLength;
+    }
+    if (index >= frameLength) {
+        return false;
+    }
+    loggingLevel theLoggingLevel = static_cast<loggingLevel>(frame[index] & 0x07U);
+    uint32_t subSystemIndex      = frame[index++] >> 3;
+    if (subSystemIndex == logBinary::subSystemEscape) {        // not shown in the text format, but it needs to be skipped
+        uint32_t used = logBinary::getVarint(frame + index, frameLength - index, value);
+        if (used == 0) {
+            return false;
+        }
+        index += used;
+    }
+
+    std::string contents;
+    if (theRecordType == logBinary::recordType::deferred) {
+        uint32_t used = logBinary::getVarint(frame + index, frameLength - index, value);
+        if (used == 0) {
+            return false;
+        }
+        index += used;
+        std::map<uint32_t, std::string>::const_iterator theFormat = formats.find(static_cast<uint32_t>(value));
+        if (theFormat == formats.end()) {
+            char unknown[48];
+            snprintf(unknown, sizeof(unknown), "(unknown format 0x%08X)", static_cast<uint32_t>(value));        // pass the source holding it with --formats, src/logging.h for the items of uLog itself
+            contents = unknown;
+        } else {
+            std::vector<char> rendered(4096);
+            uint32_t renderedLength = logArgs::render(rendered.data(), static_cast<uint32_t>(rendered.size()), theFormat->second.c_str(), reinterpret_cast<const char*>(frame + index), frameLength - index);
+            contents.assign(rendered.data(), renderedLength);
+        }
+    } else if (theRecordType == logBinary::recordType::text) {
+        contents.assign(reinterpret_cast<const char*>(frame + index), frameLength - index);
+    } else if (theRecordType == logBinary::recordType::structured) {
+        const char* fields = reinterpret_cast<const char*>(frame + index);
+        const char* message;
+        uint32_t messageLength;
+        uint32_t fieldsStart = logLineWriter::message(fields, frameLength - index, message, messageLength);
+        std::vector<char> rendered(4096);
+        logLineWriter aLine(rendered.data(), 0, static_cast<uint32_t>(rendered.size()) - 3U, logEncoding::text);        // room for end()
+        aLine.addText(message, messageLength);
+        aLine.addFields(fields + fieldsStart, frameLength - (index + fieldsStart));
+        contents.assign(rendered.data(), aLine.length());
+    } else {
+        return false;
+    }
+
+    line.clear();
+    if (coloredOutput) {
+        line += colorPrefix(theLoggingLevel);
+    }
+    if (includeTimestamp) {
+        line.append(timestamp, timestampLength);
+        line += ' ';
+    }
+    line += toStringShort(theLoggingLevel);
+    line += contents;
+    if (coloredOutput) {
+        line += colorPostfix();
+    }
+    line += '\n';
+    return true;
+}
+
+}        // namespace
+
+int main(int argc, char** argv) {
+    const char* capturePath{nullptr};
+    const char* tablePath{nullptr};
+    for (int argIndex = 1; argIndex < argc; argIndex++) {
+        std::string option = argv[argIndex];
+        if ((option == "--formats") && ((argIndex + 1) < argc)) {
+            FILE* file = fopen(argv[++argIndex], "rb");
+            std::string source;
+            if ((file == nullptr) || !readFile(file, source)) {
+                fprintf(stderr, "ulog-decode : can't read %s\n", argv[argIndex]);
+                return 1;
+            }
+            fclose(file);
+            addFormats(source);
+        } else if (option == "--no-color") {
+            coloredOutput = false;
+        } else if (option == "--no-timestamp") {
+            includeTimestamp = false;
+        } else if ((option == "--ticks-per-second") && ((argIndex + 1) < argc)) {
+            timestamps.setTicksPerSecond(static_cast<uint32_t>(strtoul(argv[++argIndex], nullptr, 10)));
+        } else if ((option == "--write-table") && ((argIndex + 1) < argc)) {
+            tablePath = argv[++argIndex];
+        } else if ((option[0] != '-') && (capturePath == nullptr)) {
+            capturePath = argv[argIndex];
+        } else {
+            fprintf(stderr, "usage : ulog-decode [--formats <file>]... [--no-color] [--no-timestamp] [--ticks-per-second <n>] [--write-table <file>] [capture file]\n");
+            return 1;
+        }
+    }
+    if (tablePath != nullptr) {
+        if (!writeTable(tablePath)) {
+            fprintf(stderr, "ulog-decode : can't write %s\n", tablePath);
+            return 1;
+        }
+        return (nmbrCollisions > 0) ? 1 : 0;
+    }
+
+    FILE* capture = (capturePath != nullptr) ? fopen(capturePath, "rb") : stdin;
+    if (capture == nullptr) {
+        fprintf(stderr, "ulog-decode : can't open %s\n", capturePath);
+        return 1;
+    }
+    std::vector<uint8_t> encoded;        // bytes of the current frame, up to its delimiter
+    std::vector<uint8_t> frame;
+    std::string line;
+    uint32_t invalidFrames{0};
+    int theByte;
+    while ((theByte = fgetc(capture)) != EOF) {        // byte per byte, so it also works on a serial port or pipe
+        if (theByte != 0) {
+            encoded.push_back(static_cast<uint8_t>(theByte));
+            continue;
+        }
+        frame.resize(encoded.size());
+        uint32_t frameLength = encoded.empty() ? 0U : logBinary::decode(encoded.data(), static_cast<uint32_t>(encoded.size()), frame.data());
+        if (decodeFrame(frame.data(), frameLength, line)) {
+            fwrite(line.data(), 1, line.size(), stdout);
+            fflush(stdout);
+        } else if (!encoded.empty()) {
+            invalidFrames++;        // eg. the first frame, when the capture started in the middle of it
+        }
+        encoded.clear();
+    }
+    if (invalidFrames > 0) {
+        fprintf(stderr, "ulog-decode : %u invalid frames skipped\n", invalidFrames);
+    }
+    return 0;
+}